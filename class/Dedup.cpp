@@ -0,0 +1,233 @@
+/**
+ * Dedup.cpp - find the files with the same contents, reading as little of
+ *             them as possible
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 01:05:52
+ */
+
+#include "Dedup.hpp"
+#include "File.hpp"
+#include "File_reader.hpp"
+#include "Hash.hpp"
+#include "Thread_pool.hpp"
+
+#if defined(__unix__)
+#include "Directory_walker.hpp"
+#endif
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+using std::string;
+
+/* the number of prefixes a task reads, the whole files go one per task */
+static const std::size_t prefix_chunk = 16;
+
+Dedup::Dedup(): opt_(Options{})
+{
+}
+
+Dedup::Dedup(const Options &opt): opt_(opt)
+{
+}
+
+void Dedup::add(const std::vector<string> &pathnames)
+{
+        std::vector<File::Status> st;
+        File::status(pathnames, st, opt_.threads);
+        for (std::size_t i = 0; i < pathnames.size(); ++i)
+                if (st[i].is_file())
+                        add(pathnames[i], st[i].size, st[i].dev, st[i].ino);
+}
+
+#if defined(__unix__)
+bool Dedup::add_tree(const string &root)
+{
+        Directory_walker::Options wopt;
+        wopt.threads = opt_.threads;
+        Directory_walker walker(wopt);
+        walker.set_filter([](const Directory_walker::Entry &e) {
+                return e.type == Directory_reader::file;
+        });
+        std::mutex mtx;
+        return walker.walk(root, [&](const Directory_walker::Entry &e) {
+                File::Status st = File::status_at(e.dirfd, string{e.name},
+                                false);
+                if (!st.is_file())
+                        return;
+                std::lock_guard<std::mutex> lk(mtx);
+                add(string{e.path}, st.size, st.dev, st.ino);
+        });
+}
+#endif
+
+void Dedup::add(const string &pathname, long long size,
+                unsigned long long dev, unsigned long long ino)
+{
+        ++stats_.files;
+        /* no inode numbers, e.g. on Windows, means no hard links known */
+        if (ino != 0) {
+                auto it = links_.find({dev, ino});
+                if (it != links_.end()) {
+                        inodes_[it->second].paths.push_back(pathname);
+                        return;
+                }
+                links_.emplace(std::make_pair(dev, ino), inodes_.size());
+        }
+        inodes_.push_back(Inode{size, dev, ino, Links{pathname}, 0, false});
+}
+
+/**
+ * @brief Sort the candidates by @key and keep the ones whose key is shared
+ *
+ * @param cand The candidates
+ * @param key The key of a candidate
+ */
+template <typename Key>
+static void keep_shared(std::vector<std::size_t> &cand, Key key)
+{
+        std::sort(cand.begin(), cand.end(), [&key](std::size_t a,
+                                std::size_t b) {
+                return key(a) < key(b);
+        });
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < cand.size(); ) {
+                std::size_t j = i + 1;
+                while (j < cand.size() && key(cand[j]) == key(cand[i]))
+                        ++j;
+                if (j - i > 1)
+                        for (std::size_t k = i; k < j; ++k)
+                                cand[n++] = cand[k];
+                i = j;
+        }
+        cand.resize(n);
+}
+
+std::vector<Dedup::Group> Dedup::run()
+{
+        stats_.inodes = inodes_.size();
+        stats_.fully_read = 0;
+        stats_.bytes_read = 0;
+        auto size_key = [this](std::size_t i) {
+                return inodes_[i].size;
+        };
+        auto hash_key = [this](std::size_t i) {
+                return std::make_pair(inodes_[i].size, inodes_[i].hash);
+        };
+
+        std::vector<std::size_t> cand;
+        for (std::size_t i = 0; i < inodes_.size(); ++i) {
+                inodes_[i].failed = false;
+                if (inodes_[i].size >= opt_.min_size)
+                        cand.push_back(i);
+        }
+        keep_shared(cand, size_key);
+        stats_.same_size = cand.size();
+
+        Thread_pool pool(opt_.threads);
+        narrow(pool, cand, false);
+        stats_.same_prefix = cand.size();
+
+        /* the prefix of a small file is the whole of it */
+        std::vector<std::size_t> done, large;
+        for (auto i : cand)
+                (inodes_[i].size > static_cast<long long>(prefix_size) ?
+                 large : done).push_back(i);
+        stats_.fully_read = large.size();
+        narrow(pool, large, true);
+        done.insert(done.end(), large.begin(), large.end());
+        keep_shared(done, hash_key);
+
+        std::vector<Group> groups;
+        for (std::size_t i = 0; i < done.size(); ) {
+                auto key = hash_key(done[i]);
+                Group g{key.first, key.second, {}};
+                for (; i < done.size() && hash_key(done[i]) == key; ++i) {
+                        Links links = inodes_[done[i]].paths;
+                        std::sort(links.begin(), links.end());
+                        g.files.push_back(std::move(links));
+                }
+                std::sort(g.files.begin(), g.files.end());
+                groups.push_back(std::move(g));
+        }
+        std::sort(groups.begin(), groups.end(), [](const Group &a,
+                                const Group &b) {
+                if (a.size != b.size)
+                        return a.size > b.size;
+                return a.files < b.files;
+        });
+        return groups;
+}
+
+void Dedup::narrow(Thread_pool &pool, std::vector<std::size_t> &cand,
+                bool full)
+{
+        std::atomic<unsigned long long> bytes{0};
+        std::size_t chunk = full ? 1 : prefix_chunk;
+        for (std::size_t i = 0; i < cand.size(); i += chunk) {
+                std::size_t end = std::min(i + chunk, cand.size());
+                pool.submit([this, &cand, &bytes, full, i, end] {
+                        for (std::size_t j = i; j < end; ++j) {
+                                Inode &n = inodes_[cand[j]];
+                                std::size_t read = 0;
+                                n.failed = !(full ?
+                                        hash_full(n.paths.front(), n.hash,
+                                                read) :
+                                        hash_prefix(n.paths.front(), n.hash,
+                                                read));
+                                bytes += read;
+                        }
+                });
+        }
+        pool.wait();
+        stats_.bytes_read += bytes;
+
+        /* the unreadable ones are dropped */
+        cand.erase(std::remove_if(cand.begin(), cand.end(),
+                                [this](std::size_t i) {
+                                        return inodes_[i].failed;
+                                }), cand.end());
+        keep_shared(cand, [this](std::size_t i) {
+                return std::make_pair(inodes_[i].size, inodes_[i].hash);
+        });
+}
+
+bool Dedup::hash_prefix(const string &pathname, uint64_t &hash,
+                std::size_t &bytes)
+{
+        File_reader reader(pathname);
+        if (!reader.ready())
+                return false;
+        char buf[prefix_size];
+        bytes = reader.read(buf, sizeof(buf));
+        hash = Xxh64::hash(buf, bytes);
+        return true;
+}
+
+bool Dedup::hash_full(const string &pathname, uint64_t &hash,
+                std::size_t &bytes)
+{
+        File_reader reader(pathname);
+        if (!reader.ready())
+                return false;
+        const char *p = reader.map(bytes);
+        if (p) {
+                hash = Xxh64::hash(p, bytes);
+                return true;
+        }
+        /* an empty file, or one that cannot be mapped */
+        Xxh64 h;
+        char buf[64 * 1024];
+        std::size_t n;
+        bytes = 0;
+        while ((n = reader.read(buf, sizeof(buf))) > 0) {
+                h.update(buf, n);
+                bytes += n;
+        }
+        hash = h.digest();
+        return true;
+}
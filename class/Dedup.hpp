@@ -0,0 +1,181 @@
+/**
+ * Dedup.hpp - find the files with the same contents, reading as little of
+ *             them as possible
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 01:05:52
+ */
+
+#ifndef DEDUP_HPP_
+#define DEDUP_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+class Thread_pool;
+
+/*
+ * The files are narrowed down in rounds, each dropping the files left alone
+ * in their group:
+ *      1. by size, from the metadata only
+ *      2. by the hash of the first prefix_size bytes
+ *      3. by the hash of the whole contents, read by mmap
+ * The hard links of a file are found from the metadata and never read.
+ */
+class Dedup {
+public:
+        static const std::size_t prefix_size = 4096;
+
+        struct Options {
+                unsigned int threads{0};        // 0 means one per core
+                long long min_size{1};          // smaller files are skipped
+        };
+
+        /* the hard links of one file */
+        using Links = std::vector<std::string>;
+
+        /* the files with the same contents */
+        struct Group {
+                long long size;
+                uint64_t hash;
+                std::vector<Links> files;       // at least two
+        };
+
+        struct Stats {
+                std::size_t files{0};           // regular files added
+                std::size_t inodes{0};          // distinct files among them
+                std::size_t same_size{0};       // left after round 1
+                std::size_t same_prefix{0};     // left after round 2
+                std::size_t fully_read{0};      // files read in round 3
+                unsigned long long bytes_read{0};
+        };
+
+private:
+        struct Inode {
+                long long size;
+                unsigned long long dev;
+                unsigned long long ino;
+                Links paths;
+                uint64_t hash;
+                bool failed;            // could not be read
+        };
+
+        Options opt_;
+        std::vector<Inode> inodes_;
+        /* the index into @inodes_ by the device and inode numbers */
+        std::map<std::pair<unsigned long long, unsigned long long>,
+                std::size_t> links_;
+        Stats stats_;
+
+public:
+        Dedup(const Dedup &) = delete;
+        Dedup &operator=(const Dedup &) = delete;
+        ~Dedup() = default;
+
+        /**
+         * @brief Create a Dedup object with the default options
+         */
+        Dedup();
+
+        /**
+         * @brief Create a Dedup object with the given options
+         *
+         * @param opt The options
+         */
+        explicit Dedup(const Options &opt);
+
+        /**
+         * @brief Add files to compare, the ones not regular files are
+         *        skipped
+         *
+         * @param pathnames The pathnames
+         */
+        void add(const std::vector<std::string> &pathnames);
+
+#if defined(__unix__)
+        /**
+         * @brief Add the regular files under a directory, walked in
+         *        parallel, symbolic links are not followed
+         *
+         * @param root The directory
+         *
+         * @return True if succeeded and false if @root could not be read
+         */
+        bool add_tree(const std::string &root);
+#endif
+
+        /**
+         * @brief Find the groups of files with the same contents among the
+         *        files added
+         *
+         * @return The groups, the largest files first, the paths in each
+         *         group sorted
+         */
+        std::vector<Group> run();
+
+        /**
+         * @brief Get how many files each round left, for the last run()
+         *
+         * @return The Stats
+         */
+        const Stats &stats() const;
+
+private:
+        /**
+         * @brief Add a file, merging it into the known one if it's a hard
+         *        link of it
+         *
+         * @param pathname The pathname
+         * @param size The size of the file
+         * @param dev The device number of the file
+         * @param ino The inode number of the file
+         */
+        void add(const std::string &pathname, long long size,
+                        unsigned long long dev, unsigned long long ino);
+
+        /**
+         * @brief Hash the files in parallel and keep the ones sharing their
+         *        size and hash with another
+         *
+         * @param pool The pool to hash on
+         * @param cand The indexes into @inodes_, replaced by the ones kept
+         * @param full Whether to hash the whole contents or only the prefix
+         */
+        void narrow(Thread_pool &pool, std::vector<std::size_t> &cand,
+                        bool full);
+
+        /**
+         * @brief Hash the first prefix_size bytes of a file
+         *
+         * @param pathname The pathname
+         * @param hash Set to the hash
+         * @param bytes Set to the number of bytes read
+         *
+         * @return True if succeeded and false if the file could not be read
+         */
+        static bool hash_prefix(const std::string &pathname, uint64_t &hash,
+                        std::size_t &bytes);
+
+        /**
+         * @brief Hash the whole contents of a file
+         *
+         * @param pathname The pathname
+         * @param hash Set to the hash
+         * @param bytes Set to the number of bytes read
+         *
+         * @return True if succeeded and false if the file could not be read
+         */
+        static bool hash_full(const std::string &pathname, uint64_t &hash,
+                        std::size_t &bytes);
+};
+
+inline const Dedup::Stats &Dedup::stats() const
+{
+        return stats_;
+}
+
+#endif
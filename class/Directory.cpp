@@ -0,0 +1,129 @@
+/**
+ * Directory.cpp - a handle to an open directory, the files in it are reached
+ *                 relative to it without walking the full path again
+ *                 (Unix only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 20:51:17
+ */
+
+#if defined(__unix__)
+
+#include "Directory.hpp"
+#include "File.hpp"
+
+#include <string>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if !defined(O_PATH)
+#define O_PATH O_RDONLY
+#endif
+
+using std::string;
+
+Directory::Directory(const string &pathname)
+{
+        open(pathname);
+}
+
+Directory::Directory(const Directory &parent, const string &name)
+{
+        open(parent, name);
+}
+
+Directory::~Directory()
+{
+        close();
+}
+
+bool Directory::open(const string &pathname)
+{
+        close();
+        fd_ = ::open(pathname.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        return ready();
+}
+
+bool Directory::open(const Directory &parent, const string &name)
+{
+        close();
+        fd_ = openat(parent.fd_, name.c_str(),
+                        O_PATH | O_DIRECTORY | O_CLOEXEC);
+        return ready();
+}
+
+bool Directory::close()
+{
+        bool state = false;
+        if (!ready())
+                return state;
+        state = ::close(fd_) == 0;
+        fd_ = -1;
+        return state;
+}
+
+bool Directory::exists_at(const string &name) const
+{
+        return faccessat(fd_, name.c_str(), F_OK, 0) == 0;
+}
+
+File::Status Directory::stat_at(const string &name, bool follow) const
+{
+        return File::status_at(fd_, name, follow);
+}
+
+bool Directory::can_read_at(const string &name) const
+{
+        return faccessat(fd_, name.c_str(), R_OK, 0) == 0;
+}
+
+bool Directory::can_write_at(const string &name) const
+{
+        return faccessat(fd_, name.c_str(), W_OK, 0) == 0;
+}
+
+bool Directory::can_execute_at(const string &name) const
+{
+        return faccessat(fd_, name.c_str(), X_OK, 0) == 0;
+}
+
+int Directory::open_at(const string &name, int flags, mode_t mode) const
+{
+        return openat(fd_, name.c_str(), flags | O_CLOEXEC, mode);
+}
+
+bool Directory::unlink_at(const string &name) const
+{
+        bool state = unlinkat(fd_, name.c_str(), 0) == 0;
+        /* like remove(), fall back to the directory removal */
+        if (!state && (errno == EISDIR || errno == EPERM))
+                state = unlinkat(fd_, name.c_str(), AT_REMOVEDIR) == 0;
+        File::invalidate_path_cache();
+        return state;
+}
+
+bool Directory::mkdir_at(const string &name, mode_t mode) const
+{
+        return mkdirat(fd_, name.c_str(), mode) == 0;
+}
+
+bool Directory::rename_at(const string &src, const string &dest) const
+{
+        bool state = renameat(fd_, src.c_str(), fd_, dest.c_str()) == 0;
+        File::invalidate_path_cache();
+        return state;
+}
+
+bool Directory::rename_at(const string &src, const Directory &dest_dir,
+                const string &dest) const
+{
+        bool state = renameat(fd_, src.c_str(), dest_dir.fd_,
+                        dest.c_str()) == 0;
+        File::invalidate_path_cache();
+        return state;
+}
+
+#endif
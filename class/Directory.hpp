@@ -0,0 +1,213 @@
+/**
+ * Directory.hpp - a handle to an open directory, the files in it are reached
+ *                 relative to it without walking the full path again
+ *                 (Unix only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 19:44:37
+ */
+
+#ifndef DIRECTORY_HPP_
+#define DIRECTORY_HPP_
+
+#if defined(__unix__)
+
+#include "File.hpp"
+
+#include <string>
+#include <sys/types.h>
+
+class Directory {
+private:
+        int fd_{-1};    // an O_PATH descriptor, only good for the *at calls
+
+public:
+        Directory() = default;
+        Directory(const Directory &) = delete;
+        Directory &operator=(const Directory &) = delete;
+        ~Directory();
+
+        /**
+         * @brief Create a Directory object, given the pathname of the
+         *        directory
+         *
+         * @param pathname The pathname of the directory
+         */
+        explicit Directory(const std::string &pathname);
+
+        /**
+         * @brief Create a Directory object for the subdirectory @name of
+         *        @parent
+         *
+         * @param parent The parent directory
+         * @param name The pathname relative to @parent
+         */
+        Directory(const Directory &parent, const std::string &name);
+
+        /**
+         * @brief Tell if the handle is open
+         *
+         * @return True if the directory opened successfully, false otherwise
+         */
+        bool ready() const;
+
+        /**
+         * @brief Open the given directory
+         *
+         * @param pathname The pathname of the directory
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa close()
+         */
+        bool open(const std::string &pathname);
+
+        /**
+         * @brief Open the subdirectory @name of @parent
+         *
+         * @param parent The parent directory
+         * @param name The pathname relative to @parent
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa close()
+         */
+        bool open(const Directory &parent, const std::string &name);
+
+        /**
+         * @brief Close the handle
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa open()
+         */
+        bool close();
+
+        /**
+         * @brief Get the file descriptor for other *at calls
+         *
+         * @return The file descriptor, -1 if not open
+         */
+        int fd() const;
+
+        /**
+         * @brief Check whether the file @name exists in this directory
+         *
+         * @param name The pathname relative to this directory
+         *
+         * @return True when the file exists, false when not
+         */
+        bool exists_at(const std::string &name) const;
+
+        /**
+         * @brief Get the metadata of the file @name in this directory
+         *
+         * @param name The pathname relative to this directory
+         * @param follow Whether to follow @name if it's a symbolic link
+         *
+         * @return The metadata, with exists set to false if the query failed
+         */
+        File::Status stat_at(const std::string &name,
+                        bool follow = true) const;
+
+        /**
+         * @brief Check if the file @name in this directory is readable
+         *
+         * @param name The pathname relative to this directory
+         *
+         * @return True when file is readable, false when not
+         */
+        bool can_read_at(const std::string &name) const;
+
+        /**
+         * @brief Check if the file @name in this directory is writable
+         *
+         * @param name The pathname relative to this directory
+         *
+         * @return True when file is writable, false when not
+         */
+        bool can_write_at(const std::string &name) const;
+
+        /**
+         * @brief Check if the file @name in this directory is executable
+         *
+         * @param name The pathname relative to this directory
+         *
+         * @return True when file is executable, false when not
+         */
+        bool can_execute_at(const std::string &name) const;
+
+        /**
+         * @brief Open the file @name in this directory
+         *
+         * @param name The pathname relative to this directory
+         * @param flags The open() flags, O_CLOEXEC is always added
+         * @param mode The permission of a created file, default: 0644
+         *
+         * @return The file descriptor when succeeded, -1 otherwise, the
+         *         caller closes it
+         */
+        int open_at(const std::string &name, int flags,
+                        mode_t mode = 0644) const;
+
+        /**
+         * @brief Remove the file or the empty directory @name in this
+         *        directory
+         *
+         * @param name The pathname relative to this directory
+         *
+         * @return True if and only if the file or directory is successfully
+         *         removed, false otherwise
+         */
+        bool unlink_at(const std::string &name) const;
+
+        /**
+         * @brief Create the directory @name in this directory
+         *
+         * @param name The pathname relative to this directory
+         * @param mode The permission, default: 0755
+         *
+         * @return True when directory was created, false otherwise
+         */
+        bool mkdir_at(const std::string &name, mode_t mode = 0755) const;
+
+        /**
+         * @brief Move the file or directory @src in this directory to @dest
+         *        in the same directory
+         *
+         * @param src The source pathname relative to this directory
+         * @param dest The destination pathname relative to this directory
+         *
+         * @return True when move file or directory successfully,
+         *         false otherwise
+         */
+        bool rename_at(const std::string &src, const std::string &dest) const;
+
+        /**
+         * @brief Move the file or directory @src in this directory to @dest
+         *        in the directory @dest_dir
+         *
+         * @param src The source pathname relative to this directory
+         * @param dest_dir The destination directory
+         * @param dest The destination pathname relative to @dest_dir
+         *
+         * @return True when move file or directory successfully,
+         *         false otherwise
+         */
+        bool rename_at(const std::string &src, const Directory &dest_dir,
+                        const std::string &dest) const;
+};
+
+inline bool Directory::ready() const
+{
+        return fd_ != -1;
+}
+
+inline int Directory::fd() const
+{
+        return fd_;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * Directory_reader.cpp - stream the entries of a directory without
+ *                        collecting them first
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 15:12:30
+ */
+
+#include "Directory_reader.hpp"
+#include "File.hpp"
+
+#include <string>
+#include <cstddef>
+
+#if defined(__linux__)
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+
+/* the record layout returned by getdents64(), glibc only wraps it since
+ * 2.30 so it's called through syscall() */
+struct linux_dirent64 {
+        unsigned long long d_ino;
+        long long d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[];
+};
+
+#elif defined(__unix__)
+
+#include <unistd.h>
+#include <dirent.h>
+
+#elif defined(_MSC_VER)
+
+#include <windows.h>
+
+#endif
+
+using std::string;
+
+const std::size_t Directory_reader::default_buffer_size = 128 * 1024;
+
+#if defined(__unix__)
+/**
+ * @brief Map a d_type value to Directory_reader::Type
+ */
+static Directory_reader::Type to_type(unsigned char d_type)
+{
+        switch (d_type) {
+        case DT_REG:
+                return Directory_reader::file;
+        case DT_DIR:
+                return Directory_reader::directory;
+        case DT_LNK:
+                return Directory_reader::symlink;
+        case DT_UNKNOWN:
+                return Directory_reader::unknown;
+        default:
+                return Directory_reader::other;
+        }
+}
+#endif
+
+Directory_reader::Directory_reader(const string &pathname, bool skip_dots,
+                std::size_t buf_size): skip_dots_(skip_dots)
+{
+#if defined(__linux__)
+        buf_size_ = buf_size;
+#endif
+        open(pathname);
+}
+
+Directory_reader::Directory_reader(const File &file, bool skip_dots):
+        Directory_reader(file.get_path(), skip_dots)
+{
+}
+
+Directory_reader::~Directory_reader()
+{
+        close();
+#if defined(__linux__)
+        delete [] buf_;
+#endif
+}
+
+bool Directory_reader::open(const string &pathname)
+{
+        close();
+#if defined(__linux__)
+        fd_ = ::open(pathname.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        own_fd_ = true;
+        if (fd_ != -1 && !buf_) {
+                if (buf_size_ == 0)
+                        buf_size_ = default_buffer_size;
+                buf_ = new char[buf_size_];
+        }
+#elif defined(__unix__)
+        dp_ = opendir(pathname.c_str());
+#elif defined(_MSC_VER)
+        h_find_ = FindFirstFile((pathname + File::separator + "*").c_str(),
+                        &ffd_);
+        first_ = (h_find_ != INVALID_HANDLE_VALUE);
+#endif
+        return ready();
+}
+
+#if defined(__unix__)
+
+bool Directory_reader::open(int fd)
+{
+        close();
+#if defined(__linux__)
+        fd_ = fd;
+        own_fd_ = false;
+        if (!buf_) {
+                if (buf_size_ == 0)
+                        buf_size_ = default_buffer_size;
+                buf_ = new char[buf_size_];
+        }
+#else
+        /* closedir() closes the descriptor under it, so read from a copy,
+         * which shares the position with the original one */
+        int copy = dup(fd);
+        if (copy != -1 && !(dp_ = fdopendir(copy)))
+                ::close(copy);
+#endif
+        return ready();
+}
+
+#endif
+
+bool Directory_reader::close()
+{
+        bool state = false;
+        if (!ready())
+                return state;
+#if defined(__linux__)
+        state = own_fd_ ? ::close(fd_) == 0 : true;
+        fd_ = -1;
+        pos_ = end_ = 0;
+#elif defined(__unix__)
+        state = closedir(dp_) == 0;
+        dp_ = nullptr;
+#elif defined(_MSC_VER)
+        state = FindClose(h_find_) != 0;
+        h_find_ = INVALID_HANDLE_VALUE;
+#endif
+        return state;
+}
+
+bool Directory_reader::next(Entry &e)
+{
+        if (!ready())
+                return false;
+#if defined(__linux__)
+        for (;;) {
+                if (pos_ >= end_) {
+                        long n = syscall(SYS_getdents64, fd_, buf_, buf_size_);
+                        if (n <= 0)
+                                return false;
+                        pos_ = 0;
+                        end_ = static_cast<std::size_t>(n);
+                }
+                auto d = reinterpret_cast<linux_dirent64 *>(buf_ + pos_);
+                pos_ += d->d_reclen;
+                if (skip_dots_ && is_dots(d->d_name))
+                        continue;
+                e.name = d->d_name;
+                e.ino = d->d_ino;
+                e.type = to_type(d->d_type);
+                return true;
+        }
+#elif defined(__unix__)
+        struct dirent *p;
+        while ((p = readdir(dp_))) {
+                if (skip_dots_ && is_dots(p->d_name))
+                        continue;
+                e.name = p->d_name;
+                e.ino = p->d_ino;
+                e.type = to_type(p->d_type);
+                return true;
+        }
+        return false;
+#elif defined(_MSC_VER)
+        for (;;) {
+                if (!first_ && !FindNextFile(h_find_, &ffd_))
+                        return false;
+                first_ = false;
+                if (skip_dots_ && is_dots(ffd_.cFileName))
+                        continue;
+                e.name = ffd_.cFileName;
+                e.ino = 0;
+                if (ffd_.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+                        e.type = symlink;
+                else if (ffd_.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                        e.type = directory;
+                else
+                        e.type = file;
+                return true;
+        }
+#endif
+}
@@ -0,0 +1,266 @@
+/**
+ * Directory_reader.hpp - stream the entries of a directory without
+ *                        collecting them first
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 15:10:52
+ */
+
+#ifndef DIRECTORY_READER_HPP_
+#define DIRECTORY_READER_HPP_
+
+#include "File.hpp"
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <iterator>
+
+#if defined(__unix__)
+
+#include <dirent.h>
+
+#elif defined(_MSC_VER)
+
+#include <windows.h>
+
+#endif
+
+class Directory_reader {
+public:
+        /**
+         * @brief The type of a directory entry, as reported by the directory
+         *        itself, unknown means the file system did not tell and the
+         *        caller has to query the file
+         */
+        enum Type : unsigned char {
+                unknown,
+                file,
+                directory,
+                symlink,
+                other
+        };
+
+        /**
+         * @brief A directory entry, the name is only valid until the next
+         *        entry is read
+         */
+        struct Entry {
+                std::string_view name;
+                unsigned long long ino{0};
+                Type type{unknown};
+        };
+
+        class iterator;
+
+        static const std::size_t default_buffer_size; // 128 KiB
+
+private:
+#if defined(__linux__)
+        int fd_{-1};
+        char *buf_{nullptr};
+        std::size_t buf_size_{0};
+        std::size_t pos_{0};    // the next record in @buf_
+        std::size_t end_{0};    // the end of the valid records in @buf_
+        bool own_fd_{true};     // whether close() closes @fd_
+#elif defined(__unix__)
+        DIR *dp_{nullptr};
+#elif defined(_MSC_VER)
+        HANDLE h_find_{INVALID_HANDLE_VALUE};
+        WIN32_FIND_DATA ffd_;
+        bool first_{false};     // whether @ffd_ holds an unread entry
+#endif
+        bool skip_dots_{true};
+
+public:
+        Directory_reader() = default;
+        Directory_reader(const Directory_reader &) = delete;
+        Directory_reader &operator=(const Directory_reader &) = delete;
+        ~Directory_reader();
+
+        /**
+         * @brief Create a Directory_reader object, given the pathname of the
+         *        directory to read from
+         *
+         * @param pathname The pathname of the directory
+         * @param skip_dots Whether to skip the "." and ".." entries
+         * @param buf_size The size of the buffer entries are read into,
+         *        larger buffers need fewer system calls
+         */
+        Directory_reader(const std::string &pathname, bool skip_dots = true,
+                        std::size_t buf_size = default_buffer_size);
+
+        /**
+         * @brief Create a Directory_reader object, given the File to read
+         *        from
+         *
+         * @param file The specified File object
+         * @param skip_dots Whether to skip the "." and ".." entries
+         */
+        Directory_reader(const File &file, bool skip_dots = true);
+
+        /**
+         * @brief Tell if this stream is ready to be read
+         *
+         * @return True if the directory opened successfully, false otherwise
+         */
+        bool ready() const;
+
+        /**
+         * @brief Open the given directory
+         *
+         * @param pathname The pathname of the directory
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa close()
+         */
+        bool open(const std::string &pathname);
+
+#if defined(__unix__)
+        /**
+         * @brief Read the directory behind an open file descriptor, the
+         *        descriptor stays owned by the caller and must be kept open
+         *        until the reader is closed
+         *
+         * @param fd The file descriptor of the directory
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa close()
+         */
+        bool open(int fd);
+#endif
+
+        /**
+         * @brief Close the Directory_reader object
+         *
+         * @return True if succeeded and false if failed
+         *
+         * @sa open()
+         */
+        bool close();
+
+        /**
+         * @brief Set whether to skip the "." and ".." entries
+         *
+         * @param skip True to skip them
+         */
+        void skip_dots(bool skip);
+
+        /**
+         * @brief Read the next entry
+         *
+         * @param e The Entry to fill
+         *
+         * @return True if an entry was read, false at the end of the
+         *         directory or on error
+         */
+        bool next(Entry &e);
+
+        /**
+         * @brief Get an iterator reading from the current position, the
+         *        entries can only be walked through once
+         *
+         * @return The iterator
+         */
+        iterator begin();
+
+        /**
+         * @brief Get the iterator standing for the end of the directory
+         *
+         * @return The iterator
+         */
+        iterator end();
+
+private:
+        /**
+         * @brief Check whether @name is "." or ".."
+         *
+         * @param name The entry name
+         *
+         * @return True if it's "." or "..", false otherwise
+         */
+        static bool is_dots(const char *name);
+};
+
+class Directory_reader::iterator {
+private:
+        Directory_reader *reader_{nullptr};
+        Entry entry_;
+
+public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entry *;
+        using reference = const Entry &;
+
+        iterator() = default;
+
+        explicit iterator(Directory_reader *reader): reader_(reader)
+        {
+                ++*this;
+        }
+
+        reference operator*() const
+        {
+                return entry_;
+        }
+
+        pointer operator->() const
+        {
+                return &entry_;
+        }
+
+        iterator &operator++()
+        {
+                if (reader_ && !reader_->next(entry_))
+                        reader_ = nullptr;
+                return *this;
+        }
+
+        bool operator==(const iterator &it) const
+        {
+                return reader_ == it.reader_;
+        }
+
+        bool operator!=(const iterator &it) const
+        {
+                return reader_ != it.reader_;
+        }
+};
+
+inline bool Directory_reader::ready() const
+{
+#if defined(__linux__)
+        return fd_ != -1;
+#elif defined(__unix__)
+        return dp_ != nullptr;
+#elif defined(_MSC_VER)
+        return h_find_ != INVALID_HANDLE_VALUE;
+#endif
+}
+
+inline void Directory_reader::skip_dots(bool skip)
+{
+        skip_dots_ = skip;
+}
+
+inline Directory_reader::iterator Directory_reader::begin()
+{
+        return iterator{this};
+}
+
+inline Directory_reader::iterator Directory_reader::end()
+{
+        return iterator{};
+}
+
+inline bool Directory_reader::is_dots(const char *name)
+{
+        return name[0] == '.' && (name[1] == '\0' ||
+                        (name[1] == '.' && name[2] == '\0'));
+}
+
+#endif
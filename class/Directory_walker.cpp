@@ -0,0 +1,278 @@
+/**
+ * Directory_walker.cpp - walk a directory tree in parallel, relative to the
+ *                        directory file descriptors (Unix only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 01:41:27
+ */
+
+#if defined(__unix__)
+
+#include "Directory_walker.hpp"
+#include "Directory_reader.hpp"
+#include "Thread_pool.hpp"
+#include "File.hpp"
+
+#include <string>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using std::string;
+
+/* an open directory, kept open while its subdirectories wait to be opened
+ * relative to it */
+struct Directory_walker::Dir {
+        int fd;
+
+        explicit Dir(int fd): fd(fd)
+        {
+        }
+
+        ~Dir()
+        {
+                ::close(fd);
+        }
+};
+
+/* the hook state of a directory, alive until the directory and everything
+ * under it has been walked */
+struct Directory_walker::Node {
+        Node *parent;
+        std::shared_ptr<Dir> parent_dir;        // kept open for Leave
+        string path;
+        string::size_type name_pos;
+        int depth;
+        void *data;
+        std::atomic<int> pending;       // itself and its subdirectories
+};
+
+struct Directory_walker::Task {
+        std::shared_ptr<Dir> parent;
+        string path;
+        string::size_type name_pos;     // where the name starts in @path
+        int depth;
+        Node *up;                       // the hook state of @parent
+};
+
+/**
+ * @brief Map the file type bits of st_mode to Directory_reader::Type
+ */
+static Directory_reader::Type to_type(mode_t mode)
+{
+        switch (mode & S_IFMT) {
+        case S_IFREG:
+                return Directory_reader::file;
+        case S_IFDIR:
+                return Directory_reader::directory;
+        case S_IFLNK:
+                return Directory_reader::symlink;
+        default:
+                return Directory_reader::other;
+        }
+}
+
+Directory_walker::Directory_walker(): opt_(Options{})
+{
+}
+
+Directory_walker::Directory_walker(const Options &opt): opt_(opt)
+{
+}
+
+bool Directory_walker::walk(const string &root, const Visitor &visit)
+{
+        stop_ = false;
+        visited_.clear();
+        int fd = ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1)
+                return false;
+        auto dir = std::make_shared<Dir>(fd);
+        if (opt_.symlinks == follow)
+                first_visit(fd);
+        struct stat st;
+        if (opt_.one_file_system && fstat(fd, &st) == 0)
+                root_dev_ = st.st_dev;
+        Node *node = nullptr;
+        if (enter_ || leave_) {
+                Entry e;
+                e.path = root;
+                e.name = e.path;
+                e.type = Directory_reader::directory;
+                e.dirfd = AT_FDCWD;
+                node = enter(nullptr, nullptr, e);
+        }
+        Thread_pool pool(opt_.threads);
+        pool.submit([this, &pool, dir, &root, node, &visit] {
+                read_dir(pool, dir, root, 0, node, visit);
+        });
+        pool.wait();
+        return true;
+}
+
+void Directory_walker::process(Thread_pool &pool, const Task &task,
+                const Visitor &visit)
+{
+        if (stop_) {
+                complete(task.up);
+                return;
+        }
+        int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+        if (opt_.symlinks != follow)
+                flags |= O_NOFOLLOW;
+        int fd = openat(task.parent->fd, task.path.c_str() + task.name_pos,
+                        flags);
+        if (fd == -1) {
+                if (on_error_)
+                        on_error_(task.path, errno);
+                complete(task.up);
+                return;
+        }
+        auto dir = std::make_shared<Dir>(fd);
+        if (opt_.symlinks == follow && !first_visit(fd)) {
+                complete(task.up);
+                return;
+        }
+        Node *node = nullptr;
+        if (task.up) {
+                Entry e;
+                e.path = task.path;
+                e.name = e.path.substr(task.name_pos);
+                e.depth = task.depth;
+                e.type = Directory_reader::directory;
+                e.dirfd = task.parent->fd;
+                e.parent_data = task.up->data;
+                node = enter(task.up, task.parent, e);
+        }
+        read_dir(pool, dir, task.path, task.depth, node, visit);
+}
+
+void Directory_walker::read_dir(Thread_pool &pool,
+                const std::shared_ptr<Dir> &dir, const string &path,
+                int depth, Node *node, const Visitor &visit)
+{
+        /* one reader and one path buffer per worker, reused for every
+         * directory so that only the queued subdirectories allocate */
+        static thread_local Directory_reader dr;
+        static thread_local string buf;
+
+        if (!dr.open(dir->fd)) {
+                if (on_error_)
+                        on_error_(path, errno);
+                complete(node);
+                return;
+        }
+        buf.assign(path);
+        if (buf.empty() || buf.back() != File::separator.back())
+                buf += File::separator;
+        const auto name_pos = buf.size();
+
+        Entry e;
+        e.depth = depth + 1;
+        e.dirfd = dir->fd;
+        e.parent_data = node ? node->data : nullptr;
+        bool can_descend = opt_.max_depth < 0 || e.depth < opt_.max_depth;
+        Directory_reader::Entry de;
+        while (!stop_ && dr.next(de)) {
+                buf.resize(name_pos);
+                buf.append(de.name);
+                e.path = buf;
+                e.name = e.path.substr(name_pos);
+                e.ino = de.ino;
+                e.type = de.type;
+                if (!resolve_type(e))
+                        continue;
+                if (opt_.one_file_system &&
+                                e.type == Directory_reader::directory &&
+                                other_device(e))
+                        continue;
+                if (!filter_ || filter_(e))
+                        visit(e);
+                if (e.type != Directory_reader::directory || !can_descend ||
+                                (prune_ && prune_(e)))
+                        continue;
+                if (node)
+                        ++node->pending;
+                Task t{dir, buf, name_pos, e.depth, node};
+                pool.submit([this, &pool, &visit, t] {
+                        process(pool, t, visit);
+                });
+        }
+        dr.close();
+        complete(node);
+}
+
+Directory_walker::Node *Directory_walker::enter(Node *parent,
+                const std::shared_ptr<Dir> &parent_dir, const Entry &e)
+{
+        Node *node = new Node;
+        node->parent = parent;
+        node->parent_dir = parent_dir;
+        node->path.assign(e.path);
+        node->name_pos = e.path.size() - e.name.size();
+        node->depth = e.depth;
+        node->data = enter_ ? enter_(e) : nullptr;
+        node->pending = 1;
+        return node;
+}
+
+void Directory_walker::complete(Node *node)
+{
+        while (node && --node->pending == 0) {
+                Node *parent = node->parent;
+                if (leave_) {
+                        Entry e;
+                        e.path = node->path;
+                        e.name = e.path.substr(node->name_pos);
+                        e.depth = node->depth;
+                        e.type = Directory_reader::directory;
+                        e.dirfd = node->parent_dir ? node->parent_dir->fd :
+                                AT_FDCWD;
+                        e.parent_data = parent ? parent->data : nullptr;
+                        leave_(e, node->data);
+                }
+                delete node;
+                node = parent;
+        }
+}
+
+bool Directory_walker::other_device(const Entry &e) const
+{
+        struct stat st;
+        if (fstatat(e.dirfd, e.name.data(), &st, opt_.symlinks == follow ?
+                                0 : AT_SYMLINK_NOFOLLOW) != 0)
+                return true;
+        return st.st_dev != root_dev_;
+}
+
+bool Directory_walker::resolve_type(Entry &e)
+{
+        struct stat st;
+        /* e.name ends the path buffer, so it's null-terminated */
+        if (e.type == Directory_reader::unknown) {
+                if (fstatat(e.dirfd, e.name.data(), &st,
+                                        AT_SYMLINK_NOFOLLOW) != 0)
+                        return false;
+                e.type = to_type(st.st_mode);
+        }
+        if (e.type != Directory_reader::symlink)
+                return true;
+        if (opt_.symlinks == skip)
+                return false;
+        if (opt_.symlinks == follow && fstatat(e.dirfd, e.name.data(), &st,
+                                0) == 0)
+                e.type = to_type(st.st_mode);
+        return true;
+}
+
+bool Directory_walker::first_visit(int fd)
+{
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+                return false;
+        std::lock_guard<std::mutex> lk(visited_mtx_);
+        return visited_.emplace(st.st_dev, st.st_ino).second;
+}
+
+#endif
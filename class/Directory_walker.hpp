@@ -0,0 +1,268 @@
+/**
+ * Directory_walker.hpp - walk a directory tree in parallel, relative to the
+ *                        directory file descriptors (Unix only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 01:41:27
+ */
+
+#ifndef DIRECTORY_WALKER_HPP_
+#define DIRECTORY_WALKER_HPP_
+
+#if defined(__unix__)
+
+#include "Directory_reader.hpp"
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <atomic>
+
+class Thread_pool;
+
+class Directory_walker {
+public:
+        /**
+         * @brief What to do with symbolic links
+         */
+        enum Symlink_policy : unsigned char {
+                report,         // report the link itself, never follow it
+                follow,         // report and descend into the target
+                skip            // neither report nor follow
+        };
+
+        /**
+         * @brief An entry met during the walk, the views are only valid
+         *        during the callback
+         */
+        struct Entry {
+                std::string_view path;          // root + separator + ...
+                std::string_view name;          // the last component
+                int depth{0};                   // 1 for children of root
+                Directory_reader::Type type{Directory_reader::unknown};
+                unsigned long long ino{0};
+                int dirfd{-1};  // the containing directory, for the *at calls
+                void *parent_data{nullptr};     // the containing directory's
+                                                // data from the Enter callback
+        };
+
+        struct Options {
+                unsigned int threads{0};        // 0 means one per core
+                int max_depth{-1};              // -1 means no limit
+                Symlink_policy symlinks{report};
+                bool one_file_system{false};    // skip other file systems
+        };
+
+        /* return true to report the entry to the visitor */
+        using Filter = std::function<bool(const Entry &)>;
+        /* return true to not descend into the directory entry */
+        using Prune = std::function<bool(const Entry &)>;
+        /* called for every reported entry */
+        using Visitor = std::function<void(const Entry &)>;
+        /* called with the path and errno of a directory failed to read */
+        using Error_handler = std::function<void(const std::string &, int)>;
+        /* called with a directory about to be read, the root included,
+         * returns the data handed to its entries and to Leave */
+        using Enter = std::function<void *(const Entry &)>;
+        /* called with a directory and its data once everything under it has
+         * been walked, the parents after their children, the dirfd of the
+         * entry is still open */
+        using Leave = std::function<void(const Entry &, void *)>;
+
+private:
+        struct Dir;
+        struct Node;
+        struct Task;
+
+        Options opt_;
+        Filter filter_;
+        Prune prune_;
+        Error_handler on_error_;
+        Enter enter_;
+        Leave leave_;
+        unsigned long long root_dev_{0};
+        std::mutex visited_mtx_;
+        std::set<std::pair<unsigned long long, unsigned long long>> visited_;
+        std::atomic<bool> stop_{false};
+
+public:
+        Directory_walker(const Directory_walker &) = delete;
+        Directory_walker &operator=(const Directory_walker &) = delete;
+        ~Directory_walker() = default;
+
+        /**
+         * @brief Create a Directory_walker object with the default options
+         */
+        Directory_walker();
+
+        /**
+         * @brief Create a Directory_walker object with the given options
+         *
+         * @param opt The options
+         */
+        explicit Directory_walker(const Options &opt);
+
+        /**
+         * @brief Set the filter deciding which entries are reported, all
+         *        entries are reported without it
+         *
+         * @param filter The filter, called from the worker threads
+         */
+        void set_filter(Filter filter);
+
+        /**
+         * @brief Set the callback deciding which directories are not
+         *        descended into, it's asked for reported or not
+         *
+         * @param prune The callback, called from the worker threads
+         */
+        void set_prune(Prune prune);
+
+        /**
+         * @brief Set the callback for the directories failed to open or read
+         *
+         * @param on_error The callback, called from the worker threads
+         */
+        void set_error_handler(Error_handler on_error);
+
+        /**
+         * @brief Set the callbacks run before and after each directory,
+         *        giving every directory a data slot, e.g. to sum up the
+         *        subtrees in parallel
+         *
+         * @param enter The callback returning the data of a directory, may
+         *        be empty, called from the worker threads
+         * @param leave The callback run once the directory and everything
+         *        under it has been walked, it owns the data from then on,
+         *        called from the worker threads
+         */
+        void set_hooks(Enter enter, Leave leave);
+
+        /**
+         * @brief Walk the tree under @root, the root itself is not reported,
+         *        the subdirectories are read in parallel so the visitor is
+         *        called from several threads at once and in no fixed order
+         *
+         * @param root The root directory
+         * @param visit The visitor
+         *
+         * @return True if the root could be opened, false otherwise
+         */
+        bool walk(const std::string &root, const Visitor &visit);
+
+        /**
+         * @brief Stop the running walk as soon as possible, the directories
+         *        already being read are finished
+         */
+        void stop();
+
+private:
+        /**
+         * @brief Open a directory relative to its parent and read it
+         *
+         * @param pool The pool running the walk
+         * @param task The directory to read
+         * @param visit The visitor
+         */
+        void process(Thread_pool &pool, const Task &task,
+                        const Visitor &visit);
+
+        /**
+         * @brief Read an open directory and queue its subdirectories
+         *
+         * @param pool The pool running the walk
+         * @param dir The directory
+         * @param path The path of the directory
+         * @param depth The depth of the directory, 0 for the root
+         * @param node The hook state of the directory, nullptr if no hooks
+         * @param visit The visitor
+         */
+        void read_dir(Thread_pool &pool, const std::shared_ptr<Dir> &dir,
+                        const std::string &path, int depth, Node *node,
+                        const Visitor &visit);
+
+        /**
+         * @brief Create the hook state of a directory and run the Enter
+         *        callback
+         *
+         * @param parent The hook state of the parent, nullptr for the root
+         * @param parent_dir The parent directory, kept open until Leave,
+         *        nullptr for the root
+         * @param e The directory
+         *
+         * @return The hook state
+         */
+        Node *enter(Node *parent, const std::shared_ptr<Dir> &parent_dir,
+                        const Entry &e);
+
+        /**
+         * @brief Drop a reference to a directory, running the Leave
+         *        callback of it and its parents whose last reference it was
+         *
+         * @param node The hook state of the directory, nullptr if no hooks
+         */
+        void complete(Node *node);
+
+        /**
+         * @brief Tell if a directory entry is on another file system than
+         *        the root
+         *
+         * @param e The entry
+         *
+         * @return True if it is, false otherwise
+         */
+        bool other_device(const Entry &e) const;
+
+        /**
+         * @brief Fill in the type of an entry the directory did not tell,
+         *        and the target type of a symbolic link to follow
+         *
+         * @param e The entry
+         *
+         * @return False if the entry should be skipped, true otherwise
+         */
+        bool resolve_type(Entry &e);
+
+        /**
+         * @brief Remember a directory walked while following symbolic links
+         *
+         * @param fd The file descriptor of the directory
+         *
+         * @return False if it has been walked already, true otherwise
+         */
+        bool first_visit(int fd);
+};
+
+inline void Directory_walker::set_filter(Filter filter)
+{
+        filter_ = std::move(filter);
+}
+
+inline void Directory_walker::set_prune(Prune prune)
+{
+        prune_ = std::move(prune);
+}
+
+inline void Directory_walker::set_error_handler(Error_handler on_error)
+{
+        on_error_ = std::move(on_error);
+}
+
+inline void Directory_walker::set_hooks(Enter enter, Leave leave)
+{
+        enter_ = std::move(enter);
+        leave_ = std::move(leave);
+}
+
+inline void Directory_walker::stop()
+{
+        stop_ = true;
+}
+
+#endif
+
+#endif
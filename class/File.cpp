@@ -2,21 +2,29 @@
  * File.cpp - offer the multi-platform basic file operation
  *
  * Created by Haoyuan Li on 2021/08/11
- * Last Modified: 2021/08/18 23:51:51
+ * Last Modified: 2026/10/20 13:31:20
  */
 
 #include "File.hpp"
+#include "Directory_reader.hpp"
 
 #include <vector>
 #include <string>
 #include <sys/stat.h>
 #include <ctime>
 #include <cstdlib>
+#include <cerrno>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 #if defined(__unix__)
 
 #include <unistd.h>
-#include <dirent.h>
+#include <fcntl.h>
+#if defined(__linux__)
+#include <sys/sysmacros.h>
+#endif
 
 #elif defined(_MSC_VER)
 
@@ -31,6 +39,17 @@
 
 #endif
 
+#if defined(STATX_BASIC_STATS)
+/* the fields a Status holds, the file system may skip the others */
+#define STATUS_MASK (STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_INO | \
+                STATX_SIZE | STATX_BLOCKS | STATX_MTIME)
+#else
+#define STATX_TYPE 0
+#define STATX_SIZE 0
+#define STATX_MTIME 0
+#define STATUS_MASK 0
+#endif
+
 using std::string;
 
 #if defined(__unix__)
@@ -43,75 +62,152 @@ File::File(const string &pathname): pathname_(pathname)
 {
 }
 
-File::File(const string &parent, const string &child):
-        pathname_(parent + separator + child)
+File::File(const string &parent, const string &child)
 {
+        pathname_.reserve(parent.size() + separator.size() + child.size());
+        pathname_.append(parent).append(separator).append(child);
 }
 
 void File::bind(const string &pathname)
 {
         pathname_ = pathname;
+        cached_ = false;
 }
 
 void File::unbind()
 {
         pathname_.clear();
+        cached_ = false;
 }
 
-bool File::exists(const string &pathname)
+bool File::query_status(const string &pathname, Status &st,
+                const unsigned int &mask)
 {
+#if defined(__unix__)
+        return query_status(AT_FDCWD, pathname.c_str(), 0, st, mask);
+#else
+        st = Status{};
         struct stat s;
-        return stat(pathname.c_str(), &s) == 0;
+        if (stat(pathname.c_str(), &s) != 0)
+                return false;
+        st.mode = s.st_mode;
+        st.size = s.st_size;
+        st.mtime = s.st_mtime;
+        st.ino = s.st_ino;
+        st.dev = s.st_dev;
+        st.nlink = s.st_nlink;
+        st.exists = true;
+        return true;
+#endif
+}
+
+#if defined(__unix__)
+
+bool File::query_status(int dirfd, const char *name, int flags, Status &st,
+                const unsigned int &mask)
+{
+        st = Status{};
+#if defined(STATX_BASIC_STATS)
+        struct statx s;
+        if (statx(dirfd, name, flags | AT_STATX_SYNC_AS_STAT, mask, &s) != 0)
+                return false;
+        st.mode = s.stx_mode;
+        st.size = s.stx_size;
+        st.blocks = s.stx_blocks;
+        st.mtime = s.stx_mtime.tv_sec;
+        st.mtime_nsec = s.stx_mtime.tv_nsec;
+        st.ino = s.stx_ino;
+        st.dev = makedev(s.stx_dev_major, s.stx_dev_minor);
+        st.nlink = s.stx_nlink;
+#else
+        struct stat s;
+        if (fstatat(dirfd, name, &s, flags) != 0)
+                return false;
+        st.mode = s.st_mode;
+        st.size = s.st_size;
+        st.blocks = s.st_blocks;
+        st.mtime = s.st_mtime;
+        st.mtime_nsec = s.st_mtim.tv_nsec;
+        st.ino = s.st_ino;
+        st.dev = s.st_dev;
+        st.nlink = s.st_nlink;
+#endif
+        st.exists = true;
+        return true;
+}
+
+File::Status File::status_at(int dirfd, const string &name, bool follow)
+{
+        Status st;
+        query_status(dirfd, name.c_str(), follow ? 0 : AT_SYMLINK_NOFOLLOW,
+                        st, STATUS_MASK);
+        return st;
+}
+
+#endif
+
+File::Status File::status(const string &pathname)
+{
+        Status st;
+        query_status(pathname, st, STATUS_MASK);
+        return st;
+}
+
+const File::Status &File::status() const
+{
+        if (!cached_)
+                refresh();
+        return status_;
+}
+
+const File::Status &File::refresh() const
+{
+        query_status(pathname_, status_, STATUS_MASK);
+        cached_ = true;
+        return status_;
+}
+
+bool File::exists(const string &pathname)
+{
+        Status st;
+        return query_status(pathname, st, 0);
 }
 
 bool File::exists() const
 {
-        return exists(pathname_);
+        return status().exists;
 }
 
 bool File::is_file(const string &pathname)
 {
-        bool state{false};
-#if defined(__unix__)
-        struct stat s;
-        if (stat(pathname.c_str(), &s) == 0)
-                state = S_ISREG(s.st_mode);
-#elif defined(_MSC_VER)
-        if(!(GetFileAttributes(pathname.c_str()) & FILE_ATTRIBUTE_DIRECTORY))
-                state = true;
-#endif
-        return state;
+        Status st;
+        query_status(pathname, st, STATX_TYPE);
+        return st.is_file();
 }
 
 bool File::is_file() const
 {
-        return is_file(pathname_);
+        return status().is_file();
 }
 
 bool File::is_directory(const string &pathname)
 {
-        bool state{false};
-#if defined(__unix__)
-        struct stat s;
-        if (stat(pathname.c_str(), &s) == 0)
-                state = S_ISDIR(s.st_mode);
-#elif defined(_MSC_VER)
-        if (GetFileAttributes(pathname.c_str()) & FILE_ATTRIBUTE_DIRECTORY)
-                state = true;
-#endif
-        return state;
+        Status st;
+        query_status(pathname, st, STATX_TYPE);
+        return st.is_directory();
 }
 
 bool File::is_directory() const
 {
-        return is_directory(pathname_);
+        return status().is_directory();
 }
 
 bool File::is_hidden(const string &pathname)
 {
         bool state{false};
 #if defined(__unix__)
-        state = (get_name(pathname)[0] == '.');
+        auto name = get_name(Path_view{pathname});
+        state = (!name.empty() && name[0] == '.');
 #elif defined(_MSC_VER)
         if (GetFileAttributes(pathname.c_str()) & FILE_ATTRIBUTE_HIDDEN)
                 state = true;
@@ -126,10 +222,12 @@ bool File::is_hidden() const
 
 string File::get_name(const string &pathname)
 {
-        auto pos = find_last_separator(pathname);
-        if (pos != string::npos)
-                return pathname.substr(pos + 1);
-        return pathname;
+        return string{Path_view{pathname}.get_name()};
+}
+
+std::string_view File::get_name(Path_view pathname)
+{
+        return pathname.get_name();
 }
 
 string File::get_name() const
@@ -137,17 +235,19 @@ string File::get_name() const
         return get_name(pathname_);
 }
 
-string File::get_path() const
+const string &File::get_path() const
 {
         return pathname_;
 }
 
 string File::get_parent(const string &pathname)
 {
-        auto pos = find_last_separator(pathname);
-        if (pos != string::npos)
-                return pathname.substr(0, pos);
-        return "";
+        return string{Path_view{pathname}.get_parent().str()};
+}
+
+std::string_view File::get_parent(Path_view pathname)
+{
+        return pathname.get_parent().str();
 }
 
 string File::get_parent() const
@@ -155,15 +255,29 @@ string File::get_parent() const
         return get_parent(pathname_);
 }
 
-string File::get_absolute_path(const string &pathname)
+#if defined(__unix__)
+
+/* the canonical paths of the directories seen by get_absolute_path(), keyed
+ * by the directory as given, all dropped when the generation moves on; an
+ * entry is used only while it still names the same directory as the key */
+static std::mutex path_cache_mtx;
+static std::unordered_map<string, string> path_cache;
+static unsigned long path_cache_gen = 0;
+static std::atomic<unsigned long> path_gen{0};
+static const std::size_t path_cache_max = 4096;
+
+/**
+ * @brief Resolve @pathname by realpath(), stripping the last component
+ *        until the rest exists
+ */
+static string resolve_path(const string &pathname)
 {
         string abs_path{pathname};
-#if defined(__unix__)
         string parent{pathname};
         string child{""};
-        char *p;
+        char *p = nullptr;
         while (!parent.empty() && !(p = realpath(parent.c_str(), nullptr))) {
-                auto pos = find_last_separator(parent);
+                auto pos = File::find_last_separator(parent);
                 if (pos == string::npos)
                         break;
                 child = parent.substr(pos) + child;
@@ -173,6 +287,74 @@ string File::get_absolute_path(const string &pathname)
                 abs_path = string{p} + child;
                 free(p);
         }
+        return abs_path;
+}
+
+#endif
+
+string File::get_absolute_path(const string &pathname)
+{
+        string abs_path{pathname};
+#if defined(__unix__)
+        auto pos = find_last_separator(pathname);
+        string name = (pos == string::npos) ? "" : pathname.substr(pos + 1);
+        if (name.empty() || name == "." || name == "..")
+                return resolve_path(pathname);
+
+        string dir = (pos == 0) ? separator : pathname.substr(0, pos);
+        string tail = separator + name;
+        struct stat ds;
+        /* a path not made yet keeps its missing part as given, under the
+         * deepest directory that exists, which is the one cached */
+        while (stat(dir.c_str(), &ds) != 0) {
+                pos = find_last_separator(dir);
+                if (pos == string::npos)
+                        return resolve_path(pathname);
+                tail = dir.substr(pos) + tail;
+                dir = (pos == 0) ? separator : dir.substr(0, pos);
+        }
+        const string &key = dir;
+
+        string resolved;
+        bool found = false;
+        {
+                std::lock_guard<std::mutex> lk(path_cache_mtx);
+                if (path_cache_gen != path_gen.load()) {
+                        path_cache.clear();
+                        path_cache_gen = path_gen.load();
+                }
+                auto it = path_cache.find(key);
+                if (it != path_cache.end()) {
+                        resolved = it->second;
+                        found = true;
+                }
+        }
+        /* a rename, a symlink pointed elsewhere or a chdir() by anyone
+         * leaves the cached path at another directory, or at none */
+        struct stat rs;
+        if (found && (stat(resolved.c_str(), &rs) != 0 ||
+                                rs.st_dev != ds.st_dev ||
+                                rs.st_ino != ds.st_ino))
+                found = false;
+        if (!found) {
+                unsigned long gen = path_gen.load();
+                resolved = resolve_path(dir);
+                std::lock_guard<std::mutex> lk(path_cache_mtx);
+                if (path_cache_gen == gen) {
+                        if (path_cache.size() >= path_cache_max)
+                                path_cache.clear();
+                        path_cache[key] = resolved;
+                }
+        }
+
+        abs_path = resolved;
+        abs_path.append(tail, abs_path == separator ? 1 : 0, string::npos);
+        /* only the last component is not covered by the cache */
+        struct stat s;
+        if (tail.size() == name.size() + 1 &&
+                        lstat(abs_path.c_str(), &s) == 0 &&
+                        S_ISLNK(s.st_mode))
+                abs_path = resolve_path(abs_path);
 #elif defined(_MSC_VER)
         DWORD state = 0;
         TCHAR buf[MAX_PATH] = TEXT("");
@@ -184,6 +366,13 @@ string File::get_absolute_path(const string &pathname)
         return abs_path;
 }
 
+void File::invalidate_path_cache()
+{
+#if defined(__unix__)
+        path_gen.fetch_add(1);
+#endif
+}
+
 string File::get_absolute_path() const
 {
         return get_absolute_path(pathname_);
@@ -191,16 +380,14 @@ string File::get_absolute_path() const
 
 time_t File::last_modified(const string &pathname)
 {
-        time_t t = 0;
-        struct stat s;
-        if (stat(pathname.c_str(), &s) == 0)
-                t = s.st_mtime;
-        return t;
+        Status st;
+        query_status(pathname, st, STATX_MTIME);
+        return st.mtime;
 }
 
 time_t File::last_modified() const
 {
-        return last_modified(pathname_);
+        return status().mtime;
 }
 
 string File::get_time_str(const time_t &t, const string &format)
@@ -218,16 +405,14 @@ string File::get_time_str(const time_t &t, const string &format)
 
 long File::get_size(const string &pathname)
 {
-        long size = 0;
-        struct stat s;
-        if (stat(pathname.c_str(), &s) == 0 && is_file(pathname))
-                size = s.st_size;
-        return size;
+        Status st;
+        query_status(pathname, st, STATX_TYPE | STATX_SIZE);
+        return st.is_file() ? st.size : 0;
 }
 
 long File::get_size() const
 {
-        return get_size(pathname_);
+        return status().is_file() ? status().size : 0;
 }
 
 bool File::can_read(const string &pathname)
@@ -263,41 +448,20 @@ bool File::can_execute() const
 std::vector<string> File::list(const string &pathname)
 {
         std::vector<string> filelist;
-#if defined(__unix__)
-        DIR *dp;
-        struct dirent *p;
-        do {
-                if ((dp = opendir(pathname.c_str())) == nullptr)
-                        break;
-                while ((p = readdir(dp)))
-                        filelist.push_back(p->d_name);
-                closedir(dp);
-        } while (0);
-#elif defined(_MSC_VER)
-        WIN32_FIND_DATA ffd;
-        HANDLE h_find = INVALID_HANDLE_VALUE;
-        do {
-                h_find = FindFirstFile((pathname + separator + "*").c_str(), &ffd);
-                if (h_find == INVALID_HANDLE_VALUE)
-                        break;
-                do {
-                        filelist.push_back(ffd.cFileName);
-                } while (FindNextFile(h_find, &ffd));
-                FindClose(h_find);
-        } while (0); 
-#endif
+        Directory_reader dr(pathname, false);
+        for (const auto &e : dr)
+                filelist.emplace_back(e.name);
         return filelist;
 }
 
 string File::get_extension(const string &pathname)
 {
-        string ext{""};
-        auto spos = find_last_separator(pathname);
-        auto dpos = pathname.find_last_of(".");
-        if (dpos != string::npos && dpos != 0 && (spos == string::npos ||
-                                dpos > spos))
-                ext = pathname.substr(dpos + 1);
-        return ext;
+        return string{Path_view{pathname}.get_extension()};
+}
+
+std::string_view File::get_extension(Path_view pathname)
+{
+        return pathname.get_extension();
 }
 
 string File::get_extension() const
@@ -333,6 +497,7 @@ bool File::create_new_file(const string &pathname)
 
 bool File::create_new_file()
 {
+        cached_ = false;
         return create_new_file(pathname_);
 }
 
@@ -349,11 +514,13 @@ bool File::remove(const string &pathname)
         else if (is_directory(pathname))
                 state = RemoveDirectory(pathname.c_str()) != 0;
 #endif
+        invalidate_path_cache();
         return state;
 }
 
 bool File::remove()
 {
+        cached_ = false;
         return remove(pathname_);
 }
 
@@ -366,9 +533,28 @@ bool File::mkdir(const string &pathname, mode_t mode)
 
 bool File::mkdir(mode_t mode)
 {
+        cached_ = false;
         return mkdir(pathname_, mode);
 }
 
+bool File::create_directories(const string &pathname, mode_t mode)
+{
+        if (pathname.empty())
+                return false;
+        if (mkdir(pathname, mode))
+                return true;
+        int err = errno;
+        if (err == EEXIST)
+                return is_directory(pathname);
+        /* create the parents only when they are missing, most calls end at
+         * the first mkdir() */
+        string parent{get_parent(Path_view{pathname})};
+        if (err != ENOENT || parent.empty() ||
+                        !create_directories(parent, mode))
+                return false;
+        return mkdir(pathname, mode) || is_directory(pathname);
+}
+
 #elif defined(_MSC_VER)
 
 bool File::mkdir(const string &pathname)
@@ -378,14 +564,34 @@ bool File::mkdir(const string &pathname)
 
 bool File::mkdir()
 {
+        cached_ = false;
         return mkdir(pathname_);
 }
 
+bool File::create_directories(const string &pathname)
+{
+        if (pathname.empty())
+                return false;
+        if (mkdir(pathname))
+                return true;
+        int err = errno;
+        if (err == EEXIST)
+                return is_directory(pathname);
+        /* create the parents only when they are missing, most calls end at
+         * the first mkdir() */
+        string parent{get_parent(Path_view{pathname})};
+        if (err != ENOENT || parent.empty() || !create_directories(parent))
+                return false;
+        return mkdir(pathname) || is_directory(pathname);
+}
+
 #endif
 
 bool File::move(const string &src, const string &dest)
 {
-        return rename(src.c_str(), dest.c_str()) == 0;
+        bool state = rename(src.c_str(), dest.c_str()) == 0;
+        invalidate_path_cache();
+        return state;
 }
 
 bool File::move(const string &dest)
@@ -394,6 +600,7 @@ bool File::move(const string &dest)
         if (move(pathname_, dest)) {
                 state = true;
                 pathname_ = dest;
+                cached_ = false;
         }
         return state;
 }
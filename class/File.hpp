@@ -2,19 +2,89 @@
  * File.hpp - offer the multi-platform basic file operation
  *
  * Created by Haoyuan Li on 2021/08/11
- * Last Modified: 2021/08/18 23:53:08
+ * Last Modified: 2026/10/20 11:42:19
  */
 
 #ifndef FILE_HPP_
 #define FILE_HPP_
 
+#include "Path.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
+#include <functional>
 #include <ctime>
+#include <sys/stat.h>
+
+class Thread_pool;
 
 class File {
+public:
+        /**
+         * @brief The metadata of a file, all fields are filled by a single
+         *        query and stay unchanged until the next one
+         */
+        struct Status {
+                bool exists{false};             // whether the query succeeded
+                unsigned int mode{0};           // file type and permission
+                long long size{0};              // size in bytes
+                long long blocks{0};            // 512-byte blocks allocated
+                time_t mtime{0};                // last-modified time
+                long mtime_nsec{0};             // nanoseconds of @mtime
+                unsigned long long ino{0};      // inode number
+                unsigned long long dev{0};      // device number
+                unsigned long long nlink{0};    // number of hard links
+
+                bool is_file() const;
+                bool is_directory() const;
+                bool is_symlink() const;
+        };
+
+        /**
+         * @brief The space used by a file or a directory tree
+         */
+        struct Usage {
+                long long size{0};              // apparent size in bytes
+                long long disk{0};              // allocated bytes
+                unsigned long long files{0};    // entries but directories
+                unsigned long long dirs{0};     // directories, root included
+        };
+
+        struct Usage_options {
+                unsigned int threads{0};        // 0 means one per core
+                bool one_file_system{false};    // skip other file systems
+                bool count_links{false};        // count every hard link
+        };
+
+        /* called with each finished directory and the usage under it */
+        using Usage_progress = std::function<void(const std::string &,
+                        const Usage &)>;
+
+        /**
+         * @brief An entry a tree operation failed on
+         */
+        struct Tree_error {
+                std::string path;
+                int error;                      // the errno
+        };
+
+        /**
+         * @brief What a tree operation did, it goes on past the failures
+         */
+        struct Tree_report {
+                unsigned long long done{0};     // entries removed or copied
+                std::vector<Tree_error> errors;
+        };
+
+        /* called with each entry done and the number done so far */
+        using Tree_progress = std::function<void(std::string_view,
+                        unsigned long long)>;
+
 private:
         std::string pathname_{""}; // the file path
+        mutable Status status_;    // the snapshot of the file metadata
+        mutable bool cached_{false}; // whether @status_ is filled
 
 public:
         static const std::string separator; // the path separator
@@ -68,6 +138,179 @@ public:
          */
         void unbind();
 
+        /**
+         * @brief Get the metadata of the file @pathname in one query
+         *
+         * @param pathname The pathname
+         *
+         * @return The metadata, with exists set to false if the query failed
+         */
+        static Status status(const std::string &pathname);
+
+        /**
+         * @brief Get the metadata snapshot of the file, it's taken by the
+         *        first query and used by exists(), is_file(), is_directory(),
+         *        last_modified() and get_size() until refresh() is called
+         *        or the File object itself changes the file
+         *
+         * @return The metadata snapshot
+         *
+         * @sa refresh()
+         */
+        const Status &status() const;
+
+        /**
+         * @brief Take a new metadata snapshot of the file
+         *
+         * @return The new metadata snapshot
+         *
+         * @sa status()
+         */
+        const Status &refresh() const;
+
+        /**
+         * @brief Get the metadata of many files at once, the queries run in
+         *        parallel so the latency of slow file systems overlaps
+         *
+         * @param pathnames The pathnames
+         * @param st The vector to store the metadata, resized to the number
+         *        of @pathnames and filled in the same order
+         * @param threads The number of threads, 0 means one per core
+         */
+        static void status(const std::vector<std::string> &pathnames,
+                        std::vector<Status> &st, unsigned int threads = 0);
+
+        /**
+         * @brief Get the metadata of many files at once on the given pool
+         *
+         * @param pathnames The pathnames
+         * @param st The vector to store the metadata, resized to the number
+         *        of @pathnames and filled in the same order
+         * @param pool The thread pool to run the queries, must not be the
+         *        pool of the calling thread
+         */
+        static void status(const std::vector<std::string> &pathnames,
+                        std::vector<Status> &st, Thread_pool &pool);
+
+#if defined(__unix__)
+        /**
+         * @brief Sum up the space used by a file or a directory tree, the
+         *        subdirectories are walked in parallel and a file with many
+         *        hard links is counted once
+         *
+         * @param pathname The pathname, followed if it's a symbolic link
+         * @param usage The Usage to fill
+         *
+         * @return True if succeeded and false if @pathname could not be read
+         */
+        static bool disk_usage(const std::string &pathname, Usage &usage);
+
+        /**
+         * @brief Sum up the space used by a file or a directory tree
+         *
+         * @param pathname The pathname, followed if it's a symbolic link
+         * @param usage The Usage to fill
+         * @param opt The options
+         * @param progress The callback run as each directory is finished,
+         *        the subdirectories before their parent, called from the
+         *        worker threads
+         *
+         * @return True if succeeded and false if @pathname could not be read
+         */
+        static bool disk_usage(const std::string &pathname, Usage &usage,
+                        const Usage_options &opt,
+                        const Usage_progress &progress = nullptr);
+
+        /**
+         * @brief Find the files and directories matching a glob pattern
+         *        under a directory, the subdirectories that cannot hold a
+         *        match are not read
+         *
+         * @param root The directory where the pattern starts
+         * @param pattern The pattern, see Glob for the syntax
+         * @param matches The vector to store the sorted matching pathnames,
+         *        each starting with @root
+         * @param threads The number of threads to walk with, 0 means one per
+         *        core
+         *
+         * @return True if succeeded and false if the pattern is bad or @root
+         *         could not be read
+         */
+        static bool glob(const std::string &root, const std::string &pattern,
+                        std::vector<std::string> &matches,
+                        unsigned int threads = 0);
+
+        /**
+         * @brief Remove a file or a directory with everything in it, the
+         *        subdirectories are emptied in parallel, symbolic links are
+         *        removed but not followed
+         *
+         * @param pathname The pathname
+         *
+         * @return True if everything was removed, false otherwise
+         */
+        static bool remove_all(const std::string &pathname);
+
+        /**
+         * @brief Remove a file or a directory with everything in it, going
+         *        on past the entries failed to remove
+         *
+         * @param pathname The pathname
+         * @param report The Tree_report to fill
+         * @param threads The number of threads, 0 means one per core
+         * @param progress The callback run as each entry is removed, called
+         *        from the worker threads
+         *
+         * @return True if everything was removed, false otherwise
+         */
+        static bool remove_all(const std::string &pathname,
+                        Tree_report &report, unsigned int threads = 0,
+                        const Tree_progress &progress = nullptr);
+
+        /**
+         * @brief Copy a file or a directory with everything in it, the
+         *        subdirectories are copied in parallel, symbolic links are
+         *        copied as links and the existing files are overwritten
+         *
+         * @param src The source pathname
+         * @param dest The destination pathname
+         *
+         * @return True if everything was copied, false otherwise
+         */
+        static bool copy_all(const std::string &src, const std::string &dest);
+
+        /**
+         * @brief Copy a file or a directory with everything in it, going on
+         *        past the entries failed to copy
+         *
+         * @param src The source pathname
+         * @param dest The destination pathname
+         * @param report The Tree_report to fill
+         * @param threads The number of threads, 0 means one per core
+         * @param progress The callback run as each entry is copied, called
+         *        from the worker threads
+         *
+         * @return True if everything was copied, false otherwise
+         */
+        static bool copy_all(const std::string &src, const std::string &dest,
+                        Tree_report &report, unsigned int threads = 0,
+                        const Tree_progress &progress = nullptr);
+
+        /**
+         * @brief Get the metadata of the file @name relative to the
+         *        directory @dirfd in one query
+         *
+         * @param dirfd The file descriptor of the directory, AT_FDCWD for
+         *        the current working directory
+         * @param name The pathname relative to @dirfd
+         * @param follow Whether to follow @name if it's a symbolic link
+         *
+         * @return The metadata, with exists set to false if the query failed
+         */
+        static Status status_at(int dirfd, const std::string &name,
+                        bool follow = true);
+#endif
+
         /**
          * @brief Check whether the file @pathname exists
          *
@@ -141,6 +384,17 @@ public:
          */
         static std::string get_name(const std::string &pathname);
 
+        /**
+         * @brief Get the name of the file @pathname without the parent path,
+         *        without copying it
+         *
+         * @param pathname The pathname
+         *
+         * @return The name of the file without the parent path, a view into
+         *         @pathname
+         */
+        static std::string_view get_name(Path_view pathname);
+
         /**
          * @brief Get the name of the file without the parent path
          *
@@ -157,22 +411,43 @@ public:
          */
         static std::string get_parent(const std::string &pathname);
 
+        /**
+         * @brief Get the name of the parent path without copying it
+         *
+         * @param pathname The pathname
+         *
+         * @return The name of the parent path, a view into @pathname, empty
+         *         if not found
+         */
+        static std::string_view get_parent(Path_view pathname);
+
         /**
          * @brief Get the path of file
          *
-         * @return The path
+         * @return The path, valid until the File object is rebound
          */
-        std::string get_path() const;
+        const std::string &get_path() const;
 
         /**
-         * @brief Get the canonicalized absolute path
+         * @brief Get the canonicalized absolute path, the directories are
+         *        resolved once and then served from a cache, each entry
+         *        checked by device and inode to still name the directory
          *
          * @param pathname The pathname
          *
          * @return The canonicalized absolute path
+         *
+         * @sa invalidate_path_cache()
          */
         static std::string get_absolute_path(const std::string &pathname);
 
+        /**
+         * @brief Drop the cached directory resolutions of
+         *        get_absolute_path(), the stale ones are found anyway, so
+         *        this only frees them
+         */
+        static void invalidate_path_cache();
+
         /**
          * @brief Get the name of the parent path
          *
@@ -287,7 +562,8 @@ public:
         bool can_execute() const;
 
         /**
-         * @brief List all files and subdirectories in the directory
+         * @brief List all files and subdirectories in the directory, use
+         *        Directory_reader to stream large directories instead
          *
          * @param pathname The directory path
          *
@@ -313,6 +589,15 @@ public:
          */
         static std::string get_extension(const std::string &pathname);
 
+        /**
+         * @brief Get the extension of file @pathname without copying it
+         *
+         * @param pathname The pathname
+         *
+         * @return The extension, a view into @pathname, empty when not found
+         */
+        static std::string_view get_extension(Path_view pathname);
+
         /**
          * @brief Get the extension of the file
          *
@@ -367,6 +652,19 @@ public:
          */
         static bool mkdir(const std::string &pathname, mode_t mode = 0755);
 
+        /**
+         * @brief Create a directory and the missing parents of it
+         *
+         * @param pathname The pathname
+         * @param mode The permission of the created directories, default:
+         *        0755
+         *
+         * @return True if the directory exists when it returns, false
+         *         otherwise
+         */
+        static bool create_directories(const std::string &pathname,
+                        mode_t mode = 0755);
+
         /**
          * @brief Crete a directory
          *
@@ -385,6 +683,16 @@ public:
          */
         static bool mkdir(const std::string &pathname);
 
+        /**
+         * @brief Create a directory and the missing parents of it
+         *
+         * @param pathname The pathname
+         *
+         * @return True if the directory exists when it returns, false
+         *         otherwise
+         */
+        static bool create_directories(const std::string &pathname);
+
         /**
          * @brief Crete a directory
          *
@@ -424,6 +732,56 @@ private:
          * @sa get_error()
          */
         std::string::size_type find_last_separator() const;
+
+        /**
+         * @brief Query the metadata of the file @pathname
+         *
+         * @param pathname The pathname
+         * @param st The Status to fill
+         * @param mask The fields needed, a combination of STATX_* flags, only
+         *        a hint for the file system and ignored without statx()
+         *
+         * @return True if succeeded and false if failed
+         */
+        static bool query_status(const std::string &pathname, Status &st,
+                        const unsigned int &mask);
+
+#if defined(__unix__)
+        /**
+         * @brief Query the metadata of the file @name relative to the
+         *        directory @dirfd
+         *
+         * @param dirfd The file descriptor of the directory
+         * @param name The pathname relative to @dirfd
+         * @param flags The AT_* flags
+         * @param st The Status to fill
+         * @param mask The fields needed, a combination of STATX_* flags, only
+         *        a hint for the file system and ignored without statx()
+         *
+         * @return True if succeeded and false if failed
+         */
+        static bool query_status(int dirfd, const char *name, int flags,
+                        Status &st, const unsigned int &mask);
+#endif
 };
 
+inline bool File::Status::is_file() const
+{
+        return exists && (mode & S_IFMT) == S_IFREG;
+}
+
+inline bool File::Status::is_directory() const
+{
+        return exists && (mode & S_IFMT) == S_IFDIR;
+}
+
+inline bool File::Status::is_symlink() const
+{
+#if defined(S_IFLNK)
+        return exists && (mode & S_IFMT) == S_IFLNK;
+#else
+        return false;
+#endif
+}
+
 #endif
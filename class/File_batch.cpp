@@ -0,0 +1,47 @@
+/**
+ * File_batch.cpp - the File queries over many files at once
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 18:52:10
+ */
+
+#include "File.hpp"
+#include "Thread_pool.hpp"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+
+using std::string;
+
+/* the number of paths a task queries, big enough to hide the cost of the
+ * task and small enough to keep all workers busy until the end */
+static const std::size_t batch_chunk = 64;
+
+void File::status(const std::vector<string> &pathnames,
+                std::vector<Status> &st, unsigned int threads)
+{
+        if (pathnames.size() <= batch_chunk) {
+                st.resize(pathnames.size());
+                for (std::size_t i = 0; i < pathnames.size(); ++i)
+                        st[i] = status(pathnames[i]);
+                return;
+        }
+        Thread_pool pool(threads);
+        status(pathnames, st, pool);
+}
+
+void File::status(const std::vector<string> &pathnames,
+                std::vector<Status> &st, Thread_pool &pool)
+{
+        st.resize(pathnames.size());
+        for (std::size_t i = 0; i < pathnames.size(); i += batch_chunk) {
+                std::size_t end = std::min(i + batch_chunk, pathnames.size());
+                pool.submit([&pathnames, &st, i, end] {
+                        for (std::size_t j = i; j < end; ++j)
+                                st[j] = status(pathnames[j]);
+                });
+        }
+        pool.wait();
+}
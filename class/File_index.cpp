@@ -0,0 +1,584 @@
+/**
+ * File_index.cpp - a persistent index of a directory tree, refreshed by
+ *                  re-reading only the directories that changed (Unix only)
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 02:48:10
+ */
+
+#include "File_index.hpp"
+
+#if defined(__unix__)
+
+#include "File.hpp"
+#include "File_reader.hpp"
+#include "File_writer.hpp"
+#include "Directory_reader.hpp"
+#include "Directory_walker.hpp"
+#include "Hash.hpp"
+#include "Thread_pool.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+
+using std::string;
+using std::string_view;
+
+namespace {
+
+/* the layout of the saved index, in the byte order of the machine */
+struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t count;                 // the number of records
+        uint64_t strings;               // the size of the string table
+        uint32_t root_len;              // the root leads the string table
+        uint32_t record_size;
+};
+
+struct Record {
+        int64_t size;
+        int64_t mtime;
+        uint64_t ino;
+        uint64_t hash;
+        uint64_t path_off;              // into the string table
+        uint16_t path_len;
+        uint16_t flags;
+        uint32_t mode;
+};
+
+static_assert(sizeof(Header) == 32, "unexpected padding in Header");
+static_assert(sizeof(Record) == 48, "unexpected padding in Record");
+
+const char index_magic[4] = {'F', 'I', 'D', 'X'};
+const uint32_t index_version = 1;
+const uint16_t flag_hash = 1;
+
+/* the number of files a task stats or hashes */
+const std::size_t stat_chunk = 64;
+
+}
+
+/**
+ * @brief Fill an entry from the metadata of its file
+ *
+ * @param e The entry
+ * @param st The metadata
+ */
+static void assign(File_index::Entry &e, const File::Status &st)
+{
+        e.size = st.size;
+        e.mtime = static_cast<long long>(st.mtime) * 1000000000LL +
+                st.mtime_nsec;
+        e.ino = st.ino;
+        e.mode = st.mode;
+}
+
+/**
+ * @brief Tell if an entry differs from the metadata of its file
+ *
+ * @param e The entry
+ * @param st The metadata
+ *
+ * @return True if the size, mtime or inode changed, false otherwise
+ */
+static bool differs(const File_index::Entry &e, const File::Status &st)
+{
+        File_index::Entry now;
+        assign(now, st);
+        return now.size != e.size || now.mtime != e.mtime ||
+                now.ino != e.ino;
+}
+
+/**
+ * @brief Get the metadata of many files in parallel, symbolic links not
+ *        followed
+ *
+ * @param pathnames The pathnames
+ * @param st The vector to store the metadata, in the same order
+ * @param threads The number of threads, 0 means one per core
+ */
+static void lstat_all(const std::vector<string> &pathnames,
+                std::vector<File::Status> &st, unsigned int threads)
+{
+        st.resize(pathnames.size());
+        auto run = [&pathnames, &st](std::size_t i, std::size_t end) {
+                for (; i < end; ++i)
+                        st[i] = File::status_at(AT_FDCWD, pathnames[i],
+                                        false);
+        };
+        if (pathnames.size() <= stat_chunk) {
+                run(0, pathnames.size());
+                return;
+        }
+        Thread_pool pool(threads);
+        for (std::size_t i = 0; i < pathnames.size(); i += stat_chunk)
+                pool.submit([&run, &pathnames, i] {
+                        run(i, std::min(i + stat_chunk, pathnames.size()));
+                });
+        pool.wait();
+}
+
+/**
+ * @brief Tell if @path is @dir itself or under it
+ *
+ * @param path The path relative to the root
+ * @param dir The directory relative to the root, "" for the root
+ *
+ * @return True if it is, false otherwise
+ */
+static bool under(string_view path, string_view dir)
+{
+        if (dir.empty())
+                return true;
+        return path.compare(0, dir.size(), dir) == 0 &&
+                (path.size() == dir.size() || path[dir.size()] == '/');
+}
+
+/**
+ * @brief Tell if a path or one of its parents is in @gone
+ *
+ * @param gone The paths removed
+ * @param path The path relative to the root
+ *
+ * @return True if it is, false otherwise
+ */
+static bool dropped(const std::set<string> &gone, const string &path)
+{
+        if (gone.empty())
+                return false;
+        for (auto pos = path.find('/'); pos != string::npos;
+                        pos = path.find('/', pos + 1))
+                if (gone.count(path.substr(0, pos)))
+                        return true;
+        return gone.count(path) > 0;
+}
+
+File_index::File_index(): opt_(Options{})
+{
+}
+
+File_index::File_index(const Options &opt): opt_(opt)
+{
+}
+
+bool File_index::build(const string &root)
+{
+        root_.clear();
+        entries_.clear();
+        File::Status st = File::status(root);
+        if (!st.is_directory())
+                return false;
+        root_ = root;
+        Entry top;
+        assign(top, st);
+        std::vector<Entry> out{top};
+        if (!scan("", out)) {
+                root_.clear();
+                return false;
+        }
+        std::sort(out.begin(), out.end(), [](const Entry &a,
+                                const Entry &b) {
+                return a.path < b.path;
+        });
+        entries_ = std::move(out);
+        if (opt_.hash) {
+                std::vector<Entry *> files;
+                for (auto &e : entries_)
+                        if (e.is_file())
+                                files.push_back(&e);
+                hash(files);
+        }
+        return true;
+}
+
+bool File_index::refresh(std::vector<Change> &changes)
+{
+        changes.clear();
+        if (root_.empty() || entries_.empty())
+                return false;
+
+        /* only the directories are asked, the files follow their parent */
+        std::vector<std::size_t> dirs;
+        std::vector<string> pathnames;
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+                if (entries_[i].is_directory()) {
+                        dirs.push_back(i);
+                        pathnames.push_back(full_path(entries_[i].path));
+                }
+        }
+        std::vector<File::Status> st;
+        lstat_all(pathnames, st, opt_.threads);
+        /* the root itself may be a link, as given to build() */
+        st[0] = File::status(root_);
+        if (!st[0].is_directory())
+                return false;
+
+        /* the parents come first, the directories they drop are skipped */
+        std::set<string> gone;
+        std::vector<Entry> added;
+        for (std::size_t k = 0; k < dirs.size(); ++k) {
+                const Entry &e = entries_[dirs[k]];
+                if (!st[k].is_directory() || !differs(e, st[k]))
+                        continue;
+                if (dropped(gone, e.path))
+                        continue;
+                reread(dirs[k], gone, added, changes);
+        }
+
+        if (opt_.deep) {
+                std::vector<std::size_t> files;
+                pathnames.clear();
+                for (std::size_t i = 0; i < entries_.size(); ++i) {
+                        if (!entries_[i].is_directory() &&
+                                        !dropped(gone, entries_[i].path)) {
+                                files.push_back(i);
+                                pathnames.push_back(
+                                                full_path(entries_[i].path));
+                        }
+                }
+                lstat_all(pathnames, st, opt_.threads);
+                for (std::size_t k = 0; k < files.size(); ++k) {
+                        Entry &e = entries_[files[k]];
+                        if (!st[k].exists || !differs(e, st[k]))
+                                continue;
+                        if ((st[k].mode & S_IFMT) != (e.mode & S_IFMT)) {
+                                gone.insert(e.path);
+                                Entry n;
+                                n.path = e.path;
+                                assign(n, st[k]);
+                                added.push_back(std::move(n));
+                                if (st[k].is_directory())
+                                        scan(e.path, added);
+                                continue;
+                        }
+                        assign(e, st[k]);
+                        e.has_hash = false;
+                        changes.push_back(Change{modified, e.path});
+                }
+        }
+
+        /* a dropped directory takes everything under it along */
+        if (!gone.empty()) {
+                std::vector<bool> drop(entries_.size(), false);
+                auto less = [](const Entry &e, const string &s) {
+                        return e.path < s;
+                };
+                for (const auto &g : gone) {
+                        auto it = std::lower_bound(entries_.begin(),
+                                        entries_.end(), g, less);
+                        if (it != entries_.end() && it->path == g)
+                                drop[it - entries_.begin()] = true;
+                        string prefix = g + "/";
+                        for (it = std::lower_bound(it, entries_.end(),
+                                                prefix, less);
+                                        it != entries_.end() &&
+                                        under(it->path, g); ++it)
+                                drop[it - entries_.begin()] = true;
+                }
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < entries_.size(); ++i) {
+                        if (drop[i])
+                                changes.push_back(Change{removed,
+                                                entries_[i].path});
+                        else if (n++ != i)
+                                entries_[n - 1] = std::move(entries_[i]);
+                }
+                entries_.resize(n);
+        }
+
+        if (!added.empty()) {
+                auto by_path = [](const Entry &a, const Entry &b) {
+                        return a.path < b.path;
+                };
+                std::sort(added.begin(), added.end(), by_path);
+                for (const auto &e : added)
+                        changes.push_back(Change{File_index::added, e.path});
+                std::size_t mid = entries_.size();
+                std::move(added.begin(), added.end(),
+                                std::back_inserter(entries_));
+                std::inplace_merge(entries_.begin(), entries_.begin() + mid,
+                                entries_.end(), by_path);
+        }
+
+        if (opt_.hash) {
+                std::vector<Entry *> files;
+                for (auto &e : entries_)
+                        if (e.is_file() && !e.has_hash)
+                                files.push_back(&e);
+                hash(files);
+        }
+
+        /* a path replaced by another type is removed before it's added */
+        std::stable_sort(changes.begin(), changes.end(), [](const Change &a,
+                                const Change &b) {
+                return a.path < b.path;
+        });
+        return true;
+}
+
+bool File_index::save(const string &pathname) const
+{
+        if (root_.empty())
+                return false;
+        Header h;
+        std::memcpy(h.magic, index_magic, sizeof(h.magic));
+        h.version = index_version;
+        h.count = entries_.size();
+        h.root_len = static_cast<uint32_t>(root_.size());
+        h.record_size = sizeof(Record);
+        h.strings = root_.size();
+        for (const auto &e : entries_)
+                h.strings += e.path.size();
+
+        string buf;
+        buf.reserve(sizeof(h) + entries_.size() * sizeof(Record) +
+                        h.strings);
+        buf.append(reinterpret_cast<const char *>(&h), sizeof(h));
+        uint64_t off = root_.size();
+        for (const auto &e : entries_) {
+                Record r;
+                r.size = e.size;
+                r.mtime = e.mtime;
+                r.ino = e.ino;
+                r.hash = e.hash;
+                r.path_off = off;
+                r.path_len = static_cast<uint16_t>(e.path.size());
+                r.flags = e.has_hash ? flag_hash : 0;
+                r.mode = e.mode;
+                buf.append(reinterpret_cast<const char *>(&r), sizeof(r));
+                off += e.path.size();
+        }
+        buf.append(root_);
+        for (const auto &e : entries_)
+                buf.append(e.path);
+
+        /* written aside and renamed over, a reader never sees half of it */
+        string tmp = pathname + ".tmp";
+        File::remove(tmp);
+        File_writer fw(tmp);
+        if (!fw.ready())
+                return false;
+        bool state = fw.write(buf) == buf.size();
+        state = fw.close() && state;
+        if (!state || !File::move(tmp, pathname)) {
+                File::remove(tmp);
+                return false;
+        }
+        return true;
+}
+
+bool File_index::load(const string &pathname)
+{
+        File_reader reader(pathname);
+        if (!reader.ready())
+                return false;
+        std::size_t len = 0;
+        const char *p = reader.map(len);
+        if (!p || len < sizeof(Header))
+                return false;
+        Header h;
+        std::memcpy(&h, p, sizeof(h));
+        if (std::memcmp(h.magic, index_magic, sizeof(h.magic)) != 0 ||
+                        h.version != index_version ||
+                        h.record_size != sizeof(Record) || h.count == 0 ||
+                        h.count > (len - sizeof(h)) / sizeof(Record) ||
+                        len - sizeof(h) - h.count * sizeof(Record) !=
+                        h.strings || h.root_len == 0 ||
+                        h.root_len > h.strings)
+                return false;
+
+        const char *records = p + sizeof(h);
+        const char *strings = records + h.count * sizeof(Record);
+        std::vector<Entry> entries(h.count);
+        for (std::size_t i = 0; i < h.count; ++i) {
+                Record r;
+                std::memcpy(&r, records + i * sizeof(Record), sizeof(r));
+                if (r.path_off > h.strings ||
+                                r.path_len > h.strings - r.path_off)
+                        return false;
+                Entry &e = entries[i];
+                e.path.assign(strings + r.path_off, r.path_len);
+                if (i > 0 && !(entries[i - 1].path < e.path))
+                        return false;
+                e.size = r.size;
+                e.mtime = r.mtime;
+                e.ino = r.ino;
+                e.hash = r.hash;
+                e.mode = r.mode;
+                e.has_hash = (r.flags & flag_hash) != 0;
+        }
+        if (!entries[0].path.empty() || !entries[0].is_directory())
+                return false;
+        root_.assign(strings, h.root_len);
+        entries_ = std::move(entries);
+        return true;
+}
+
+const File_index::Entry *File_index::find(string_view path) const
+{
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), path,
+                        [](const Entry &e, string_view s) {
+                                return string_view{e.path} < s;
+                        });
+        if (it == entries_.end() || it->path != path)
+                return nullptr;
+        return &*it;
+}
+
+string File_index::full_path(string_view path) const
+{
+        string s = root_;
+        if (path.empty())
+                return s;
+        if (s.empty() || s.back() != '/')
+                s += '/';
+        s.append(path);
+        return s;
+}
+
+bool File_index::scan(const string &dir, std::vector<Entry> &out) const
+{
+        string top = full_path(dir);
+        /* the walker puts a separator after the root unless it ends one */
+        auto skip = top.size();
+        if (top.empty() || top.back() != '/')
+                ++skip;
+        string prefix = dir.empty() ? dir : dir + "/";
+
+        Directory_walker::Options wopt;
+        wopt.threads = opt_.threads;
+        Directory_walker walker(wopt);
+        std::mutex mtx;
+        return walker.walk(top, [&](const Directory_walker::Entry &we) {
+                File::Status st = File::status_at(we.dirfd, string{we.name},
+                                false);
+                if (!st.exists)
+                        return;
+                Entry e;
+                e.path = prefix;
+                e.path.append(we.path.substr(skip));
+                assign(e, st);
+                std::lock_guard<std::mutex> lk(mtx);
+                out.push_back(std::move(e));
+        });
+}
+
+void File_index::reread(std::size_t dir, std::set<string> &gone,
+                std::vector<Entry> &added, std::vector<Change> &changes)
+{
+        const string path = entries_[dir].path;
+        const string top = full_path(path);
+        const string prefix = path.empty() ? path : path + "/";
+        Directory_reader reader(top);
+        if (!reader.ready())
+                return;
+        File::Status self = File::status_at(AT_FDCWD, top, path.empty());
+        if (!self.is_directory())
+                return;
+        assign(entries_[dir], self);
+
+        /* the children indexed now, by name; siblings such as "a.txt" sort
+           between "a" and "a/x", so they start at the prefix */
+        std::size_t first = dir + 1;
+        if (!path.empty())
+                first = std::lower_bound(entries_.begin() + first,
+                                entries_.end(), prefix,
+                                [](const Entry &e, const string &s) {
+                                        return e.path < s;
+                                }) - entries_.begin();
+        std::map<string_view, std::size_t> known;
+        for (std::size_t i = first; i < entries_.size() &&
+                        under(entries_[i].path, path); ++i) {
+                string_view name{entries_[i].path};
+                name.remove_prefix(prefix.size());
+                if (!name.empty() && name.find('/') == string_view::npos)
+                        known.emplace(name, i);
+        }
+
+        std::set<string_view> seen;
+        std::vector<string> names;
+        Directory_reader::Entry de;
+        while (reader.next(de))
+                names.emplace_back(de.name);
+        for (const auto &name : names) {
+                string child = prefix + name;
+                File::Status st = File::status_at(AT_FDCWD, top + "/" + name,
+                                false);
+                if (!st.exists)
+                        continue;
+                auto it = known.find(name);
+                if (it != known.end()) {
+                        seen.insert(it->first);
+                        Entry &e = entries_[it->second];
+                        bool same_type = (st.mode & S_IFMT) ==
+                                (e.mode & S_IFMT);
+                        /* a directory keeps its own mtime to be compared */
+                        if (same_type && e.is_directory() && e.ino == st.ino)
+                                continue;
+                        if (same_type && !e.is_directory()) {
+                                if (differs(e, st)) {
+                                        assign(e, st);
+                                        e.has_hash = false;
+                                        changes.push_back(Change{modified,
+                                                        child});
+                                }
+                                continue;
+                        }
+                        gone.insert(child);
+                }
+                Entry e;
+                e.path = child;
+                assign(e, st);
+                added.push_back(std::move(e));
+                if (st.is_directory())
+                        scan(child, added);
+        }
+        for (const auto &k : known)
+                if (!seen.count(k.first))
+                        gone.insert(entries_[k.second].path);
+}
+
+void File_index::hash(std::vector<Entry *> &entries) const
+{
+        if (entries.empty())
+                return;
+        Thread_pool pool(opt_.threads);
+        for (std::size_t i = 0; i < entries.size(); i += stat_chunk) {
+                std::size_t end = std::min(i + stat_chunk, entries.size());
+                pool.submit([this, &entries, i, end] {
+                        for (std::size_t j = i; j < end; ++j) {
+                                Entry &e = *entries[j];
+                                File_reader reader(full_path(e.path));
+                                if (!reader.ready())
+                                        continue;
+                                std::size_t len = 0;
+                                const char *p = reader.map(len);
+                                if (p) {
+                                        e.hash = Xxh64::hash(p, len);
+                                } else {
+                                        /* empty, or cannot be mapped */
+                                        Xxh64 h;
+                                        char buf[64 * 1024];
+                                        std::size_t n;
+                                        while ((n = reader.read(buf,
+                                                                sizeof(buf)))
+                                                        > 0)
+                                                h.update(buf, n);
+                                        e.hash = h.digest();
+                                }
+                                e.has_hash = true;
+                        }
+                });
+        }
+        pool.wait();
+}
+
+#endif
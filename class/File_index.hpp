@@ -0,0 +1,211 @@
+/**
+ * File_index.hpp - a persistent index of a directory tree, refreshed by
+ *                  re-reading only the directories that changed (Unix only)
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 02:48:10
+ */
+
+#ifndef FILE_INDEX_HPP_
+#define FILE_INDEX_HPP_
+
+#if defined(__unix__)
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <cstdint>
+#include <cstddef>
+#include <sys/stat.h>
+
+/*
+ * Creating, removing or renaming an entry changes the mtime of the
+ * directory holding it, so a refresh stats the directories only and reads
+ * again the ones whose mtime or inode changed. Writing to a file leaves its
+ * directory alone, which only the deep refresh sees, by stating the files
+ * too.
+ *
+ * The saved index is a header, an array of fixed-size records sorted by
+ * path and the string table of the paths, so it can be mapped and searched
+ * as it is.
+ */
+class File_index {
+public:
+        struct Entry {
+                std::string path;               // relative, "" for the root
+                long long size{0};
+                long long mtime{0};             // in nanoseconds
+                unsigned long long ino{0};
+                uint64_t hash{0};               // of the contents
+                unsigned int mode{0};           // file type and permission
+                bool has_hash{false};           // whether @hash is filled
+
+                bool is_file() const;
+                bool is_directory() const;
+        };
+
+        enum Change_kind : unsigned char {
+                added,
+                removed,
+                modified
+        };
+
+        struct Change {
+                Change_kind kind;
+                std::string path;               // relative to the root
+        };
+
+        struct Options {
+                unsigned int threads{0};        // 0 means one per core
+                bool deep{false};               // stat the files on refresh
+                bool hash{false};               // hash the file contents
+        };
+
+private:
+        std::string root_{""};
+        Options opt_;
+        std::vector<Entry> entries_;            // sorted by path
+
+public:
+        File_index(const File_index &) = delete;
+        File_index &operator=(const File_index &) = delete;
+        ~File_index() = default;
+
+        /**
+         * @brief Create an empty File_index with the default options
+         */
+        File_index();
+
+        /**
+         * @brief Create an empty File_index with the given options
+         *
+         * @param opt The options
+         */
+        explicit File_index(const Options &opt);
+
+        /**
+         * @brief Index a directory tree from scratch, walked in parallel,
+         *        symbolic links are indexed but not followed
+         *
+         * @param root The root directory
+         *
+         * @return True if succeeded and false if @root could not be read
+         */
+        bool build(const std::string &root);
+
+        /**
+         * @brief Bring the index up to date with the tree
+         *
+         * @param changes The vector to store the changes, sorted by path
+         *
+         * @return True if succeeded and false if the root is gone or nothing
+         *         is indexed
+         */
+        bool refresh(std::vector<Change> &changes);
+
+        /**
+         * @brief Write the index to a file, replacing it at once
+         *
+         * @param pathname The pathname of the index file
+         *
+         * @return True if succeeded and false if failed
+         */
+        bool save(const std::string &pathname) const;
+
+        /**
+         * @brief Read an index written by save()
+         *
+         * @param pathname The pathname of the index file
+         *
+         * @return True if succeeded and false if it could not be read or is
+         *         not a valid index
+         */
+        bool load(const std::string &pathname);
+
+        /**
+         * @brief Look up an entry
+         *
+         * @param path The path relative to the root
+         *
+         * @return The entry, nullptr if not indexed
+         */
+        const Entry *find(std::string_view path) const;
+
+        /**
+         * @brief Get all entries
+         *
+         * @return The entries sorted by path, the root first
+         */
+        const std::vector<Entry> &entries() const;
+
+        /**
+         * @brief Get the indexed directory
+         *
+         * @return The root directory, empty if nothing is indexed
+         */
+        const std::string &root() const;
+
+private:
+        /**
+         * @brief Get the full pathname of an indexed path
+         *
+         * @param path The path relative to the root
+         *
+         * @return The pathname
+         */
+        std::string full_path(std::string_view path) const;
+
+        /**
+         * @brief Index every entry under a directory into @out
+         *
+         * @param dir The path of the directory relative to the root
+         * @param out The vector to append the entries to
+         *
+         * @return True if succeeded and false if @dir could not be read
+         */
+        bool scan(const std::string &dir, std::vector<Entry> &out) const;
+
+        /**
+         * @brief Re-read a changed directory, recording what differs
+         *
+         * @param dir The index of the directory entry
+         * @param gone The set to add the removed paths to
+         * @param added The vector to append the new entries to
+         * @param changes The vector to append the modifications to
+         */
+        void reread(std::size_t dir, std::set<std::string> &gone,
+                        std::vector<Entry> &added,
+                        std::vector<Change> &changes);
+
+        /**
+         * @brief Hash the contents of the given entries in parallel
+         *
+         * @param entries The entries of the regular files
+         */
+        void hash(std::vector<Entry *> &entries) const;
+};
+
+inline bool File_index::Entry::is_file() const
+{
+        return (mode & S_IFMT) == S_IFREG;
+}
+
+inline bool File_index::Entry::is_directory() const
+{
+        return (mode & S_IFMT) == S_IFDIR;
+}
+
+inline const std::vector<File_index::Entry> &File_index::entries() const
+{
+        return entries_;
+}
+
+inline const std::string &File_index::root() const
+{
+        return root_;
+}
+
+#endif
+
+#endif
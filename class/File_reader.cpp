@@ -2,7 +2,7 @@
  * File_reader.cpp - offer the multi-platform basic file read operation
  *
  * Created by Haoyuan Li on 2021/08/18
- * Last Modified: 2021/08/26 12:52:58
+ * Last Modified: 2026/10/20 09:40:12
  */
 
 #include "File_reader.hpp"
@@ -10,11 +10,14 @@
 
 #include <string>
 #include <cstdio>
+#include <cerrno>
 #include <cstdlib>
 
 #if defined(__unix__)
 
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #elif defined(_MSC_VER)
 
@@ -55,13 +58,17 @@ bool File_reader::close()
         bool state = false;
         if (!ready())
                 return state;
+        unmap();
         lock();
 #if defined(__unix__)
         if (unlock() && ::close(fd_) == 0 && fclose(fp_) == 0)
                 state = true;
+        fd_ = -1;
+        fp_ = nullptr;
 #elif defined(_MSC_VER)
         if (unlock() && CloseHandle(h_file_))
                 state = true;
+        h_file_ = INVALID_HANDLE_VALUE;
 #endif
         return state;
 }
@@ -78,36 +85,15 @@ long long File_reader::skip(const long long &n)
 
 int File_reader::read()
 {
-        int c;
-        lock();
-#if defined(__unix__)
-        if ((c = fgetc(fp_)) == EOF)
-                c = -1;
-#elif defined(_MSC_VER)
-        DWORD n;
-        if (!ReadFile(h_file_, &c, 1, &n, nullptr))
-                c = -1;
-#endif
-        unlock();
-        return c;
+        unsigned char c;
+        return read_range(reinterpret_cast<char *>(&c), 1) == 1 ? c : -1;
 }
 
 size_t File_reader::read(string &s, const size_t &len)
 {
-        lock();
-        char *buf = new char[len + 1];
-        size_t ret = 0;
-#if defined(__unix__)
-        ret = fread(buf, sizeof(char), len, fp_);
-#elif defined(_MSC_VER)
-        DWORD n = 0;
-        if (ReadFile(h_file_, buf, static_cast<DWORD>(len), &n, nullptr))
-                ret = n;
-#endif
-        buf[ret] = '\0';
-        s = buf;
-        delete [] buf;
-        unlock();
+        s.resize(len);
+        size_t ret = read_range(&s[0], len);
+        s.resize(ret);
         return ret;
 }
 
@@ -132,3 +118,92 @@ bool File_reader::reset_pos()
         unlock();
         return state;
 }
+
+size_t File_reader::read(void *buf, const size_t &len)
+{
+        return read_range(static_cast<char *>(buf), len);
+}
+
+size_t File_reader::read_range(char *buf, const size_t &len)
+{
+        if (len == 0)
+                return 0;
+        long long pos = file_tell();
+        if (pos == -1 || !lock(pos, len))
+                return 0;
+        size_t ret = 0;
+#if defined(__unix__)
+        /* no read-ahead past the locked range, fp_ only keeps the offset */
+        while (ret < len) {
+                ssize_t n = pread(fd_, buf + ret, len - ret, pos + ret);
+                if (n < 0 && errno == EINTR)
+                        continue;
+                if (n <= 0)
+                        break;
+                ret += n;
+        }
+        file_seek(pos + ret, FILE_BEGIN);
+#elif defined(_MSC_VER)
+        DWORD n = 0;
+        if (ReadFile(h_file_, buf, static_cast<DWORD>(len), &n, nullptr))
+                ret = n;
+#endif
+        unlock(pos, len);
+        return ret;
+}
+
+const char *File_reader::map(std::size_t &len)
+{
+        len = 0;
+        if (!ready())
+                return nullptr;
+        if (map_) {
+                len = map_len_;
+                return map_;
+        }
+#if defined(__unix__)
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || st.st_size <= 0)
+                return nullptr;
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED)
+                return nullptr;
+        /* the callers mostly stream through the whole file once */
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        map_ = static_cast<const char *>(p);
+        map_len_ = st.st_size;
+#elif defined(_MSC_VER)
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(h_file_, &size) || size.QuadPart <= 0)
+                return nullptr;
+        h_map_ = CreateFileMapping(h_file_, nullptr, PAGE_READONLY, 0, 0,
+                        nullptr);
+        if (!h_map_)
+                return nullptr;
+        map_ = static_cast<const char *>(MapViewOfFile(h_map_, FILE_MAP_READ,
+                                0, 0, 0));
+        if (!map_) {
+                CloseHandle(h_map_);
+                h_map_ = nullptr;
+                return nullptr;
+        }
+        map_len_ = static_cast<std::size_t>(size.QuadPart);
+#endif
+        len = map_len_;
+        return map_;
+}
+
+void File_reader::unmap()
+{
+        if (!map_)
+                return;
+#if defined(__unix__)
+        munmap(const_cast<char *>(map_), map_len_);
+#elif defined(_MSC_VER)
+        UnmapViewOfFile(map_);
+        CloseHandle(h_map_);
+        h_map_ = nullptr;
+#endif
+        map_ = nullptr;
+        map_len_ = 0;
+}
@@ -2,7 +2,7 @@
  * File_reader.hpp - offer the multi-platform basic file read operation
  *
  * Created by Haoyuan Li on 2021/08/17
- * Last Modified: 2021/08/26 09:52:50
+ * Last Modified: 2026/10/20 09:40:12
  */
 
 #ifndef FILE_READER_H_
@@ -12,11 +12,12 @@
 
 #include <string>
 #include <cstdio>
+#include <cstddef>
 
 #if defined(__unix__)
 
 #include <unistd.h>
-#include <sys/file.h>
+#include <fcntl.h>
 
 #define FILE_BEGIN SEEK_SET
 #define FILE_CURRENT SEEK_CUR
@@ -32,11 +33,14 @@ class File_reader {
 private:
 #if defined(__unix__)
         int fd_ = -1;
-        FILE *fp_ = nullptr;
+        FILE *fp_ = nullptr;    // keeps the file offset, reads go to fd_
 #elif defined(_MSC_VER)
         HANDLE h_file_{INVALID_HANDLE_VALUE};
         OVERLAPPED overlapped_{0};
+        HANDLE h_map_{nullptr};
 #endif
+        const char *map_{nullptr};      // the mapping from map()
+        std::size_t map_len_{0};
 
 public:
         File_reader() = default;
@@ -132,6 +136,39 @@ public:
          */
         size_t read(std::string &s, const size_t &off, const size_t &len);
 
+        /**
+         * @brief Read bytes into a buffer, binary data included, while
+         *        reading from a file, other read requests are allowed but
+         *        other write requests will be blocked
+         *
+         * @param buf The buffer used to store the bytes read
+         * @param len Maximum number of bytes to read
+         *
+         * @return The total number of bytes successfully read
+         */
+        size_t read(void *buf, const size_t &len);
+
+        /**
+         * @brief Map the whole file into memory for reading, the pages are
+         *        read in as they are touched, the mapping stays until
+         *        unmap() or close()
+         *
+         * @param len Set to the size of the mapping
+         *
+         * @return The first byte of the file, nullptr if failed or the file
+         *         is empty
+         *
+         * @sa unmap()
+         */
+        const char *map(std::size_t &len);
+
+        /**
+         * @brief Remove the mapping made by map()
+         *
+         * @sa map()
+         */
+        void unmap();
+
         /**
          * @brief Reset the postion indicator associated with the file stream
          *
@@ -157,18 +194,32 @@ private:
         void do_open(const std::string &pathname);
 
         /**
-         * @brief Lock the file
+         * @brief Put a shared lock on a byte range of the file, readers of
+         *        the range are allowed but writers of it will be blocked
+         *
+         * @param offset The first byte of the range
+         * @param len The length of the range, 0 means up to the end of the
+         *        file however it grows
          *
          * @return True if lock successfully, false otherwise
+         *
+         * @sa unlock()
          */
-        bool lock();
+        bool lock(const long long &offset = 0, const long long &len = 0);
 
         /**
-         * @brief Unlock the file
+         * @brief Unlock a byte range of the file, the range should be the
+         *        same as the one passed to lock()
+         *
+         * @param offset The first byte of the range
+         * @param len The length of the range, 0 means up to the end of the
+         *        file however it grows
          *
          * @return True if unlock successfully, false otherwise
+         *
+         * @sa lock()
          */
-        bool unlock();
+        bool unlock(const long long &offset = 0, const long long &len = 0);
 
         /**
          * @brief Set read/write file offset
@@ -182,6 +233,27 @@ private:
          *         beginning of the file when succeeded, -1 otherwise
          */
         long long file_seek(const long long &offset, const int &origin);
+
+        /**
+         * @brief Read into a buffer from the file offset, holding a shared
+         *        lock on the range until the bytes are copied out
+         *
+         * @param buf The buffer used to store the bytes read
+         * @param len Maximum number of bytes to read, nothing is locked if
+         *        it is 0
+         *
+         * @return The total number of bytes successfully read
+         */
+        size_t read_range(char *buf, const size_t &len);
+
+        /**
+         * @brief Get the current file offset without dropping the stream
+         *        buffer
+         *
+         * @return The offset in bytes from the beginning of the file when
+         *         succeeded, -1 otherwise
+         */
+        long long file_tell();
 };
 
 inline bool File_reader::ready()
@@ -198,6 +270,8 @@ inline void File_reader::do_open(const std::string &pathname)
 #if defined(__unix__)
         fd_ = ::open(pathname.c_str(), O_RDONLY);
         fp_ = fopen(pathname.c_str(), "r");
+        if (fp_)
+                setvbuf(fp_, nullptr, _IONBF, 0);
 #elif defined(_MSC_VER)
         h_file_ = CreateFile(pathname.c_str(),
                         GENERIC_READ,
@@ -209,22 +283,51 @@ inline void File_reader::do_open(const std::string &pathname)
 #endif
 }
 
-inline bool File_reader::lock()
+inline bool File_reader::lock(const long long &offset, const long long &len)
 {
 #if defined(__unix__)
-        return flock(fd_, LOCK_SH) == 0;
+        struct flock fl{};
+        fl.l_type = F_RDLCK;
+        fl.l_whence = SEEK_SET;
+        fl.l_start = offset;
+        fl.l_len = len;
+        /* OFD locks belong to the open file description like flock() did,
+         * so they are not dropped when some other fd of the file closes */
+#if defined(F_OFD_SETLKW)
+        return fcntl(fd_, F_OFD_SETLKW, &fl) == 0;
+#else
+        return fcntl(fd_, F_SETLKW, &fl) == 0;
+#endif
 #elif defined(_MSC_VER)
+        ULARGE_INTEGER l;
+        l.QuadPart = (len == 0) ? MAXULONGLONG : len;
+        overlapped_.Offset = static_cast<DWORD>(offset);
+        overlapped_.OffsetHigh = static_cast<DWORD>(offset >> 32);
         return LockFileEx(h_file_, 0, 0,
-                        MAXDWORD, MAXDWORD, &overlapped_);
+                        l.LowPart, l.HighPart, &overlapped_);
 #endif
 }
 
-inline bool File_reader::unlock()
+inline bool File_reader::unlock(const long long &offset,
+                const long long &len)
 {
 #if defined(__unix__)
-        return flock(fd_, LOCK_UN) == 0;
+        struct flock fl{};
+        fl.l_type = F_UNLCK;
+        fl.l_whence = SEEK_SET;
+        fl.l_start = offset;
+        fl.l_len = len;
+#if defined(F_OFD_SETLK)
+        return fcntl(fd_, F_OFD_SETLK, &fl) == 0;
+#else
+        return fcntl(fd_, F_SETLK, &fl) == 0;
+#endif
 #elif defined(_MSC_VER)
-        return UnlockFileEx(h_file_, 0, MAXDWORD, MAXDWORD, &overlapped_);
+        ULARGE_INTEGER l;
+        l.QuadPart = (len == 0) ? MAXULONGLONG : len;
+        overlapped_.Offset = static_cast<DWORD>(offset);
+        overlapped_.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        return UnlockFileEx(h_file_, 0, l.LowPart, l.HighPart, &overlapped_);
 #endif
 }
 
@@ -247,4 +350,13 @@ inline long long File_reader::file_seek(const long long &offset,
         return pos;
 }
 
+inline long long File_reader::file_tell()
+{
+#if defined(__unix__)
+        return ftell(fp_);
+#elif defined(_MSC_VER)
+        return file_seek(0, FILE_CURRENT);
+#endif
+}
+
 #endif
@@ -0,0 +1,414 @@
+/**
+ * File_tree.cpp - the File queries over whole directory trees (Unix only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 02:06:55
+ */
+
+#if defined(__unix__)
+
+#include "File.hpp"
+#include "Directory_walker.hpp"
+#include "Glob.hpp"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(STATX_BASIC_STATS)
+#define USAGE_MASK (STATX_TYPE | STATX_NLINK | STATX_INO | STATX_SIZE | \
+                STATX_BLOCKS)
+#else
+#define USAGE_MASK 0
+#endif
+
+using std::string;
+
+/* the buffer size for copying without copy_file_range() */
+static const std::size_t copy_buffer_size = 128 * 1024;
+
+/* the usage under a directory, summed up by its entries in parallel */
+struct Tree_usage {
+        std::atomic<long long> size{0};
+        std::atomic<long long> disk{0};
+        std::atomic<unsigned long long> files{0};
+        std::atomic<unsigned long long> dirs{0};
+
+        void add(const File::Usage &u)
+        {
+                size += u.size;
+                disk += u.disk;
+                files += u.files;
+                dirs += u.dirs;
+        }
+
+        File::Usage get() const
+        {
+                return File::Usage{size, disk, files, dirs};
+        }
+};
+
+bool File::disk_usage(const string &pathname, Usage &usage)
+{
+        return disk_usage(pathname, usage, Usage_options{});
+}
+
+bool File::disk_usage(const string &pathname, Usage &usage,
+                const Usage_options &opt, const Usage_progress &progress)
+{
+        usage = Usage{};
+        Status st;
+        if (!query_status(AT_FDCWD, pathname.c_str(), 0, st, USAGE_MASK))
+                return false;
+        if (!st.is_directory()) {
+                usage = Usage{st.size, st.blocks * 512, 1, 0};
+                return true;
+        }
+
+        Directory_walker::Options wopt;
+        wopt.threads = opt.threads;
+        wopt.one_file_system = opt.one_file_system;
+        Directory_walker walker(wopt);
+
+        std::mutex links_mtx;
+        std::set<std::pair<unsigned long long, unsigned long long>> links;
+
+        /* a directory counts itself, and its files count into it */
+        walker.set_hooks([](const Directory_walker::Entry &e) -> void * {
+                auto *tree = new Tree_usage;
+                Status s;
+                /* the names end the paths, so they're null-terminated */
+                if (query_status(e.dirfd, e.name.data(), e.depth ?
+                                        AT_SYMLINK_NOFOLLOW : 0, s,
+                                        USAGE_MASK))
+                        tree->add(Usage{s.size, s.blocks * 512, 0, 1});
+                return tree;
+        }, [&](const Directory_walker::Entry &e, void *data) {
+                auto *tree = static_cast<Tree_usage *>(data);
+                Usage u = tree->get();
+                delete tree;
+                auto *parent = static_cast<Tree_usage *>(e.parent_data);
+                if (parent)
+                        parent->add(u);
+                else
+                        usage = u;
+                if (progress)
+                        progress(string{e.path}, u);
+        });
+
+        bool state = walker.walk(pathname, [&](
+                                const Directory_walker::Entry &e) {
+                if (e.type == Directory_reader::directory)
+                        return;
+                Status s;
+                if (!query_status(e.dirfd, e.name.data(), AT_SYMLINK_NOFOLLOW,
+                                        s, USAGE_MASK))
+                        return;
+                if (!opt.count_links && s.nlink > 1) {
+                        std::lock_guard<std::mutex> lk(links_mtx);
+                        if (!links.emplace(s.dev, s.ino).second)
+                                return;
+                }
+                Usage u{s.size, s.blocks * 512, 1, 0};
+                static_cast<Tree_usage *>(e.parent_data)->add(u);
+        });
+        return state;
+}
+
+bool File::glob(const string &root, const string &pattern,
+                std::vector<string> &matches, unsigned int threads)
+{
+        matches.clear();
+        Glob g{pattern};
+        if (!g.valid())
+                return false;
+        Directory_walker::Options opt;
+        opt.threads = threads;
+        Directory_walker walker(opt);
+        g.apply(walker, root);
+
+        std::mutex mtx;
+        bool state = walker.walk(root, [&](const Directory_walker::Entry &e) {
+                std::lock_guard<std::mutex> lk(mtx);
+                matches.emplace_back(e.path);
+        });
+        std::sort(matches.begin(), matches.end());
+        return state;
+}
+
+/* the result of a tree operation, filled from the worker threads */
+struct Tree_state {
+        File::Tree_report &report;
+        const File::Tree_progress &progress;
+        std::mutex mtx;
+        std::atomic<unsigned long long> done{0};
+
+        Tree_state(File::Tree_report &report,
+                        const File::Tree_progress &progress):
+                report(report), progress(progress)
+        {
+                report = File::Tree_report{};
+        }
+
+        void ok(std::string_view path)
+        {
+                unsigned long long n = ++done;
+                if (progress)
+                        progress(path, n);
+        }
+
+        void fail(std::string_view path, int error)
+        {
+                std::lock_guard<std::mutex> lk(mtx);
+                report.errors.push_back(File::Tree_error{string{path},
+                                error});
+        }
+
+        bool finish(bool state)
+        {
+                report.done = done;
+                return state && report.errors.empty();
+        }
+};
+
+bool File::remove_all(const string &pathname)
+{
+        Tree_report report;
+        return remove_all(pathname, report);
+}
+
+bool File::remove_all(const string &pathname, Tree_report &report,
+                unsigned int threads, const Tree_progress &progress)
+{
+        Tree_state ts{report, progress};
+        struct stat st;
+        if (lstat(pathname.c_str(), &st) != 0) {
+                ts.fail(pathname, errno);
+                return ts.finish(false);
+        }
+        if (!S_ISDIR(st.st_mode)) {
+                if (unlink(pathname.c_str()) == 0)
+                        ts.ok(pathname);
+                else
+                        ts.fail(pathname, errno);
+                invalidate_path_cache();
+                return ts.finish(true);
+        }
+
+        Directory_walker::Options opt;
+        opt.threads = threads;
+        Directory_walker walker(opt);
+        walker.set_error_handler([&ts](const string &path, int error) {
+                ts.fail(path, error);
+        });
+        /* a directory goes once everything in it is gone */
+        walker.set_hooks(nullptr, [&ts](const Directory_walker::Entry &e,
+                                void *) {
+                if (unlinkat(e.dirfd, e.name.data(), AT_REMOVEDIR) == 0)
+                        ts.ok(e.path);
+                else
+                        ts.fail(e.path, errno);
+        });
+        bool state = walker.walk(pathname, [&ts](
+                                const Directory_walker::Entry &e) {
+                if (e.type == Directory_reader::directory)
+                        return;
+                if (unlinkat(e.dirfd, e.name.data(), 0) == 0)
+                        ts.ok(e.path);
+                else
+                        ts.fail(e.path, errno);
+        });
+        if (!state)
+                ts.fail(pathname, errno);
+        invalidate_path_cache();
+        return ts.finish(state);
+}
+
+/**
+ * @brief Copy the contents of a regular file
+ *
+ * @return 0 if succeeded, the errno otherwise
+ */
+static int copy_file(int src_dirfd, const char *src, int dest_dirfd,
+                const char *dest, mode_t mode)
+{
+        int in = openat(src_dirfd, src, O_RDONLY | O_CLOEXEC);
+        if (in == -1)
+                return errno;
+        int out = openat(dest_dirfd, dest, O_WRONLY | O_CREAT | O_TRUNC |
+                        O_CLOEXEC, mode & 07777);
+        if (out == -1) {
+                int err = errno;
+                close(in);
+                return err;
+        }
+        int err = 0;
+        bool copied = false;
+#if defined(__linux__)
+        /* let the kernel copy, or even share the extents */
+        for (;;) {
+                ssize_t n = copy_file_range(in, nullptr, out, nullptr,
+                                1 << 30, 0);
+                if (n > 0) {
+                        copied = true;
+                        continue;
+                }
+                if (n == 0) {
+                        copied = true;
+                } else if (copied || (errno != EXDEV && errno != ENOSYS &&
+                                        errno != EINVAL &&
+                                        errno != EOPNOTSUPP)) {
+                        err = errno;
+                        copied = true;
+                }
+                break;
+        }
+#endif
+        if (!copied) {
+                static thread_local std::vector<char> buf(copy_buffer_size);
+                ssize_t n;
+                while ((n = read(in, buf.data(), buf.size())) > 0) {
+                        for (ssize_t off = 0; off < n; ) {
+                                ssize_t w = write(out, buf.data() + off,
+                                                n - off);
+                                if (w < 0) {
+                                        err = errno;
+                                        break;
+                                }
+                                off += w;
+                        }
+                        if (err)
+                                break;
+                }
+                if (n < 0 && !err)
+                        err = errno;
+        }
+        close(in);
+        if (close(out) != 0 && !err)
+                err = errno;
+        return err;
+}
+
+/**
+ * @brief Copy a regular file or a symbolic link
+ *
+ * @return 0 if succeeded, the errno otherwise
+ */
+static int copy_entry(int src_dirfd, const char *src, int dest_dirfd,
+                const char *dest)
+{
+        struct stat st;
+        if (fstatat(src_dirfd, src, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                return errno;
+        if (S_ISREG(st.st_mode))
+                return copy_file(src_dirfd, src, dest_dirfd, dest,
+                                st.st_mode);
+        if (!S_ISLNK(st.st_mode))
+                return ENOTSUP;
+        std::vector<char> target(st.st_size + 1);
+        ssize_t n = readlinkat(src_dirfd, src, target.data(), target.size());
+        if (n < 0)
+                return errno;
+        target[std::min<std::size_t>(n, st.st_size)] = '\0';
+        unlinkat(dest_dirfd, dest, 0);
+        return symlinkat(target.data(), dest_dirfd, dest) == 0 ? 0 : errno;
+}
+
+bool File::copy_all(const string &src, const string &dest)
+{
+        Tree_report report;
+        return copy_all(src, dest, report);
+}
+
+bool File::copy_all(const string &src, const string &dest,
+                Tree_report &report, unsigned int threads,
+                const Tree_progress &progress)
+{
+        Tree_state ts{report, progress};
+        struct stat st;
+        if (stat(src.c_str(), &st) != 0) {
+                ts.fail(src, errno);
+                return ts.finish(false);
+        }
+        if (!S_ISDIR(st.st_mode)) {
+                int err = copy_file(AT_FDCWD, src.c_str(), AT_FDCWD,
+                                dest.c_str(), st.st_mode);
+                if (err)
+                        ts.fail(src, err);
+                else
+                        ts.ok(src);
+                return ts.finish(true);
+        }
+
+        /* the copy of a directory, its entries are created relative to it */
+        struct Copy_dir {
+                int fd;
+                mode_t mode;
+        };
+
+        Directory_walker::Options opt;
+        opt.threads = threads;
+        Directory_walker walker(opt);
+        walker.set_error_handler([&ts](const string &path, int error) {
+                ts.fail(path, error);
+        });
+        walker.set_hooks([&ts, &dest](const Directory_walker::Entry &e)
+                        -> void * {
+                auto *parent = static_cast<Copy_dir *>(e.parent_data);
+                auto *dir = new Copy_dir{-1, 0755};
+                /* the failure of the parent is reported already */
+                if (parent && parent->fd == -1)
+                        return dir;
+                int dirfd = parent ? parent->fd : AT_FDCWD;
+                const char *name = parent ? e.name.data() : dest.c_str();
+                struct stat s;
+                if (fstatat(e.dirfd, e.name.data(), &s, 0) == 0)
+                        dir->mode = s.st_mode & 07777;
+                /* writable until its entries are copied */
+                if (mkdirat(dirfd, name, dir->mode | S_IRWXU) != 0 &&
+                                errno != EEXIST) {
+                        ts.fail(e.path, errno);
+                        return dir;
+                }
+                dir->fd = openat(dirfd, name, O_RDONLY | O_DIRECTORY |
+                                O_CLOEXEC);
+                if (dir->fd == -1)
+                        ts.fail(e.path, errno);
+                else
+                        ts.ok(e.path);
+                return dir;
+        }, [](const Directory_walker::Entry &, void *data) {
+                auto *dir = static_cast<Copy_dir *>(data);
+                if (dir->fd != -1) {
+                        fchmod(dir->fd, dir->mode);
+                        close(dir->fd);
+                }
+                delete dir;
+        });
+        bool state = walker.walk(src, [&ts](const Directory_walker::Entry &e) {
+                if (e.type == Directory_reader::directory)
+                        return;
+                auto *dir = static_cast<Copy_dir *>(e.parent_data);
+                if (dir->fd == -1)
+                        return;
+                int err = copy_entry(e.dirfd, e.name.data(), dir->fd,
+                                e.name.data());
+                if (err)
+                        ts.fail(e.path, err);
+                else
+                        ts.ok(e.path);
+        });
+        if (!state)
+                ts.fail(src, errno);
+        return ts.finish(state);
+}
+
+#endif
@@ -0,0 +1,566 @@
+/**
+ * File_watcher.cpp - watch files and directory trees for changes by inotify
+ *                    and deliver the changes in batches (Linux only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 13:48:12
+ */
+
+#if defined(__linux__)
+
+#include "File_watcher.hpp"
+#include "File.hpp"
+#include "Directory_reader.hpp"
+#include "Path.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+
+using std::string;
+using Clock = std::chrono::steady_clock;
+
+static const uint32_t dir_mask = IN_CREATE | IN_DELETE | IN_MODIFY |
+        IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+        IN_MOVE_SELF | IN_EXCL_UNLINK;
+static const uint32_t file_mask = IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF |
+        IN_MOVE_SELF;
+
+/* a burst that never pauses is still delivered after this many latencies */
+static const int max_hold = 10;
+
+/*
+ * The events of a burst, merged per path while they come in: a file
+ * created and then written is only created, a file created and then removed
+ * is nothing, and a move is one event when both of its halves are seen.
+ */
+struct File_watcher::Batch {
+        struct Move {
+                std::size_t idx;        // the event of the source
+                bool created;           // the source was created in the batch
+        };
+
+        std::vector<Event> events;
+        std::vector<bool> dead;
+        std::unordered_map<string, std::size_t> last;   // live event by path
+        std::unordered_map<uint32_t, Move> moves;       // unpaired by cookie
+
+        bool empty() const
+        {
+                return events.empty();
+        }
+
+        void append(Kind kind, const string &path, bool is_dir)
+        {
+                last[path] = events.size();
+                events.push_back(Event{kind, path, string{}, is_dir});
+                dead.push_back(false);
+        }
+
+        void kill(std::unordered_map<string, std::size_t>::iterator it)
+        {
+                dead[it->second] = true;
+                last.erase(it);
+        }
+
+        void push(Kind kind, const string &path, bool is_dir)
+        {
+                auto it = last.find(path);
+                if (it == last.end()) {
+                        append(kind, path, is_dir);
+                        return;
+                }
+                Event &prev = events[it->second];
+                if (kind == modified && (prev.kind == created ||
+                                        prev.kind == modified))
+                        return;
+                if (kind == removed && prev.kind == created) {
+                        kill(it);
+                } else if (kind == removed && prev.kind == modified) {
+                        kill(it);
+                        append(removed, path, is_dir);
+                } else if (kind == removed && prev.kind == moved) {
+                        /* moved and then removed, the source is removed */
+                        prev.kind = removed;
+                        prev.path = std::move(prev.old_path);
+                        prev.old_path.clear();
+                        last.erase(it);
+                } else {
+                        append(kind, path, is_dir);
+                }
+        }
+
+        void move_from(uint32_t cookie, const string &path, bool is_dir)
+        {
+                auto it = last.find(path);
+                if (it != last.end() && events[it->second].kind == created) {
+                        moves[cookie] = Move{it->second, true};
+                        last.erase(it);
+                        return;
+                }
+                push(removed, path, is_dir);
+                moves[cookie] = Move{events.size() - 1, false};
+        }
+
+        /* return true and set @old if the source of the move was seen */
+        bool move_to(uint32_t cookie, const string &path, bool is_dir,
+                        string &old)
+        {
+                auto mv = moves.find(cookie);
+                if (mv == moves.end()) {
+                        push(created, path, is_dir);
+                        return false;
+                }
+                Move m = mv->second;
+                moves.erase(mv);
+                Event &e = events[m.idx];
+                old = e.path;
+                if (!m.created) {
+                        auto it = last.find(old);
+                        if (it != last.end() && it->second == m.idx)
+                                last.erase(it);
+                        e.kind = moved;
+                        e.old_path = old;
+                }
+                e.path = path;
+                /* what happened to the replaced file does not matter */
+                auto it = last.find(path);
+                if (it != last.end())
+                        kill(it);
+                last[path] = m.idx;
+                return true;
+        }
+
+        void clear()
+        {
+                events.clear();
+                dead.clear();
+                last.clear();
+                moves.clear();
+        }
+};
+
+/* return true if @path is @dir or under it */
+static bool under(const string &path, const string &dir)
+{
+        return path.compare(0, dir.size(), dir) == 0 &&
+                (path.size() == dir.size() || path[dir.size()] == '/' ||
+                 dir.back() == '/');
+}
+
+static string join(const string &dir, const char *name)
+{
+        Path_buffer buf{dir};
+        buf.push(name);
+        return buf.str();
+}
+
+File_watcher::File_watcher()
+{
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ == -1 && fd_ != -1) {
+                ::close(fd_);
+                fd_ = -1;
+        }
+}
+
+File_watcher::~File_watcher()
+{
+        stop();
+        if (fd_ != -1)
+                ::close(fd_);
+        if (wake_fd_ != -1)
+                ::close(wake_fd_);
+}
+
+bool File_watcher::add(const string &pathname, bool recursive)
+{
+        if (!ready() || pathname.empty())
+                return false;
+        string path = pathname;
+        while (path.size() > 1 && path.back() == '/')
+                path.pop_back();
+
+        std::lock_guard<std::mutex> lk(mtx_);
+        bool state;
+        if (recursive && File::status(path).is_directory())
+                state = add_tree(path, nullptr);
+        else
+                state = add_one(path, false);
+        if (state && std::find(roots_.begin(), roots_.end(), path) ==
+                        roots_.end())
+                roots_.push_back(path);
+        return state;
+}
+
+bool File_watcher::remove(const string &pathname)
+{
+        string path = pathname;
+        while (path.size() > 1 && path.back() == '/')
+                path.pop_back();
+
+        std::lock_guard<std::mutex> lk(mtx_);
+        roots_.erase(std::remove(roots_.begin(), roots_.end(), path),
+                        roots_.end());
+        return remove_tree(path);
+}
+
+std::size_t File_watcher::polled()
+{
+        std::lock_guard<std::mutex> lk(mtx_);
+        return polled_.size();
+}
+
+bool File_watcher::start(Callback callback, int latency_ms, int poll_ms)
+{
+        if (!ready() || running_)
+                return false;
+        callback_ = std::move(callback);
+        latency_ms_ = std::max(latency_ms, 0);
+        poll_ms_ = std::max(poll_ms, 1);
+        running_ = true;
+        thread_ = std::thread(&File_watcher::run, this);
+        return true;
+}
+
+void File_watcher::stop()
+{
+        if (!running_.exchange(false))
+                return;
+        uint64_t one = 1;
+        ssize_t ret = write(wake_fd_, &one, sizeof(one));
+        (void)ret;
+        if (thread_.joinable())
+                thread_.join();
+}
+
+bool File_watcher::add_one(const string &pathname, bool recursive)
+{
+        bool is_dir = File::status(pathname).is_directory();
+        int wd = inotify_add_watch(fd_, pathname.c_str(),
+                        is_dir ? dir_mask | IN_ONLYDIR : file_mask);
+        if (wd == -1) {
+                /* out of watches, rescan the directory instead */
+                if (errno != ENOSPC || !is_dir)
+                        return false;
+                Snapshot snap;
+                snap.recursive = recursive;
+                if (!scan(pathname, snap))
+                        return false;
+                polled_[pathname] = std::move(snap);
+                return true;
+        }
+        watches_[wd] = Watch{pathname, recursive, is_dir};
+        paths_[pathname] = wd;
+        return true;
+}
+
+bool File_watcher::add_tree(const string &pathname, Batch *batch)
+{
+        /* watch before listing, so no entry created in between is missed,
+         * which is why the parallel walker is not used here */
+        if (!add_one(pathname, true))
+                return false;
+
+        std::vector<string> subdirs;
+        Directory_reader reader(pathname);
+        Directory_reader::Entry e;
+        while (reader.next(e)) {
+                string child = join(pathname, string{e.name}.c_str());
+                bool is_dir = e.type == Directory_reader::directory;
+                if (e.type == Directory_reader::unknown)
+                        is_dir = File::status_at(AT_FDCWD, child, false)
+                                .is_directory();
+                if (batch)
+                        batch->push(created, child, is_dir);
+                if (is_dir)
+                        subdirs.push_back(std::move(child));
+        }
+        reader.close();
+
+        for (const auto &dir : subdirs)
+                add_tree(dir, batch);
+        return true;
+}
+
+bool File_watcher::remove_tree(const string &pathname)
+{
+        bool found = false;
+        for (auto it = paths_.begin(); it != paths_.end(); ) {
+                if (!under(it->first, pathname)) {
+                        ++it;
+                        continue;
+                }
+                inotify_rm_watch(fd_, it->second);
+                watches_.erase(it->second);
+                it = paths_.erase(it);
+                found = true;
+        }
+        for (auto it = polled_.lower_bound(pathname); it != polled_.end() &&
+                        it->first.compare(0, pathname.size(), pathname) == 0; ) {
+                if (!under(it->first, pathname)) {
+                        ++it;
+                        continue;
+                }
+                it = polled_.erase(it);
+                found = true;
+        }
+        return found;
+}
+
+void File_watcher::rename_tree(const string &from, const string &to)
+{
+        std::vector<std::pair<string, int>> moved_paths;
+        for (auto it = paths_.begin(); it != paths_.end(); ) {
+                if (!under(it->first, from)) {
+                        ++it;
+                        continue;
+                }
+                string path = to + it->first.substr(from.size());
+                watches_[it->second].path = path;
+                moved_paths.emplace_back(std::move(path), it->second);
+                it = paths_.erase(it);
+        }
+        for (auto &p : moved_paths)
+                paths_[std::move(p.first)] = p.second;
+
+        std::vector<std::pair<string, Snapshot>> moved_snaps;
+        for (auto it = polled_.begin(); it != polled_.end(); ) {
+                if (!under(it->first, from)) {
+                        ++it;
+                        continue;
+                }
+                moved_snaps.emplace_back(to + it->first.substr(from.size()),
+                                std::move(it->second));
+                it = polled_.erase(it);
+        }
+        for (auto &p : moved_snaps)
+                polled_[std::move(p.first)] = std::move(p.second);
+}
+
+bool File_watcher::scan(const string &pathname, Snapshot &snap)
+{
+        Directory_reader reader(pathname);
+        if (!reader.ready())
+                return false;
+        snap.entries.clear();
+        Directory_reader::Entry e;
+        while (reader.next(e)) {
+                string name{e.name};
+                File::Status st = File::status_at(AT_FDCWD,
+                                join(pathname, name.c_str()), false);
+                if (!st.exists)
+                        continue;
+                snap.entries[std::move(name)] = Stamp{
+                        st.mtime * 1000000000LL + st.mtime_nsec,
+                        st.size, st.is_directory()};
+        }
+        return true;
+}
+
+void File_watcher::rescan(Batch &batch)
+{
+        std::vector<string> gone, new_dirs;
+        for (auto &p : polled_) {
+                Snapshot snap;
+                snap.recursive = p.second.recursive;
+                if (!scan(p.first, snap)) {
+                        /* the parent reports it, unless it's a root */
+                        if (std::find(roots_.begin(), roots_.end(), p.first) !=
+                                        roots_.end())
+                                batch.push(removed, p.first, true);
+                        gone.push_back(p.first);
+                        continue;
+                }
+                auto &old = p.second.entries;
+                for (const auto &e : snap.entries) {
+                        string path = join(p.first, e.first.c_str());
+                        auto it = old.find(e.first);
+                        if (it == old.end()) {
+                                batch.push(created, path, e.second.is_dir);
+                                if (e.second.is_dir && snap.recursive)
+                                        new_dirs.push_back(path);
+                        } else if (it->second.mtime != e.second.mtime ||
+                                        it->second.size != e.second.size) {
+                                batch.push(modified, path, e.second.is_dir);
+                        }
+                }
+                for (const auto &e : old) {
+                        if (snap.entries.count(e.first))
+                                continue;
+                        string path = join(p.first, e.first.c_str());
+                        batch.push(removed, path, e.second.is_dir);
+                        if (e.second.is_dir)
+                                gone.push_back(path);
+                }
+                p.second = std::move(snap);
+        }
+        for (const auto &path : gone)
+                remove_tree(path);
+        for (const auto &path : new_dirs)
+                add_tree(path, &batch);
+}
+
+void File_watcher::read_events(Batch &batch)
+{
+        alignas(struct inotify_event) char buf[64 * 1024];
+        for (;;) {
+                ssize_t n = read(fd_, buf, sizeof(buf));
+                if (n <= 0)
+                        break;
+                std::lock_guard<std::mutex> lk(mtx_);
+                for (char *p = buf; p < buf + n; ) {
+                        const auto *ev =
+                                reinterpret_cast<struct inotify_event *>(p);
+                        p += sizeof(struct inotify_event) + ev->len;
+
+                        if (ev->mask & IN_Q_OVERFLOW) {
+                                /* the queue was full and events are lost */
+                                for (const auto &root : roots_)
+                                        batch.push(overflow, root, true);
+                                continue;
+                        }
+                        auto it = watches_.find(ev->wd);
+                        if (it == watches_.end())
+                                continue;
+                        if (ev->mask & IN_IGNORED) {
+                                auto pit = paths_.find(it->second.path);
+                                if (pit != paths_.end() &&
+                                                pit->second == ev->wd)
+                                        paths_.erase(pit);
+                                watches_.erase(it);
+                                continue;
+                        }
+
+                        bool is_dir = ev->mask & IN_ISDIR;
+                        bool recursive = it->second.recursive;
+                        string path = ev->len ?
+                                join(it->second.path, ev->name) :
+                                it->second.path;
+                        string old;
+
+                        if (ev->mask & IN_CREATE) {
+                                batch.push(created, path, is_dir);
+                                if (is_dir && recursive)
+                                        add_tree(path, &batch);
+                        } else if (ev->mask & IN_MOVED_FROM) {
+                                batch.move_from(ev->cookie, path, is_dir);
+                        } else if (ev->mask & IN_MOVED_TO) {
+                                if (batch.move_to(ev->cookie, path, is_dir,
+                                                        old)) {
+                                        if (is_dir)
+                                                rename_tree(old, path);
+                                } else if (is_dir && recursive) {
+                                        add_tree(path, &batch);
+                                }
+                        } else if (ev->mask & IN_DELETE) {
+                                batch.push(removed, path, is_dir);
+                                if (is_dir)
+                                        remove_tree(path);
+                        } else if (ev->mask & (IN_MODIFY | IN_ATTRIB)) {
+                                batch.push(modified, path, is_dir);
+                        } else if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                                /* the parent reports it, unless it's a root */
+                                if (std::find(roots_.begin(), roots_.end(),
+                                                        path) == roots_.end())
+                                        continue;
+                                /* it is gone, the watch knows what it was */
+                                batch.push(removed, path, it->second.is_dir);
+                                if (ev->mask & IN_MOVE_SELF)
+                                        remove_tree(path);
+                        }
+                }
+        }
+}
+
+void File_watcher::flush(Batch &batch)
+{
+        std::vector<Event> out;
+        {
+                std::lock_guard<std::mutex> lk(mtx_);
+                /* the unpaired moves went out of the watched trees */
+                for (const auto &mv : batch.moves) {
+                        if (mv.second.created) {
+                                batch.dead[mv.second.idx] = true;
+                                continue;
+                        }
+                        const Event &e = batch.events[mv.second.idx];
+                        if (e.is_dir && e.kind == removed)
+                                remove_tree(e.path);
+                }
+        }
+        out.reserve(batch.events.size());
+        for (std::size_t i = 0; i < batch.events.size(); ++i)
+                if (!batch.dead[i])
+                        out.push_back(std::move(batch.events[i]));
+        batch.clear();
+        if (!out.empty() && callback_)
+                callback_(out);
+}
+
+void File_watcher::run()
+{
+        struct pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        const auto latency = std::chrono::milliseconds(latency_ms_);
+        const auto period = std::chrono::milliseconds(poll_ms_);
+        Batch batch;
+        Clock::time_point first, last;
+        Clock::time_point next_poll = Clock::now() + period;
+
+        while (running_) {
+                auto now = Clock::now();
+                bool polling = polled() > 0;
+                int timeout = -1;
+                if (!batch.empty()) {
+                        auto due = std::min(last + latency,
+                                        first + latency * max_hold);
+                        timeout = std::max<long long>(0,
+                                        std::chrono::duration_cast<
+                                        std::chrono::milliseconds>(due - now)
+                                        .count());
+                }
+                if (polling) {
+                        long long left = std::max<long long>(0,
+                                        std::chrono::duration_cast<
+                                        std::chrono::milliseconds>(
+                                                next_poll - now).count());
+                        timeout = timeout == -1 ? left :
+                                std::min<long long>(timeout, left);
+                }
+
+                int ret = poll(fds, 2, timeout);
+                if (ret == -1 && errno != EINTR)
+                        break;
+                if (!running_)
+                        break;
+
+                std::size_t count = batch.events.size();
+                if (ret > 0 && (fds[0].revents & POLLIN))
+                        read_events(batch);
+                now = Clock::now();
+                if (polling && now >= next_poll) {
+                        std::lock_guard<std::mutex> lk(mtx_);
+                        rescan(batch);
+                        next_poll = now + period;
+                }
+                if (batch.events.size() != count) {
+                        if (count == 0)
+                                first = now;
+                        last = now;
+                }
+                if (!batch.empty() && (now >= last + latency ||
+                                        now >= first + latency * max_hold))
+                        flush(batch);
+        }
+}
+
+#endif
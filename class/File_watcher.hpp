@@ -0,0 +1,237 @@
+/**
+ * File_watcher.hpp - watch files and directory trees for changes by inotify
+ *                    and deliver the changes in batches (Linux only)
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 13:48:12
+ */
+
+#ifndef FILE_WATCHER_HPP_
+#define FILE_WATCHER_HPP_
+
+#if defined(__linux__)
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+class File_watcher {
+public:
+        enum Kind : unsigned char {
+                created,
+                modified,
+                removed,
+                moved,          // from @old_path to @path
+                overflow        // events under @path were lost, rescan it
+        };
+
+        struct Event {
+                Kind kind;
+                std::string path;
+                std::string old_path;   // only for moved
+                bool is_dir;
+        };
+
+        /* called on the watcher thread with the events of a burst */
+        using Callback = std::function<void(const std::vector<Event> &)>;
+
+private:
+        struct Watch {
+                std::string path;
+                bool recursive;
+                bool is_dir;
+        };
+
+        struct Stamp {
+                long long mtime;        // in nanoseconds
+                long long size;
+                bool is_dir;
+        };
+
+        /* the entries of a directory that could not get a watch */
+        struct Snapshot {
+                bool recursive;
+                std::map<std::string, Stamp> entries;   // by name
+        };
+
+        struct Batch;
+
+        int fd_{-1};                    // the inotify instance
+        int wake_fd_{-1};               // an eventfd to wake up the thread
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+        std::mutex mtx_;                // guards the watches
+        std::unordered_map<int, Watch> watches_;       // by descriptor
+        std::unordered_map<std::string, int> paths_;   // descriptor by path
+        std::map<std::string, Snapshot> polled_;       // by path
+        std::vector<std::string> roots_;
+        Callback callback_;
+        int latency_ms_{100};
+        int poll_ms_{2000};
+
+public:
+        File_watcher(const File_watcher &) = delete;
+        File_watcher &operator=(const File_watcher &) = delete;
+
+        /**
+         * @brief Create a File_watcher object, no file is watched yet
+         */
+        File_watcher();
+
+        /**
+         * @brief Stop watching and release the inotify instance
+         */
+        ~File_watcher();
+
+        /**
+         * @brief Tell if the watcher could be created
+         *
+         * @return True if the inotify instance is open, false otherwise
+         */
+        bool ready() const;
+
+        /**
+         * @brief Watch a file or a directory, when the system limit of
+         *        watches is reached the directories left are rescanned
+         *        periodically instead
+         *
+         * @param pathname The pathname of the file or directory
+         * @param recursive Whether to watch the subdirectories too,
+         *        including the ones created later
+         *
+         * @return True if succeeded and false if failed
+         */
+        bool add(const std::string &pathname, bool recursive = true);
+
+        /**
+         * @brief Stop watching a file or a directory and its subdirectories
+         *
+         * @param pathname The pathname given to add()
+         *
+         * @return True if it was watched, false otherwise
+         */
+        bool remove(const std::string &pathname);
+
+        /**
+         * @brief Start the watcher thread
+         *
+         * @param callback The callback for the batches of events
+         * @param latency_ms How long the events of a burst are collected
+         *        and merged before delivery, in milliseconds
+         * @param poll_ms How often the directories without a watch are
+         *        rescanned, in milliseconds
+         *
+         * @return True if succeeded and false if failed or already started
+         *
+         * @sa stop()
+         */
+        bool start(Callback callback, int latency_ms = 100,
+                        int poll_ms = 2000);
+
+        /**
+         * @brief Stop the watcher thread, the events not delivered yet are
+         *        dropped
+         *
+         * @sa start()
+         */
+        void stop();
+
+        /**
+         * @brief Get the number of directories watched by rescanning
+         *        because the watch limit was reached
+         *
+         * @return The number of directories
+         */
+        std::size_t polled();
+
+private:
+        /**
+         * @brief Add a watch to a single file or directory, falling back to
+         *        the rescanning on the watch limit
+         *
+         * @param pathname The pathname
+         * @param recursive Whether new subdirectories are watched too
+         *
+         * @return True if it's watched either way, false otherwise
+         */
+        bool add_one(const std::string &pathname, bool recursive);
+
+        /**
+         * @brief Add the watches to a directory and all its subdirectories
+         *
+         * @param pathname The pathname of the directory
+         * @param batch The batch to report the existing entries to, nullptr
+         *        to not report them
+         *
+         * @return True if the directory itself is watched, false otherwise
+         */
+        bool add_tree(const std::string &pathname, Batch *batch);
+
+        /**
+         * @brief Remove the watches of a path and all paths under it
+         *
+         * @param pathname The pathname
+         *
+         * @return True if anything was watched, false otherwise
+         */
+        bool remove_tree(const std::string &pathname);
+
+        /**
+         * @brief Rename the watched paths under @from to be under @to
+         *
+         * @param from The old pathname
+         * @param to The new pathname
+         */
+        void rename_tree(const std::string &from, const std::string &to);
+
+        /**
+         * @brief Take a snapshot of a directory for the rescanning
+         *
+         * @param pathname The pathname of the directory
+         * @param snap The Snapshot to fill
+         *
+         * @return True if succeeded and false if failed
+         */
+        static bool scan(const std::string &pathname, Snapshot &snap);
+
+        /**
+         * @brief Rescan the directories without a watch
+         *
+         * @param batch The batch to report the changes to
+         */
+        void rescan(Batch &batch);
+
+        /**
+         * @brief Read the pending inotify events into a batch
+         *
+         * @param batch The batch
+         */
+        void read_events(Batch &batch);
+
+        /**
+         * @brief Deliver the merged events of a batch to the callback and
+         *        empty it
+         *
+         * @param batch The batch
+         */
+        void flush(Batch &batch);
+
+        /**
+         * @brief The loop of the watcher thread
+         */
+        void run();
+};
+
+inline bool File_watcher::ready() const
+{
+        return fd_ != -1;
+}
+
+#endif
+
+#endif
@@ -2,13 +2,14 @@
  * File_writer.cpp - offer the multi-platform basic file write operation
  *
  * Created by Haoyuan Li on 2021/08/21
- * Last Modified: 2021/08/26 12:43:36
+ * Last Modified: 2026/10/20 09:40:12
  */
 
 #include "File_writer.hpp"
 
 #include <string>
 #include <cstdio>
+#include <cerrno>
 
 #if defined(__unix__)
 
@@ -61,9 +62,12 @@ bool File_writer::close()
 #if defined(__unix__)
         if (unlock() && ::close(fd_) == 0 && fclose(fp_) == 0)
                 state = true;
+        fd_ = -1;
+        fp_ = nullptr;
 #elif defined(_MSC_VER)
         if (unlock() && CloseHandle(h_file_))
                 state = true;
+        h_file_ = INVALID_HANDLE_VALUE;
 #endif
         return state;
 }
@@ -80,34 +84,13 @@ long long File_writer::skip(const long long &n)
 
 int File_writer::write(const int &c)
 {
-        int ret = -1;
-        lock();
-#if defined(__unix__)
-        if (fputc(c, fp_) != EOF)
-                ret = c;
-#elif defined(_MSC_VER)
-        DWORD n;
-        if (WriteFile(h_file_, &c, 1, &n, nullptr))
-                ret = c;
-#endif
-        unlock();
-        return ret;
+        char ch = static_cast<char>(c);
+        return write_range(&ch, 1, false) == 1 ? c : -1;
 }
 
 size_t File_writer::write(const string &s)
 {
-        size_t ret = 0;
-        lock();
-#if defined(__unix__)
-        ret = fwrite(s.c_str(), sizeof(char), s.length(), fp_);
-#elif defined(_MSC_VER)
-        DWORD n = 0;
-        if (WriteFile(h_file_, s.c_str(), static_cast<DWORD>(s.length()),
-                                &n, nullptr))
-                ret = n;
-#endif
-        unlock();
-        return ret;
+        return write_range(s.c_str(), s.length(), false);
 }
 
 size_t File_writer::write(const string &s, const size_t &off, size_t len)
@@ -119,37 +102,12 @@ size_t File_writer::write(const string &s, const size_t &off, size_t len)
 
 int File_writer::append(const char &c)
 {
-        int ret = -1;
-        lock();
-#if defined(__unix__)
-        file_seek(0, FILE_END);
-        if (fputc(c, fp_) != EOF)
-                ret = c;
-#elif defined(_MSC_VER)
-        file_seek(0, FILE_END);
-        DWORD n;
-        if (WriteFile(h_file_, &c, 1, &n, nullptr))
-                ret = c;
-#endif
-        unlock();
-        return ret;
+        return write_range(&c, 1, true) == 1 ? c : -1;
 }
 
 size_t File_writer::append(const string &s)
 {
-        size_t ret = 0;
-        lock();
-#if defined(__unix__)
-        file_seek(0, FILE_END);
-        ret = fwrite(s.c_str(), sizeof(char), s.length(), fp_);
-#elif defined(_MSC_VER)
-        DWORD n = 0;
-        if (WriteFile(h_file_, s.c_str(), static_cast<DWORD>(s.length()),
-                                &n, nullptr))
-                ret = n;
-#endif
-        unlock();
-        return ret;
+        return write_range(s.c_str(), s.length(), true);
 }
 
 size_t File_writer::append(const string &s, const size_t &off, size_t len)
@@ -159,6 +117,37 @@ size_t File_writer::append(const string &s, const size_t &off, size_t len)
         return append(s.substr(off, len));
 }
 
+size_t File_writer::write_range(const char *buf, const size_t &len,
+                const bool &at_end)
+{
+        if (len == 0)
+                return 0;
+        long long pos = at_end ? lock_end() : file_tell();
+        if (pos == -1 || (!at_end && !lock(pos, len)))
+                return 0;
+        size_t ret = 0;
+#if defined(__unix__)
+        /* the bytes go to the kernel while the range is still locked */
+        while (ret < len) {
+                ssize_t n = pwrite(fd_, buf + ret, len - ret, pos + ret);
+                if (n < 0 && errno == EINTR)
+                        continue;
+                if (n <= 0)
+                        break;
+                ret += n;
+        }
+        file_seek(pos + ret, FILE_BEGIN);
+#elif defined(_MSC_VER)
+        DWORD n = 0;
+        if (WriteFile(h_file_, buf, static_cast<DWORD>(len), &n, nullptr))
+                ret = n;
+#endif
+        /* lock_end() holds everything from the old end on, not only the
+         * bytes written */
+        unlock(pos, at_end ? 0 : len);
+        return ret;
+}
+
 bool File_writer::clear()
 {
         bool state = false;
@@ -2,7 +2,7 @@
  * File_writer.hpp - offer the multi-platform basic file write operation
  *
  * Created by Haoyuan Li on 2021/08/21
- * Last Modified: 2021/08/26 10:07:38
+ * Last Modified: 2026/10/20 13:05:44
  */
 
 #ifndef FILE_WRITER_H_
@@ -16,7 +16,8 @@
 #if defined(__unix__)
 
 #include <unistd.h>
-#include <sys/file.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 #define FILE_BEGIN SEEK_SET
 #define FILE_CURRENT SEEK_CUR
@@ -32,7 +33,7 @@ class File_writer {
 private:
 #if defined(__unix__)
         int fd_{-1};
-        FILE *fp_{nullptr};
+        FILE *fp_{nullptr};     // keeps the file offset, writes go to fd_
 #elif defined(_MSC_VER)
         HANDLE h_file_{INVALID_HANDLE_VALUE};
         OVERLAPPED overlapped_{0};
@@ -215,18 +216,65 @@ private:
         void do_open(const std::string &pathname);
 
         /**
-         * @brief Lock the file
+         * @brief Put an exclusive lock on a byte range of the file, the
+         *        other readers and writers of the range will be blocked
+         *
+         * @param offset The first byte of the range
+         * @param len The length of the range, 0 means up to the end of the
+         *        file however it grows
          *
          * @return True if lock successfully, false otherwise
+         *
+         * @sa unlock()
+         */
+        bool lock(const long long &offset = 0, const long long &len = 0);
+
+        /**
+         * @brief Put an exclusive lock on the range from the end of the file
+         *        on, and move the write file offset to the start of it
+         *
+         * @return The start of the locked range when succeeded, -1 otherwise,
+         *         pass it to unlock() with a length of 0 to release the lock
          */
-        bool lock();
+        long long lock_end();
 
         /**
-         * @brief Unlock the file
+         * @brief Unlock a byte range of the file, the range should be the
+         *        same as the one passed to lock()
+         *
+         * @param offset The first byte of the range
+         * @param len The length of the range, 0 means up to the end of the
+         *        file however it grows
          *
          * @return True if unlock successfully, false otherwise
+         *
+         * @sa lock()
+         */
+        bool unlock(const long long &offset = 0, const long long &len = 0);
+
+        /**
+         * @brief Write a buffer at the file offset, or at the end of the
+         *        file, holding an exclusive lock on the range until the
+         *        bytes have reached the kernel
+         *
+         * @param buf The bytes to write
+         * @param len The number of bytes, nothing is locked if it is 0
+         * @param at_end Write at the end of the file if true, at the file
+         *        offset otherwise
+         *
+         * @return The total number of bytes successfully written
+         */
+        size_t write_range(const char *buf, const size_t &len,
+                        const bool &at_end);
+
+        /**
+         * @brief Get the current file offset without dropping the stream
+         *        buffer
+         *
+         * @return The offset in bytes from the beginning of the file when
+         *         succeeded, -1 otherwise
          */
-        bool unlock();
+        long long file_tell();
 };
 
 inline bool File_writer::ready()
@@ -252,6 +300,8 @@ inline void File_writer::do_open(const std::string &pathname)
 #if defined(__unix__)
         fd_ = ::open(pathname.c_str(), O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR);
         fp_ = fopen(pathname.c_str(), "r+");
+        if (fp_)
+                setvbuf(fp_, nullptr, _IONBF, 0);
 #elif defined(_MSC_VER)
         h_file_ = CreateFile(pathname.c_str(),
                         GENERIC_WRITE,
@@ -265,22 +315,81 @@ inline void File_writer::do_open(const std::string &pathname)
 #endif
 }
 
-inline bool File_writer::lock()
+inline bool File_writer::lock(const long long &offset, const long long &len)
 {
 #if defined(__unix__)
-        return flock(fd_, LOCK_EX) == 0;
+        struct flock fl{};
+        fl.l_type = F_WRLCK;
+        fl.l_whence = SEEK_SET;
+        fl.l_start = offset;
+        fl.l_len = len;
+        /* OFD locks belong to the open file description like flock() did,
+         * so they are not dropped when some other fd of the file closes */
+#if defined(F_OFD_SETLKW)
+        return fcntl(fd_, F_OFD_SETLKW, &fl) == 0;
+#else
+        return fcntl(fd_, F_SETLKW, &fl) == 0;
+#endif
 #elif defined(_MSC_VER)
+        ULARGE_INTEGER l;
+        l.QuadPart = (len == 0) ? MAXULONGLONG : len;
+        overlapped_.Offset = static_cast<DWORD>(offset);
+        overlapped_.OffsetHigh = static_cast<DWORD>(offset >> 32);
         return LockFileEx(h_file_, LOCKFILE_EXCLUSIVE_LOCK, 0,
-                        MAXDWORD, MAXDWORD, &overlapped_);
+                        l.LowPart, l.HighPart, &overlapped_);
+#endif
+}
+
+inline long long File_writer::lock_end()
+{
+#if defined(__unix__)
+        /* a SEEK_END lock takes its start before waiting, so the end it
+         * locks can differ from the end seen after; lock from the size
+         * instead, and again if the file grew meanwhile */
+        for (;;) {
+                struct stat st;
+                if (fstat(fd_, &st) != 0 || !lock(st.st_size, 0))
+                        return -1;
+                struct stat now;
+                if (fstat(fd_, &now) != 0) {
+                        unlock(st.st_size, 0);
+                        return -1;
+                }
+                if (now.st_size == st.st_size &&
+                                file_seek(st.st_size, FILE_BEGIN) != -1)
+                        return st.st_size;
+                unlock(st.st_size, 0);
+                if (now.st_size == st.st_size)
+                        return -1;
+        }
+#elif defined(_MSC_VER)
+        long long pos = file_seek(0, FILE_END);
+        if (pos == -1 || !lock(pos, 0))
+                return -1;
+        return pos;
 #endif
 }
 
-inline bool File_writer::unlock()
+inline bool File_writer::unlock(const long long &offset,
+                const long long &len)
 {
 #if defined(__unix__)
-        return flock(fd_, LOCK_UN) == 0;
+        struct flock fl{};
+        fl.l_type = F_UNLCK;
+        fl.l_whence = SEEK_SET;
+        fl.l_start = offset;
+        fl.l_len = len;
+#if defined(F_OFD_SETLK)
+        return fcntl(fd_, F_OFD_SETLK, &fl) == 0;
+#else
+        return fcntl(fd_, F_SETLK, &fl) == 0;
+#endif
 #elif defined(_MSC_VER)
-        return UnlockFileEx(h_file_, 0, MAXDWORD, MAXDWORD, &overlapped_);
+        ULARGE_INTEGER l;
+        l.QuadPart = (len == 0) ? MAXULONGLONG : len;
+        overlapped_.Offset = static_cast<DWORD>(offset);
+        overlapped_.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        return UnlockFileEx(h_file_, 0, l.LowPart, l.HighPart, &overlapped_);
 #endif
 }
 
@@ -303,4 +412,13 @@ inline long long File_writer::file_seek(const long long &offset,
         return pos;
 }
 
+inline long long File_writer::file_tell()
+{
+#if defined(__unix__)
+        return ftell(fp_);
+#elif defined(_MSC_VER)
+        return file_seek(0, FILE_CURRENT);
+#endif
+}
+
 #endif
@@ -0,0 +1,279 @@
+/**
+ * Glob.cpp - compiled glob patterns matched against relative paths, with
+ *            pruning of the directories that cannot hold a match
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 23:48:12
+ */
+
+#include "Glob.hpp"
+
+#if defined(__unix__)
+#include "Directory_walker.hpp"
+#endif
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+
+using std::string;
+using std::string_view;
+
+/**
+ * @brief Match a character against the class starting at @pos
+ *
+ * @param pattern The pattern
+ * @param pos The index of the '['
+ * @param c The character
+ * @param end Set to the index of the closing ']', string_view::npos if not
+ *        closed
+ *
+ * @return True if @c is in the class, false otherwise
+ */
+static bool match_class(string_view pattern, string_view::size_type pos,
+                char c, string_view::size_type &end)
+{
+        auto i = pos + 1;
+        bool negate = i < pattern.size() &&
+                (pattern[i] == '!' || pattern[i] == '^');
+        if (negate)
+                ++i;
+        bool found = false;
+        auto uc = static_cast<unsigned char>(c);
+        for (bool first = true; i < pattern.size() &&
+                        (pattern[i] != ']' || first); first = false) {
+                auto lo = static_cast<unsigned char>(pattern[i]);
+                if (lo == '\\' && i + 1 < pattern.size())
+                        lo = static_cast<unsigned char>(pattern[++i]);
+                if (i + 2 < pattern.size() && pattern[i + 1] == '-' &&
+                                pattern[i + 2] != ']') {
+                        auto hi = static_cast<unsigned char>(pattern[i + 2]);
+                        found = found || (lo <= uc && uc <= hi);
+                        i += 3;
+                } else {
+                        found = found || lo == uc;
+                        ++i;
+                }
+        }
+        if (i >= pattern.size()) {
+                end = string_view::npos;
+                return false;
+        }
+        end = i;
+        return found != negate;
+}
+
+Glob::Glob(string_view pattern)
+{
+        std::vector<string> patterns;
+        if (pattern.empty() || !expand(pattern, patterns))
+                return;
+        alts_.resize(patterns.size());
+        for (std::size_t i = 0; i < patterns.size(); ++i)
+                if (!compile(patterns[i], alts_[i]))
+                        return;
+        valid_ = true;
+}
+
+bool Glob::match(Path_view path) const
+{
+        if (!valid_)
+                return false;
+        for (const auto &alt : alts_)
+                if (match_from(alt, 0, path.begin(), path.end(), false))
+                        return true;
+        return false;
+}
+
+bool Glob::can_descend(Path_view dir) const
+{
+        if (!valid_)
+                return false;
+        for (const auto &alt : alts_)
+                if (match_from(alt, 0, dir.begin(), dir.end(), true))
+                        return true;
+        return false;
+}
+
+bool Glob::match_name(string_view pattern, string_view name)
+{
+        using size_type = string_view::size_type;
+        size_type p = 0, n = 0;
+        /* where to go back to when a later part fails after a star */
+        size_type star_p = string_view::npos, star_n = 0;
+
+        while (n < name.size()) {
+                if (p < pattern.size()) {
+                        char c = pattern[p];
+                        if (c == '*') {
+                                star_p = ++p;
+                                star_n = n;
+                                continue;
+                        }
+                        if (c == '?') {
+                                ++p;
+                                ++n;
+                                continue;
+                        }
+                        if (c == '[') {
+                                size_type end;
+                                bool in = match_class(pattern, p, name[n],
+                                                end);
+                                if (end == string_view::npos)
+                                        return false;
+                                if (in) {
+                                        p = end + 1;
+                                        ++n;
+                                        continue;
+                                }
+                        } else {
+                                size_type q = p;
+                                if (c == '\\' && q + 1 < pattern.size())
+                                        c = pattern[++q];
+                                if (c == name[n]) {
+                                        p = q + 1;
+                                        ++n;
+                                        continue;
+                                }
+                        }
+                }
+                if (star_p == string_view::npos)
+                        return false;
+                p = star_p;
+                n = ++star_n;
+        }
+        while (p < pattern.size() && pattern[p] == '*')
+                ++p;
+        return p == pattern.size();
+}
+
+#if defined(__unix__)
+void Glob::apply(Directory_walker &walker, string_view root) const
+{
+        /* the walker puts a separator after the root unless it ends one */
+        auto skip = root.size();
+        if (root.empty() ||
+                        Path_view::separators.find(root.back()) ==
+                        string_view::npos)
+                ++skip;
+        walker.set_filter([this, skip](const Directory_walker::Entry &e) {
+                return match(Path_view{e.path.substr(skip)});
+        });
+        walker.set_prune([this, skip](const Directory_walker::Entry &e) {
+                return !can_descend(Path_view{e.path.substr(skip)});
+        });
+}
+#endif
+
+bool Glob::expand(string_view pattern, std::vector<string> &out)
+{
+        using size_type = string_view::size_type;
+        size_type open = string_view::npos, close = string_view::npos;
+        std::vector<size_type> commas;
+        int depth = 0;
+
+        for (size_type i = 0; i < pattern.size(); ++i) {
+                char c = pattern[i];
+                if (c == '\\') {
+                        ++i;
+                } else if (c == '[') {
+                        size_type end;
+                        match_class(pattern, i, '\0', end);
+                        if (end == string_view::npos)
+                                return false;
+                        i = end;
+                } else if (c == '{') {
+                        if (depth++ == 0) {
+                                open = i;
+                                commas.clear();
+                        }
+                } else if (c == ',' && depth == 1) {
+                        commas.push_back(i);
+                } else if (c == '}' && depth > 0 && --depth == 0) {
+                        /* braces without a comma are literal */
+                        if (!commas.empty()) {
+                                close = i;
+                                break;
+                        }
+                }
+        }
+        if (depth > 0)
+                return false;
+        if (close == string_view::npos) {
+                out.emplace_back(pattern);
+                return true;
+        }
+
+        string_view prefix = pattern.substr(0, open);
+        string_view suffix = pattern.substr(close + 1);
+        commas.push_back(close);
+        size_type from = open + 1;
+        string s;
+        for (auto comma : commas) {
+                s.assign(prefix);
+                s.append(pattern.substr(from, comma - from));
+                s.append(suffix);
+                if (!expand(s, out))
+                        return false;
+                from = comma + 1;
+        }
+        return true;
+}
+
+bool Glob::compile(string_view pattern, Alternative &alt)
+{
+        for (string_view comp : Path_view{pattern}) {
+                if (comp == "**") {
+                        /* a run of ** is the same as one */
+                        if (alt.empty() || !alt.back().any_depth)
+                                alt.push_back(Segment{string{}, true, true});
+                        continue;
+                }
+                bool literal = comp.find_first_of("*?[\\") ==
+                        string_view::npos;
+                for (string_view::size_type i = 0; !literal &&
+                                i < comp.size(); ++i) {
+                        if (comp[i] == '\\') {
+                                ++i;
+                        } else if (comp[i] == '[') {
+                                string_view::size_type end;
+                                match_class(comp, i, '\0', end);
+                                if (end == string_view::npos)
+                                        return false;
+                                i = end;
+                        }
+                }
+                alt.push_back(Segment{string{comp}, false, literal});
+        }
+        return !alt.empty();
+}
+
+bool Glob::match_from(const Alternative &alt, std::size_t si,
+                Path_view::iterator it, Path_view::iterator end, bool partial)
+{
+        if (it == end) {
+                if (partial)
+                        return si < alt.size();
+                for (; si < alt.size(); ++si)
+                        if (!alt[si].any_depth)
+                                return false;
+                return true;
+        }
+        if (si == alt.size())
+                return false;
+        const Segment &seg = alt[si];
+        if (seg.any_depth)
+                return match_from(alt, si + 1, it, end, partial) ||
+                        match_from(alt, si, std::next(it), end, partial);
+        if (!match_segment(seg, *it))
+                return false;
+        return match_from(alt, si + 1, ++it, end, partial);
+}
+
+bool Glob::match_segment(const Segment &seg, string_view name)
+{
+        if (seg.literal)
+                return name == seg.pattern;
+        return match_name(seg.pattern, name);
+}
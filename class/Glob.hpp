@@ -0,0 +1,168 @@
+/**
+ * Glob.hpp - compiled glob patterns matched against relative paths, with
+ *            pruning of the directories that cannot hold a match
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 23:48:12
+ */
+
+#ifndef GLOB_HPP_
+#define GLOB_HPP_
+
+#include "Path.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__)
+class Directory_walker;
+#endif
+
+/*
+ * The pattern is split into components by the separators and each
+ * component matches one name of the path:
+ *      *       any characters but a separator
+ *      ?       one character but a separator
+ *      [abc]   one of the characters, ranges like [a-z] and negation like
+ *              [!a-z] or [^a-z] allowed, ']' first is a literal
+ *      {a,b}   either alternative, nested braces allowed
+ *      **      as a whole component, any number of components, none
+ *              included
+ *      \c      the character c itself (Unix only, where \ is no separator)
+ * The dot files are matched like any other names.
+ */
+class Glob {
+private:
+        struct Segment {
+                std::string pattern;
+                bool any_depth;         // the ** component
+                bool literal;           // no wildcard, compared directly
+        };
+
+        /* one alternative of the braces */
+        using Alternative = std::vector<Segment>;
+
+        std::vector<Alternative> alts_;
+        bool valid_{false};
+
+public:
+        Glob() = default;
+        ~Glob() = default;
+
+        /**
+         * @brief Compile a pattern
+         *
+         * @param pattern The pattern
+         */
+        explicit Glob(std::string_view pattern);
+
+        /**
+         * @brief Tell if the pattern compiled
+         *
+         * @return False if it's empty or its braces or brackets are not
+         *         closed, true otherwise
+         */
+        bool valid() const;
+
+        /**
+         * @brief Check whether a path matches the pattern, no allocation is
+         *        made
+         *
+         * @param path The path, relative to where the pattern starts
+         *
+         * @return True if it matches, false otherwise
+         */
+        bool match(Path_view path) const;
+
+        /**
+         * @brief Check whether some path under a directory could match the
+         *        pattern, no allocation is made
+         *
+         * @param dir The path of the directory, relative to where the
+         *        pattern starts
+         *
+         * @return False if nothing under @dir can match, true otherwise
+         */
+        bool can_descend(Path_view dir) const;
+
+        /**
+         * @brief Check whether a single name matches a component pattern,
+         *        no allocation is made
+         *
+         * @param pattern The component pattern, without braces or separators
+         * @param name The name
+         *
+         * @return True if it matches, false otherwise
+         */
+        static bool match_name(std::string_view pattern,
+                        std::string_view name);
+
+#if defined(__unix__)
+        /**
+         * @brief Make a walker report only the entries matching and skip the
+         *        directories that cannot hold a match, the Glob must outlive
+         *        the walk
+         *
+         * @param walker The walker, its filter and prune callbacks are
+         *        replaced
+         * @param root The root given to Directory_walker::walk()
+         */
+        void apply(Directory_walker &walker, std::string_view root) const;
+#endif
+
+private:
+        /**
+         * @brief Expand the braces of a pattern
+         *
+         * @param pattern The pattern
+         * @param out The vector to append the patterns without braces to
+         *
+         * @return False if a brace is not closed, true otherwise
+         */
+        static bool expand(std::string_view pattern,
+                        std::vector<std::string> &out);
+
+        /**
+         * @brief Split a pattern without braces into segments
+         *
+         * @param pattern The pattern
+         * @param alt The Alternative to fill
+         *
+         * @return False if a bracket is not closed, true otherwise
+         */
+        static bool compile(std::string_view pattern, Alternative &alt);
+
+        /**
+         * @brief Match the components from @it against the segments from @si
+         *
+         * @param alt The segments
+         * @param si The index of the first segment
+         * @param it The first component
+         * @param end The end of the components
+         * @param partial True if the components only need to match a prefix
+         *        of the segments, leaving at least one to match deeper
+         *
+         * @return True if they match, false otherwise
+         */
+        static bool match_from(const Alternative &alt, std::size_t si,
+                        Path_view::iterator it, Path_view::iterator end,
+                        bool partial);
+
+        /**
+         * @brief Match a name against a segment
+         *
+         * @param seg The segment
+         * @param name The name
+         *
+         * @return True if it matches, false otherwise
+         */
+        static bool match_segment(const Segment &seg, std::string_view name);
+};
+
+inline bool Glob::valid() const
+{
+        return valid_;
+}
+
+#endif
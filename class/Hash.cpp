@@ -0,0 +1,164 @@
+/**
+ * Hash.cpp - the 64-bit xxHash of byte streams, for comparing file contents
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 00:31:09
+ */
+
+#include "Hash.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static const uint64_t prime1 = 11400714785074694791ULL;
+static const uint64_t prime2 = 14029467366897019727ULL;
+static const uint64_t prime3 = 1609587929392839161ULL;
+static const uint64_t prime4 = 9650029242287828579ULL;
+static const uint64_t prime5 = 2870177450012600261ULL;
+
+static inline uint64_t rotl(uint64_t x, int r)
+{
+        return (x << r) | (x >> (64 - r));
+}
+
+/* the hash is defined on little-endian words */
+static inline uint64_t read64(const unsigned char *p)
+{
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap64(v);
+#endif
+        return v;
+}
+
+static inline uint32_t read32(const unsigned char *p)
+{
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap32(v);
+#endif
+        return v;
+}
+
+static inline uint64_t round(uint64_t acc, uint64_t input)
+{
+        acc += input * prime2;
+        acc = rotl(acc, 31);
+        return acc * prime1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t val)
+{
+        acc ^= round(0, val);
+        return acc * prime1 + prime4;
+}
+
+/**
+ * @brief Run the four lanes over the whole 32-byte stripes, the lanes do not
+ *        depend on each other so the CPU runs them side by side
+ *
+ * @return The number of bytes consumed
+ */
+static std::size_t stripes(uint64_t v[4], const unsigned char *p,
+                std::size_t len)
+{
+        uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+        const unsigned char *end = p + (len & ~std::size_t{31});
+        for (const unsigned char *q = p; q < end; q += 32) {
+                v1 = round(v1, read64(q));
+                v2 = round(v2, read64(q + 8));
+                v3 = round(v3, read64(q + 16));
+                v4 = round(v4, read64(q + 24));
+        }
+        v[0] = v1;
+        v[1] = v2;
+        v[2] = v3;
+        v[3] = v4;
+        return len & ~std::size_t{31};
+}
+
+Xxh64::Xxh64(uint64_t seed)
+{
+        reset(seed);
+}
+
+void Xxh64::reset(uint64_t seed)
+{
+        seed_ = seed;
+        v_[0] = seed + prime1 + prime2;
+        v_[1] = seed + prime2;
+        v_[2] = seed;
+        v_[3] = seed - prime1;
+        total_ = 0;
+        buf_len_ = 0;
+}
+
+void Xxh64::update(const void *data, std::size_t len)
+{
+        auto p = static_cast<const unsigned char *>(data);
+        total_ += len;
+        if (buf_len_ > 0) {
+                std::size_t n = sizeof(buf_) - buf_len_;
+                if (len < n) {
+                        std::memcpy(buf_ + buf_len_, p, len);
+                        buf_len_ += len;
+                        return;
+                }
+                std::memcpy(buf_ + buf_len_, p, n);
+                stripes(v_, buf_, sizeof(buf_));
+                buf_len_ = 0;
+                p += n;
+                len -= n;
+        }
+        std::size_t done = stripes(v_, p, len);
+        std::memcpy(buf_, p + done, len - done);
+        buf_len_ = len - done;
+}
+
+uint64_t Xxh64::digest() const
+{
+        uint64_t h;
+        if (total_ >= 32)
+                h = merge_round(merge_round(merge_round(merge_round(
+                                                rotl(v_[0], 1) +
+                                                rotl(v_[1], 7) +
+                                                rotl(v_[2], 12) +
+                                                rotl(v_[3], 18),
+                                                v_[0]), v_[1]), v_[2]), v_[3]);
+        else
+                h = seed_ + prime5;
+        h += total_;
+
+        const unsigned char *p = buf_;
+        const unsigned char *end = buf_ + buf_len_;
+        for (; p + 8 <= end; p += 8) {
+                h ^= round(0, read64(p));
+                h = rotl(h, 27) * prime1 + prime4;
+        }
+        if (p + 4 <= end) {
+                h ^= read32(p) * prime1;
+                h = rotl(h, 23) * prime2 + prime3;
+                p += 4;
+        }
+        for (; p < end; ++p) {
+                h ^= *p * prime5;
+                h = rotl(h, 11) * prime1;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+}
+
+uint64_t Xxh64::hash(const void *data, std::size_t len, uint64_t seed)
+{
+        Xxh64 h{seed};
+        h.update(data, len);
+        return h.digest();
+}
@@ -0,0 +1,65 @@
+/**
+ * Hash.hpp - the 64-bit xxHash of byte streams, for comparing file contents
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 00:31:09
+ */
+
+#ifndef HASH_HPP_
+#define HASH_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+class Xxh64 {
+private:
+        uint64_t v_[4];         // the accumulators of the four lanes
+        uint64_t total_{0};     // the number of bytes hashed
+        unsigned char buf_[32]; // the bytes of an incomplete stripe
+        std::size_t buf_len_{0};
+        uint64_t seed_;
+
+public:
+        /**
+         * @brief Start a hash
+         *
+         * @param seed The seed
+         */
+        explicit Xxh64(uint64_t seed = 0);
+
+        /**
+         * @brief Restart the hash
+         *
+         * @param seed The seed
+         */
+        void reset(uint64_t seed = 0);
+
+        /**
+         * @brief Hash more bytes
+         *
+         * @param data The bytes
+         * @param len The number of bytes
+         */
+        void update(const void *data, std::size_t len);
+
+        /**
+         * @brief Get the hash of the bytes so far, more can still be added
+         *
+         * @return The hash
+         */
+        uint64_t digest() const;
+
+        /**
+         * @brief Hash a block of bytes at once
+         *
+         * @param data The bytes
+         * @param len The number of bytes
+         * @param seed The seed
+         *
+         * @return The hash
+         */
+        static uint64_t hash(const void *data, std::size_t len,
+                        uint64_t seed = 0);
+};
+
+#endif
@@ -0,0 +1,397 @@
+/**
+ * Path.hpp - non-owning path views and reusable path buffers, for the path
+ *            work that should not allocate
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 17:31:08
+ */
+
+#ifndef PATH_HPP_
+#define PATH_HPP_
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <iterator>
+
+class Path_view {
+public:
+        class iterator;
+
+#if defined(__unix__)
+        static constexpr std::string_view separators{"/"}; // the separators
+#elif defined(_MSC_VER)
+        static constexpr std::string_view separators{"\\"}; // the separators
+#endif
+
+private:
+        std::string_view path_{};
+
+public:
+        Path_view() = default;
+
+        /**
+         * @brief Create a view of @path, the characters are not copied so
+         *        @path must outlive the view
+         *
+         * @param path The path
+         */
+        explicit Path_view(std::string_view path);
+
+        /**
+         * @brief Get the viewed path
+         *
+         * @return The path
+         */
+        std::string_view str() const;
+
+        /**
+         * @brief Check whether the path is empty
+         *
+         * @return True if it's empty, false otherwise
+         */
+        bool empty() const;
+
+        /**
+         * @brief Check whether the path is absolute
+         *
+         * @return True if it's absolute, false otherwise
+         */
+        bool is_absolute() const;
+
+        /**
+         * @brief Get the name of the file without the parent path
+         *
+         * @return The name of the file without the parent path
+         */
+        std::string_view get_name() const;
+
+        /**
+         * @brief Get the parent path
+         *
+         * @return The parent path, an empty view if not found
+         */
+        Path_view get_parent() const;
+
+        /**
+         * @brief Get the extension of the file
+         *
+         * @return The extension, an empty view when not found
+         */
+        std::string_view get_extension() const;
+
+        /**
+         * @brief Get the last separator in the path
+         *
+         * @return The index of the last separator, std::string_view::npos if
+         *         not found
+         */
+        std::string_view::size_type find_last_separator() const;
+
+        /**
+         * @brief Get an iterator to the first component, the components are
+         *        the non-empty parts between separators, so "/a//b/" has
+         *        the components "a" and "b"
+         *
+         * @return The iterator
+         */
+        iterator begin() const;
+
+        /**
+         * @brief Get the iterator past the last component
+         *
+         * @return The iterator
+         */
+        iterator end() const;
+};
+
+class Path_view::iterator {
+private:
+        std::string_view path_{};
+        std::string_view::size_type pos_{std::string_view::npos};
+        std::string_view comp_{};
+
+public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        iterator() = default;
+
+        iterator(std::string_view path, std::string_view::size_type pos):
+                path_(path), pos_(pos)
+        {
+                find();
+        }
+
+        reference operator*() const
+        {
+                return comp_;
+        }
+
+        pointer operator->() const
+        {
+                return &comp_;
+        }
+
+        iterator &operator++()
+        {
+                pos_ += comp_.size();
+                find();
+                return *this;
+        }
+
+        iterator operator++(int)
+        {
+                iterator it = *this;
+                ++*this;
+                return it;
+        }
+
+        bool operator==(const iterator &it) const
+        {
+                return pos_ == it.pos_;
+        }
+
+        bool operator!=(const iterator &it) const
+        {
+                return pos_ != it.pos_;
+        }
+
+private:
+        /**
+         * @brief Move to the component starting at or after @pos_
+         */
+        void find()
+        {
+                if (pos_ == std::string_view::npos)
+                        return;
+                pos_ = path_.find_first_not_of(separators, pos_);
+                if (pos_ == std::string_view::npos)
+                        return;
+                auto end = path_.find_first_of(separators, pos_);
+                comp_ = path_.substr(pos_, end == std::string_view::npos ?
+                                end : end - pos_);
+        }
+};
+
+class Path_buffer {
+private:
+        std::string buf_{""};
+
+public:
+        Path_buffer() = default;
+        ~Path_buffer() = default;
+
+        /**
+         * @brief Create a buffer holding @path
+         *
+         * @param path The path
+         */
+        explicit Path_buffer(std::string_view path);
+
+        /**
+         * @brief Replace the content with @path, keeping the storage
+         *
+         * @param path The path
+         *
+         * @return This buffer
+         */
+        Path_buffer &assign(std::string_view path);
+
+        /**
+         * @brief Replace the content with @parent + separator + @child,
+         *        keeping the storage
+         *
+         * @param parent The parent path
+         * @param child The child path
+         *
+         * @return This buffer
+         */
+        Path_buffer &join(std::string_view parent, std::string_view child);
+
+        /**
+         * @brief Append a separator and @child, unless the path is empty or
+         *        already ends with a separator
+         *
+         * @param child The child path
+         *
+         * @return The size before appending, pass it to truncate() to go
+         *         back to the parent
+         */
+        std::size_t push(std::string_view child);
+
+        /**
+         * @brief Remove the last component and the separator before it
+         *
+         * @return This buffer
+         */
+        Path_buffer &pop();
+
+        /**
+         * @brief Cut the path to the given size
+         *
+         * @param size The new size, usually returned by push()
+         */
+        void truncate(std::size_t size);
+
+        /**
+         * @brief Reserve storage for paths of @size characters
+         *
+         * @param size The number of characters
+         */
+        void reserve(std::size_t size);
+
+        /**
+         * @brief Get the path
+         *
+         * @return The path, valid until the buffer changes
+         */
+        const std::string &str() const;
+
+        /**
+         * @brief Get the null-terminated path
+         *
+         * @return The path, valid until the buffer changes
+         */
+        const char *c_str() const;
+
+        /**
+         * @brief Get a view of the path
+         *
+         * @return The view, valid until the buffer changes
+         */
+        Path_view view() const;
+};
+
+inline Path_view::Path_view(std::string_view path): path_(path)
+{
+}
+
+inline std::string_view Path_view::str() const
+{
+        return path_;
+}
+
+inline bool Path_view::empty() const
+{
+        return path_.empty();
+}
+
+inline bool Path_view::is_absolute() const
+{
+#if defined(__unix__)
+        return !path_.empty() && path_[0] == '/';
+#elif defined(_MSC_VER)
+        return (path_.size() > 2 && path_[1] == ':' &&
+                        separators.find(path_[2]) != std::string_view::npos) ||
+                (path_.size() > 1 && path_[0] == '\\' && path_[1] == '\\');
+#endif
+}
+
+inline std::string_view::size_type Path_view::find_last_separator() const
+{
+        return path_.find_last_of(separators);
+}
+
+inline std::string_view Path_view::get_name() const
+{
+        auto pos = find_last_separator();
+        if (pos != std::string_view::npos)
+                return path_.substr(pos + 1);
+        return path_;
+}
+
+inline Path_view Path_view::get_parent() const
+{
+        auto pos = find_last_separator();
+        if (pos != std::string_view::npos)
+                return Path_view{path_.substr(0, pos)};
+        return Path_view{};
+}
+
+inline std::string_view Path_view::get_extension() const
+{
+        auto spos = find_last_separator();
+        auto dpos = path_.find_last_of('.');
+        if (dpos != std::string_view::npos && dpos != 0 &&
+                        (spos == std::string_view::npos || dpos > spos))
+                return path_.substr(dpos + 1);
+        return std::string_view{};
+}
+
+inline Path_view::iterator Path_view::begin() const
+{
+        return iterator{path_, 0};
+}
+
+inline Path_view::iterator Path_view::end() const
+{
+        return iterator{};
+}
+
+inline Path_buffer::Path_buffer(std::string_view path): buf_(path)
+{
+}
+
+inline Path_buffer &Path_buffer::assign(std::string_view path)
+{
+        buf_.assign(path);
+        return *this;
+}
+
+inline Path_buffer &Path_buffer::join(std::string_view parent,
+                std::string_view child)
+{
+        buf_.assign(parent);
+        buf_.append(Path_view::separators.substr(0, 1));
+        buf_.append(child);
+        return *this;
+}
+
+inline std::size_t Path_buffer::push(std::string_view child)
+{
+        std::size_t size = buf_.size();
+        if (!buf_.empty() &&
+                        Path_view::separators.find(buf_.back()) ==
+                        std::string_view::npos)
+                buf_.append(Path_view::separators.substr(0, 1));
+        buf_.append(child);
+        return size;
+}
+
+inline Path_buffer &Path_buffer::pop()
+{
+        auto pos = view().find_last_separator();
+        buf_.resize(pos == std::string::npos ? 0 : pos);
+        return *this;
+}
+
+inline void Path_buffer::truncate(std::size_t size)
+{
+        buf_.resize(size);
+}
+
+inline void Path_buffer::reserve(std::size_t size)
+{
+        buf_.reserve(size);
+}
+
+inline const std::string &Path_buffer::str() const
+{
+        return buf_;
+}
+
+inline const char *Path_buffer::c_str() const
+{
+        return buf_.c_str();
+}
+
+inline Path_view Path_buffer::view() const
+{
+        return Path_view{buf_};
+}
+
+#endif
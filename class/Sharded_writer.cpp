@@ -0,0 +1,247 @@
+/**
+ * Sharded_writer.cpp - many threads appending records to a file each of
+ *                      their own, merged into one file in order on demand
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 03:26:40
+ */
+
+#include "Sharded_writer.hpp"
+#include "File.hpp"
+#include "File_reader.hpp"
+#include "File_writer.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+
+using std::string;
+
+const std::size_t Sharded_writer::default_buffer_size = 64 * 1024;
+
+/* the stamp and the length before every record */
+static const std::size_t header_size = sizeof(uint64_t) + sizeof(uint32_t);
+
+/* the writers ever made, so that no two share an id */
+static std::atomic<unsigned long long> writers{0};
+
+namespace {
+
+/* reads the records of a shard one by one through a buffer */
+class Cursor {
+private:
+        File_reader in_;
+        std::string buf_;
+        std::size_t pos_{0};
+        std::size_t end_{0};
+
+public:
+        uint64_t stamp{0};
+        const char *data{nullptr};
+        uint32_t len{0};
+
+        explicit Cursor(const string &pathname): in_(pathname),
+                buf_(Sharded_writer::default_buffer_size, '\0')
+        {
+        }
+
+        bool ready()
+        {
+                return in_.ready();
+        }
+
+        /**
+         * @brief Move to the next record
+         *
+         * @param cut Set to true if the shard ends inside a record
+         *
+         * @return True if there is one, false at the end or when cut short
+         */
+        bool next(bool &cut)
+        {
+                cut = false;
+                if (!fill(header_size)) {
+                        cut = end_ > pos_;
+                        return false;
+                }
+                std::memcpy(&stamp, &buf_[pos_], sizeof(stamp));
+                std::memcpy(&len, &buf_[pos_ + sizeof(stamp)], sizeof(len));
+                if (!fill(header_size + len)) {
+                        cut = true;
+                        return false;
+                }
+                data = &buf_[pos_ + header_size];
+                pos_ += header_size + len;
+                return true;
+        }
+
+private:
+        /**
+         * @brief Make at least @n bytes from the current position buffered
+         *
+         * @param n The number of bytes
+         *
+         * @return True if they are, false if the shard ends before
+         */
+        bool fill(std::size_t n)
+        {
+                if (end_ - pos_ >= n)
+                        return true;
+                std::memmove(&buf_[0], &buf_[pos_], end_ - pos_);
+                end_ -= pos_;
+                pos_ = 0;
+                if (buf_.size() < n)
+                        buf_.resize(n);
+                while (end_ < n) {
+                        std::size_t got = in_.read(&buf_[end_],
+                                        buf_.size() - end_);
+                        if (got == 0)
+                                return false;
+                        end_ += got;
+                }
+                return true;
+        }
+};
+
+}
+
+Sharded_writer::Sharded_writer(const string &dir, const string &name,
+                std::size_t buf_size):
+        dir_(dir), name_(name), buf_size_(buf_size), id_(++writers)
+{
+}
+
+Sharded_writer::~Sharded_writer()
+{
+        flush();
+}
+
+bool Sharded_writer::write(const string &record)
+{
+        Shard *s = shard();
+        if (s->failed)
+                return false;
+        uint64_t stamp = seq_.fetch_add(1, std::memory_order_relaxed);
+        uint32_t len = static_cast<uint32_t>(record.size());
+        char header[header_size];
+        std::memcpy(header, &stamp, sizeof(stamp));
+        std::memcpy(header + sizeof(stamp), &len, sizeof(len));
+        s->buf.append(header, header_size);
+        s->buf.append(record);
+        if (s->buf.size() >= buf_size_)
+                return drain(*s);
+        return true;
+}
+
+bool Sharded_writer::flush()
+{
+        std::lock_guard<std::mutex> lk(mtx_);
+        bool state = true;
+        for (auto &s : shards_)
+                state = drain(*s) && s->out.flush() && state;
+        return state;
+}
+
+bool Sharded_writer::merge(const string &pathname)
+{
+        return flush() && merge(shards(), pathname);
+}
+
+bool Sharded_writer::merge(const std::vector<string> &shards,
+                const string &pathname)
+{
+        std::vector<std::unique_ptr<Cursor>> cursors;
+        /* the smallest stamp on top, with the index of its cursor */
+        using Head = std::pair<uint64_t, std::size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+        bool cut = false;
+        for (const auto &shard : shards) {
+                cursors.push_back(std::make_unique<Cursor>(shard));
+                Cursor &c = *cursors.back();
+                if (!c.ready())
+                        return false;
+                if (c.next(cut))
+                        heap.emplace(c.stamp, cursors.size() - 1);
+                else if (cut)
+                        return false;
+        }
+
+        /* written aside and renamed over, a reader never sees half of it */
+        string tmp = pathname + ".tmp";
+        File::remove(tmp);
+        File_writer out(tmp);
+        if (!out.ready())
+                return false;
+        string buf;
+        bool state = true;
+        while (state && !heap.empty()) {
+                Cursor &c = *cursors[heap.top().second];
+                buf.append(c.data, c.len);
+                if (buf.size() >= default_buffer_size) {
+                        state = out.write(buf) == buf.size();
+                        buf.clear();
+                }
+                std::size_t i = heap.top().second;
+                heap.pop();
+                if (c.next(cut))
+                        heap.emplace(c.stamp, i);
+                else if (cut)
+                        state = false;
+        }
+        if (state && !buf.empty())
+                state = out.write(buf) == buf.size();
+        state = out.close() && state;
+        if (!state || !File::move(tmp, pathname)) {
+                File::remove(tmp);
+                return false;
+        }
+        return true;
+}
+
+std::vector<string> Sharded_writer::shards() const
+{
+        std::lock_guard<std::mutex> lk(mtx_);
+        std::vector<string> pathnames;
+        for (const auto &s : shards_)
+                pathnames.push_back(s->pathname);
+        return pathnames;
+}
+
+Sharded_writer::Shard *Sharded_writer::shard()
+{
+        /* the ids are never reused, so a dead writer's entry does no harm */
+        thread_local std::vector<std::pair<unsigned long long, Shard *>> own;
+        for (const auto &p : own)
+                if (p.first == id_)
+                        return p.second;
+
+        auto s = std::make_unique<Shard>();
+        Shard *p = s.get();
+        {
+                std::lock_guard<std::mutex> lk(mtx_);
+                p->pathname = File(dir_, name_ + "." +
+                                std::to_string(shards_.size())).get_path();
+                shards_.push_back(std::move(s));
+        }
+        File::remove(p->pathname);
+        p->failed = !p->out.open(p->pathname);
+        p->buf.reserve(buf_size_ + header_size);
+        own.emplace_back(id_, p);
+        return p;
+}
+
+bool Sharded_writer::drain(Shard &s)
+{
+        if (s.buf.empty())
+                return !s.failed;
+        if (s.failed || s.out.write(s.buf) != s.buf.size())
+                s.failed = true;
+        s.buf.clear();
+        return !s.failed;
+}
@@ -0,0 +1,144 @@
+/**
+ * Sharded_writer.hpp - many threads appending records to a file each of
+ *                      their own, merged into one file in order on demand
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 03:26:40
+ */
+
+#ifndef SHARDED_WRITER_HPP_
+#define SHARDED_WRITER_HPP_
+
+#include "File_writer.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+
+/*
+ * A File_writer shared by threads makes them take turns at its lock. Here
+ * every thread appends to a shard of its own, buffered in memory and
+ * written out in big blocks, so the threads share nothing but a counter
+ * giving every record its sequence stamp.
+ *
+ * A shard is a run of records, each an 8-byte stamp, a 4-byte length and
+ * the bytes of the record, in the byte order of the machine. The stamps in
+ * a shard increase, so merging the shards is a k-way merge streaming
+ * through all of them at once.
+ */
+class Sharded_writer {
+public:
+        static const std::size_t default_buffer_size;   // 64 KiB
+
+private:
+        struct Shard {
+                File_writer out;
+                std::string buf;
+                std::string pathname;
+                bool failed{false};
+        };
+
+        std::string dir_;
+        std::string name_;
+        std::size_t buf_size_;
+        const unsigned long long id_;   // tells the writers apart for the
+                                        // shard cached by every thread
+        std::atomic<unsigned long long> seq_{0};
+        mutable std::mutex mtx_;        // guards @shards_ as threads join
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+public:
+        Sharded_writer(const Sharded_writer &) = delete;
+        Sharded_writer &operator=(const Sharded_writer &) = delete;
+
+        /**
+         * @brief Create a Sharded_writer, the shards are named @name.0,
+         *        @name.1 and so on in @dir and made as threads first write,
+         *        replacing the old files of the names
+         *
+         * @param dir The directory of the shards, it must exist
+         * @param name The prefix of the shard names
+         * @param buf_size The bytes buffered for a shard before it's written
+         */
+        Sharded_writer(const std::string &dir, const std::string &name,
+                        std::size_t buf_size = default_buffer_size);
+
+        /**
+         * @brief Flush and close the shards, the files are left in place
+         */
+        ~Sharded_writer();
+
+        /**
+         * @brief Append a record to the shard of the calling thread, no lock
+         *        is taken but the first time a thread writes
+         *
+         * @param record The record, any bytes
+         *
+         * @return True if succeeded and false if the shard failed to open or
+         *         to be written
+         */
+        bool write(const std::string &record);
+
+        /**
+         * @brief Write out the buffered records of every shard, no thread
+         *        may be writing meanwhile
+         *
+         * @return True if succeeded and false if failed
+         */
+        bool flush();
+
+        /**
+         * @brief Flush the shards and merge them into a file in the order
+         *        of the stamps, no thread may be writing meanwhile, the
+         *        shards are kept and can be written further
+         *
+         * @param pathname The pathname of the merged file, replaced as a
+         *        whole
+         *
+         * @return True if succeeded and false if failed
+         */
+        bool merge(const std::string &pathname);
+
+        /**
+         * @brief Merge shard files into a file in the order of the stamps,
+         *        e.g. the ones left by another process
+         *
+         * @param shards The pathnames of the shards
+         * @param pathname The pathname of the merged file, replaced as a
+         *        whole, holding the records without stamps
+         *
+         * @return True if succeeded and false if a shard could not be read
+         *         or is cut short, or the file could not be written
+         */
+        static bool merge(const std::vector<std::string> &shards,
+                        const std::string &pathname);
+
+        /**
+         * @brief Get the pathnames of the shards made so far
+         *
+         * @return The pathnames, in the order the threads first wrote
+         */
+        std::vector<std::string> shards() const;
+
+private:
+        /**
+         * @brief Get the shard of the calling thread, made on the first call
+         *
+         * @return The shard
+         */
+        Shard *shard();
+
+        /**
+         * @brief Write out the buffered records of a shard
+         *
+         * @param s The shard
+         *
+         * @return True if succeeded and false if failed
+         */
+        static bool drain(Shard &s);
+};
+
+#endif
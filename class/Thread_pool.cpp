@@ -0,0 +1,115 @@
+/**
+ * Thread_pool.cpp - a work-stealing thread pool for the file operations
+ *                   that fan out over many files
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 14:58:37
+ */
+
+#include "Thread_pool.hpp"
+
+#include <utility>
+
+/* the pool and the worker index of the calling thread, if it's a worker */
+static thread_local Thread_pool *current_pool = nullptr;
+static thread_local unsigned int current_id = 0;
+
+Thread_pool::Thread_pool(unsigned int n)
+{
+        if (n == 0)
+                n = std::thread::hardware_concurrency();
+        if (n == 0)
+                n = 1;
+        for (unsigned int i = 0; i < n; ++i)
+                queues_.emplace_back(new Queue);
+        for (unsigned int i = 0; i < n; ++i)
+                threads_.emplace_back(&Thread_pool::run, this, i);
+}
+
+Thread_pool::~Thread_pool()
+{
+        wait();
+        {
+                std::lock_guard<std::mutex> lk(mtx_);
+                stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &t : threads_)
+                t.join();
+}
+
+void Thread_pool::submit(Task task)
+{
+        unsigned int id;
+        if (current_pool == this)
+                id = current_id;
+        else
+                id = next_.fetch_add(1, std::memory_order_relaxed) %
+                        queues_.size();
+        pending_.fetch_add(1);
+        {
+                std::lock_guard<std::mutex> lk(queues_[id]->mtx);
+                queues_[id]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1);
+        {
+                /* taken so that a worker about to sleep can't miss it */
+                std::lock_guard<std::mutex> lk(mtx_);
+        }
+        work_cv_.notify_one();
+}
+
+void Thread_pool::wait()
+{
+        std::unique_lock<std::mutex> lk(mtx_);
+        done_cv_.wait(lk, [this] { return pending_.load() == 0; });
+}
+
+bool Thread_pool::take(unsigned int id, Task &task)
+{
+        {
+                Queue &q = *queues_[id];
+                std::lock_guard<std::mutex> lk(q.mtx);
+                if (!q.tasks.empty()) {
+                        task = std::move(q.tasks.back());
+                        q.tasks.pop_back();
+                        queued_.fetch_sub(1);
+                        return true;
+                }
+        }
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+                Queue &q = *queues_[(id + i) % queues_.size()];
+                std::lock_guard<std::mutex> lk(q.mtx);
+                if (!q.tasks.empty()) {
+                        task = std::move(q.tasks.front());
+                        q.tasks.pop_front();
+                        queued_.fetch_sub(1);
+                        return true;
+                }
+        }
+        return false;
+}
+
+void Thread_pool::run(unsigned int id)
+{
+        current_pool = this;
+        current_id = id;
+        Task task;
+        for (;;) {
+                if (take(id, task)) {
+                        task();
+                        task = nullptr;
+                        if (pending_.fetch_sub(1) == 1) {
+                                std::lock_guard<std::mutex> lk(mtx_);
+                                done_cv_.notify_all();
+                        }
+                        continue;
+                }
+                std::unique_lock<std::mutex> lk(mtx_);
+                work_cv_.wait(lk, [this] {
+                        return stop_ || queued_.load() > 0;
+                });
+                if (stop_ && queued_.load() == 0)
+                        return;
+        }
+}
@@ -0,0 +1,107 @@
+/**
+ * Thread_pool.hpp - a work-stealing thread pool for the file operations
+ *                   that fan out over many files
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 14:40:12
+ */
+
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+class Thread_pool {
+public:
+        using Task = std::function<void()>;
+
+private:
+        /* every worker owns a queue, it takes its own tasks from the back
+         * and the idle workers steal from the front */
+        struct Queue {
+                std::mutex mtx;
+                std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex mtx_;                        // guards the sleeping
+        std::condition_variable work_cv_;       // signaled on new tasks
+        std::condition_variable done_cv_;       // signaled when all done
+        std::atomic<std::size_t> queued_{0};    // tasks waiting in queues
+        std::atomic<std::size_t> pending_{0};   // tasks not finished yet
+        std::atomic<std::size_t> next_{0};      // round-robin for outsiders
+        bool stop_{false};
+
+public:
+        Thread_pool(const Thread_pool &) = delete;
+        Thread_pool &operator=(const Thread_pool &) = delete;
+
+        /**
+         * @brief Start a pool with @n worker threads
+         *
+         * @param n The number of workers, 0 means one per hardware thread
+         */
+        explicit Thread_pool(unsigned int n = 0);
+
+        /**
+         * @brief Wait for all tasks and stop the workers
+         */
+        ~Thread_pool();
+
+        /**
+         * @brief Get the number of worker threads
+         *
+         * @return The number of worker threads
+         */
+        unsigned int size() const;
+
+        /**
+         * @brief Queue a task, a task submitted by a worker goes to the
+         *        worker's own queue so that related work stays together
+         *
+         * @param task The task
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Wait until every submitted task has finished, including the
+         *        ones submitted by the tasks themselves, must not be called
+         *        from a worker
+         */
+        void wait();
+
+private:
+        /**
+         * @brief The loop of a worker thread
+         *
+         * @param id The index of the worker
+         */
+        void run(unsigned int id);
+
+        /**
+         * @brief Take a task, from the own queue first and from the others
+         *        when it's empty
+         *
+         * @param id The index of the worker
+         * @param task The Task to store the task taken
+         *
+         * @return True if a task was taken, false otherwise
+         */
+        bool take(unsigned int id, Task &task);
+};
+
+inline unsigned int Thread_pool::size() const
+{
+        return static_cast<unsigned int>(threads_.size());
+}
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * bench_lock.cpp - measure the lock contention of processes writing to
+ *                  disjoint regions of one file
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/19 11:02:15
+ */
+
+#include "File.hpp"
+#include "File_writer.hpp"
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+static const int block = 4096;
+static const int rounds = 20000;
+
+/* every process rewrites its own block, with the old whole-file flock */
+static void run_flock(const string &pathname, int id)
+{
+        int fd = ::open(pathname.c_str(), O_WRONLY);
+        string buf(block, 'a' + id % 26);
+        for (int i = 0; i < rounds; ++i) {
+                flock(fd, LOCK_EX);
+                pwrite(fd, buf.data(), block, static_cast<off_t>(id) * block);
+                flock(fd, LOCK_UN);
+        }
+        ::close(fd);
+}
+
+/* every process rewrites its own block, with the OFD range lock */
+static void run_ofd(const string &pathname, int id)
+{
+        int fd = ::open(pathname.c_str(), O_WRONLY);
+        string buf(block, 'a' + id % 26);
+        struct flock fl{};
+        fl.l_whence = SEEK_SET;
+        fl.l_start = static_cast<off_t>(id) * block;
+        fl.l_len = block;
+        for (int i = 0; i < rounds; ++i) {
+                fl.l_type = F_WRLCK;
+                fcntl(fd, F_OFD_SETLKW, &fl);
+                pwrite(fd, buf.data(), block, fl.l_start);
+                fl.l_type = F_UNLCK;
+                fcntl(fd, F_OFD_SETLK, &fl);
+        }
+        ::close(fd);
+}
+
+/* every process rewrites its own block through File_writer */
+static void run_writer(const string &pathname, int id)
+{
+        File_writer fw(pathname);
+        string buf(block, 'a' + id % 26);
+        for (int i = 0; i < rounds; ++i) {
+                fw.file_seek(static_cast<long long>(id) * block, FILE_BEGIN);
+                fw.write(buf);
+                fw.flush();
+        }
+}
+
+static double bench(const string &pathname, int nproc,
+                void (*run)(const string &, int))
+{
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nproc; ++i) {
+                if (fork() == 0) {
+                        run(pathname, i);
+                        _exit(0);
+                }
+        }
+        for (int i = 0; i < nproc; ++i)
+                wait(nullptr);
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+int main()
+{
+        string pathname = "." + File::separator + "bench_lock.dat";
+        File::create_new_file(pathname);
+
+        cout << "procs\tflock(s)\tofd(s)\tFile_writer(s)" << endl;
+        for (int n = 1; n <= 8; n *= 2) {
+                cout << n << "\t" << bench(pathname, n, run_flock) << "\t"
+                        << bench(pathname, n, run_ofd) << "\t"
+                        << bench(pathname, n, run_writer) << endl;
+        }
+
+        File::remove(pathname);
+        return 0;
+}
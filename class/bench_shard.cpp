@@ -0,0 +1,94 @@
+/**
+ * bench_shard.cpp - measure threads appending records to one File_writer
+ *                   against a Sharded_writer
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 03:26:40
+ */
+
+#include "File.hpp"
+#include "File_writer.hpp"
+#include "Sharded_writer.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <iostream>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+static const int records = 200000;
+
+static double bench(int nthreads, void (*run)(int, void *), void *arg)
+{
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < nthreads; ++i)
+                threads.emplace_back(run, records / nthreads, arg);
+        for (auto &t : threads)
+                t.join();
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+/* the threads share one writer, so they take turns at it */
+static std::mutex shared_mtx;
+
+static void run_shared(int n, void *arg)
+{
+        auto *fw = static_cast<File_writer *>(arg);
+        string line(100, 'x');
+        line.back() = '\n';
+        for (int i = 0; i < n; ++i) {
+                std::lock_guard<std::mutex> lk(shared_mtx);
+                fw->append(line);
+        }
+}
+
+static void run_sharded(int n, void *arg)
+{
+        auto *sw = static_cast<Sharded_writer *>(arg);
+        string line(100, 'x');
+        line.back() = '\n';
+        for (int i = 0; i < n; ++i)
+                sw->write(line);
+}
+
+int main()
+{
+        string dir = ".";
+        string shared = File(dir, "bench_shard.dat").get_path();
+        string merged = File(dir, "bench_shard.out").get_path();
+
+        cout << "threads\tshared(s)\tsharded(s)\tmerge(s)" << endl;
+        for (int n = 1; n <= 8; n *= 2) {
+                File::remove(shared);
+                double t_shared, t_sharded, t_merge;
+                {
+                        File_writer fw(shared);
+                        t_shared = bench(n, run_shared, &fw);
+                }
+                {
+                        Sharded_writer sw(dir, "bench_shard");
+                        t_sharded = bench(n, run_sharded, &sw);
+                        auto start = std::chrono::steady_clock::now();
+                        sw.merge(merged);
+                        std::chrono::duration<double> d =
+                                std::chrono::steady_clock::now() - start;
+                        t_merge = d.count();
+                        for (const auto &s : sw.shards())
+                                File::remove(s);
+                }
+                cout << n << "\t" << t_shared << "\t" << t_sharded << "\t"
+                        << t_merge << endl;
+        }
+
+        File::remove(shared);
+        File::remove(merged);
+        return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * test_Dedup.cpp - test the Xxh64 and Dedup class
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 01:20:15
+ */
+
+#include "File.hpp"
+#include "File_writer.hpp"
+#include "Hash.hpp"
+#include "Dedup.hpp"
+
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+void test_hash()
+{
+        assert(Xxh64::hash("", 0) == 0xef46db3751d8e999ULL);
+        assert(Xxh64::hash("a", 1) == 0xd24ec4f1a98c6e5bULL);
+        assert(Xxh64::hash("abc", 3) == 0x44bc2cf5ad770999ULL);
+        string s = "Nobody inspects the spammish repetition";
+        assert(Xxh64::hash(s.data(), s.size()) == 0xfbcea83c8a378bf1ULL);
+
+        /* the same hash however the bytes are fed */
+        string big(1000, '\0');
+        for (std::size_t i = 0; i < big.size(); ++i)
+                big[i] = static_cast<char>(i * 7);
+        Xxh64 h;
+        for (std::size_t i = 0; i < big.size(); i += 13)
+                h.update(big.data() + i, std::min<std::size_t>(13,
+                                        big.size() - i));
+        assert(h.digest() == Xxh64::hash(big.data(), big.size()));
+        assert(Xxh64::hash("abc", 3, 1) != Xxh64::hash("abc", 3));
+}
+
+static void write_file(const string &pathname, const string &s)
+{
+        File_writer fw(pathname);
+        assert(fw.write(s) == s.size());
+}
+
+void test_dedup(const string &root)
+{
+        const string &sep = File::separator;
+        auto path = [&](const char *name) {
+                return root + sep + name;
+        };
+        string big(10000, 'x');
+        string tail = big, head = big;
+        tail.back() = 'y';
+        head.front() = 'y';
+
+        assert(File::mkdir(root));
+        assert(File::mkdir(path("d")));
+        write_file(path("a1"), big);
+        write_file(path("d/a2"), big);
+        write_file(path("b1"), tail);   // only the whole contents differ
+        write_file(path("c1"), head);   // the prefix differs
+        write_file(path("s1"), "hello");
+        write_file(path("d/s2"), "hello");
+        write_file(path("s3"), "world");
+        write_file(path("u"), "unique size");
+        assert(File::create_new_file(path("e1")));
+        assert(File::create_new_file(path("e2")));
+        assert(link(path("a1").c_str(), path("h").c_str()) == 0);
+
+        Dedup::Options opt;
+        opt.threads = 4;
+        Dedup dedup(opt);
+        assert(dedup.add_tree(root));
+        auto groups = dedup.run();
+        assert(groups.size() == 2);
+        assert(groups[0].size == 10000);
+        assert(groups[0].files == (std::vector<Dedup::Links>{
+                                {path("a1"), path("h")}, {path("d/a2")}}));
+        assert(groups[1].size == 5);
+        assert(groups[1].files == (std::vector<Dedup::Links>{
+                                {path("d/s2")}, {path("s1")}}));
+
+        const Dedup::Stats &st = dedup.stats();
+        assert(st.files == 11 && st.inodes == 10);
+        assert(st.same_size == 7 && st.same_prefix == 5);
+        assert(st.fully_read == 3);
+
+        /* the empty files are the same too when asked for */
+        opt.min_size = 0;
+        Dedup all(opt);
+        all.add({path("e1"), path("e2"), path("s1"), path("d"),
+                        path("none")});
+        groups = all.run();
+        assert(groups.size() == 1 && groups[0].size == 0);
+        assert(all.stats().files == 3);
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Dedup.d";
+        system((string{"rm -rf "} + root).c_str());
+
+        cout << "Start testing class Xxh64" << endl;
+        test_hash();
+        cout << "End testing." << endl;
+
+        cout << "Start testing class Dedup" << endl;
+        test_dedup(root);
+        cout << "End testing." << endl;
+
+        system((string{"rm -rf "} + root).c_str());
+        return 0;
+}
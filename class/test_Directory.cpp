@@ -0,0 +1,273 @@
+/**
+ * test_Directory.cpp - test the Directory and Directory_walker class and the
+ *                      File queries over directory trees
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 02:15:38
+ */
+
+#include "File.hpp"
+#include "Directory.hpp"
+#include "Directory_walker.hpp"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <assert.h>
+#include <iostream>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+/* build root/{a/{1,2,b/{3}},c/{4},5} and a link root/l -> a */
+static void make_tree(const string &root)
+{
+        const string &sep = File::separator;
+        assert(File::mkdir(root));
+        assert(File::mkdir(root + sep + "a"));
+        assert(File::mkdir(root + sep + "a" + sep + "b"));
+        assert(File::mkdir(root + sep + "c"));
+        assert(File::create_new_file(root + sep + "a" + sep + "1"));
+        assert(File::create_new_file(root + sep + "a" + sep + "2"));
+        assert(File::create_new_file(root + sep + "a" + sep + "b" + sep + "3"));
+        assert(File::create_new_file(root + sep + "c" + sep + "4"));
+        assert(File::create_new_file(root + sep + "5"));
+        assert(symlink("a", (root + sep + "l").c_str()) == 0);
+}
+
+static void remove_tree(const string &root)
+{
+        system((string{"rm -rf "} + root).c_str());
+}
+
+static std::set<string> walk(Directory_walker &w, const string &root)
+{
+        std::mutex mtx;
+        std::set<string> seen;
+        bool state = w.walk(root, [&](const Directory_walker::Entry &e) {
+                std::lock_guard<std::mutex> lk(mtx);
+                seen.emplace(e.path.substr(root.size() + 1));
+        });
+        assert(state);
+        return seen;
+}
+
+void test_walker(const string &root)
+{
+        Directory_walker::Options opt;
+        opt.threads = 4;
+
+        Directory_walker w1(opt);
+        auto seen = walk(w1, root);
+        assert(seen == (std::set<string>{"a", "a/1", "a/2", "a/b", "a/b/3",
+                                "c", "c/4", "5", "l"}));
+
+        opt.max_depth = 1;
+        Directory_walker w2(opt);
+        assert(walk(w2, root) == (std::set<string>{"a", "c", "5", "l"}));
+
+        opt.max_depth = -1;
+        opt.symlinks = Directory_walker::skip;
+        Directory_walker w3(opt);
+        w3.set_prune([](const Directory_walker::Entry &e) {
+                return e.name == "a";
+        });
+        w3.set_filter([](const Directory_walker::Entry &e) {
+                return e.type == Directory_reader::file;
+        });
+        assert(walk(w3, root) == (std::set<string>{"c/4", "5"}));
+
+        opt.symlinks = Directory_walker::follow;
+        Directory_walker w4(opt);
+        std::atomic<int> n{0};
+        assert(w4.walk(root, [&](const Directory_walker::Entry &e) {
+                if (e.name == "l")
+                        assert(e.type == Directory_reader::directory);
+                ++n;
+        }));
+        /* a and l are the same directory, only one of them is walked */
+        assert(n == 9);
+
+        Directory_walker w5(opt);
+        assert(!w5.walk(root + File::separator + "5",
+                                [](const Directory_walker::Entry &) {}));
+}
+
+/* apparent size of the entry itself */
+static long long size_of(const string &pathname)
+{
+        return File::status_at(AT_FDCWD, pathname, false).size;
+}
+
+void test_usage(const string &root)
+{
+        const string &sep = File::separator;
+        string a = root + sep + "a";
+        string five = root + sep + "5";
+        assert(truncate(five.c_str(), 1000) == 0);
+        assert(link(five.c_str(), (a + sep + "h").c_str()) == 0);
+
+        File::Usage u;
+        assert(File::disk_usage(five, u));
+        assert(u.size == 1000 && u.files == 1 && u.dirs == 0);
+        assert(!File::disk_usage(root + sep + "6", u));
+
+        std::mutex mtx;
+        std::map<string, File::Usage> done;
+        std::vector<string> order;
+        File::Usage_options opt;
+        opt.threads = 4;
+        assert(File::disk_usage(root, u, opt, [&](const string &path,
+                                        const File::Usage &usage) {
+                std::lock_guard<std::mutex> lk(mtx);
+                done[path] = usage;
+                order.push_back(path);
+        }));
+        /* 1 2 3 4 5 l, and h is a hard link of 5 */
+        assert(u.files == 6 && u.dirs == 4);
+        assert(done.size() == 4 && order.back() == root);
+        assert(done[root].size == u.size && done[root].files == u.files);
+        /* the files are empty, and 5 is counted either as itself or as h */
+        string c = root + sep + "c";
+        assert(u.size == size_of(root) + size_of(a) + size_of(a + sep + "b") +
+                        size_of(c) + size_of(root + sep + "l") + 1000);
+        assert(done[c].size == size_of(c));
+        assert(done[c].files == 1 && done[c].dirs == 1);
+        long long sa = size_of(a) + done[a + sep + "b"].size;
+        assert(done[a].size == sa || done[a].size == sa + 1000);
+        auto pos = [&](const string &path) {
+                for (std::size_t i = 0; i < order.size(); ++i)
+                        if (order[i] == path)
+                                return i;
+                return order.size();
+        };
+        assert(pos(a + sep + "b") < pos(a));
+
+        opt.count_links = true;
+        File::Usage all;
+        assert(File::disk_usage(root, all, opt));
+        assert(all.files == 7 && all.size == u.size + 1000);
+
+        assert(unlink((a + sep + "h").c_str()) == 0);
+        assert(truncate(five.c_str(), 0) == 0);
+}
+
+void test_tree_ops(const string &root)
+{
+        const string &sep = File::separator;
+        string copy = root + ".copy";
+        string deep = copy + sep + "x" + sep + "y" + sep + "z";
+
+        assert(File::create_directories(deep));
+        assert(File::is_directory(deep));
+        assert(File::create_directories(deep));
+        assert(!File::create_directories(root + sep + "5" + sep + "x"));
+        assert(File::remove_all(copy));
+        assert(!File::exists(copy));
+
+        int fd = open((root + sep + "c" + sep + "4").c_str(), O_WRONLY);
+        assert(fd != -1 && write(fd, "hello", 5) == 5);
+        close(fd);
+
+        File::Tree_report report;
+        std::atomic<unsigned long long> calls{0};
+        auto progress = [&calls](std::string_view, unsigned long long) {
+                ++calls;
+        };
+        /* the root, 4 directories, 5 files and a link */
+        assert(File::copy_all(root, copy, report, 4, progress));
+        assert(report.done == 10 && calls == 10 && report.errors.empty());
+        Directory_walker w;
+        assert(walk(w, copy) == walk(w, root));
+        assert(File::status(copy + sep + "c" + sep + "4").size == 5);
+        char target[8] = {0};
+        assert(readlink((copy + sep + "l").c_str(), target, 7) == 1);
+        assert(string{target} == "a");
+
+        /* copying over the copy overwrites it */
+        assert(File::copy_all(root, copy));
+        string five = copy + sep + "5";
+        assert(File::copy_all(root + sep + "c" + sep + "4", five));
+        assert(File::status(five).size == 5);
+
+        calls = 0;
+        assert(File::remove_all(copy, report, 4, progress));
+        assert(report.done == 10 && calls == 10 && report.errors.empty());
+        assert(!File::exists(copy));
+
+        assert(!File::remove_all(copy, report));
+        assert(report.errors.size() == 1 && report.errors[0].error == ENOENT);
+        assert(!File::copy_all(root, copy + sep + "x", report));
+        assert(!report.errors.empty());
+        assert(truncate((root + sep + "c" + sep + "4").c_str(), 0) == 0);
+}
+
+void test_directory(const string &root)
+{
+        Directory d(root);
+        assert(d.ready());
+        assert(d.exists_at("5"));
+        assert(!d.exists_at("6"));
+        assert(d.stat_at("a").is_directory());
+        assert(d.stat_at("l").is_directory());
+        assert(d.stat_at("l", false).is_symlink());
+        assert(d.can_read_at("5") && d.can_write_at("5"));
+        assert(d.can_execute_at("a"));
+
+        Directory a(d, "a");
+        assert(a.ready());
+        assert(a.stat_at("b/3").is_file());
+        assert(!Directory(d, "5").ready());
+
+        int fd = a.open_at("6", O_WRONLY | O_CREAT);
+        assert(fd != -1);
+        assert(write(fd, "hello", 5) == 5);
+        close(fd);
+        assert(a.stat_at("6").size == 5);
+        assert(a.rename_at("6", d, "7"));
+        assert(!a.exists_at("6") && d.exists_at("7"));
+        assert(d.rename_at("7", "6"));
+        assert(d.unlink_at("6"));
+        assert(!d.unlink_at("6"));
+
+        assert(d.mkdir_at("e"));
+        assert(!d.mkdir_at("e"));
+        assert(d.stat_at("e").is_directory());
+        assert(d.unlink_at("e"));
+        assert(!d.exists_at("e"));
+        assert(d.close());
+        assert(!d.ready());
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Directory.d";
+        remove_tree(root);
+        make_tree(root);
+
+        cout << "Start testing class Directory" << endl;
+        test_directory(root);
+        cout << "End testing." << endl;
+
+        cout << "Start testing class Directory_walker" << endl;
+        test_walker(root);
+        cout << "End testing." << endl;
+
+        cout << "Start testing File::disk_usage" << endl;
+        test_usage(root);
+        cout << "End testing." << endl;
+
+        cout << "Start testing the File operations over trees" << endl;
+        test_tree_ops(root);
+        cout << "End testing." << endl;
+
+        remove_tree(root);
+        return 0;
+}
@@ -2,14 +2,19 @@
  * test_File.cpp - test the File class
  *
  * Created by Haoyuan Li on 2021/08/11
- * Last Modified: 2021/08/16 13:21:35
+ * Last Modified: 2026/10/20 13:31:20
  */
 
 #include "File.hpp"
+#include "Directory_reader.hpp"
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <assert.h>
 #include <iostream>
+#if defined(__unix__)
+#include <unistd.h>
+#endif
 
 using std::cout;
 using std::endl;
@@ -50,6 +55,9 @@ int main(int argc, char **argv)
         assert(f2.is_file());
         assert(!f2.is_directory());
         assert(File{f2.get_parent()}.is_directory());
+        assert(f2.status().is_file());
+        assert(f2.get_size() == File::get_size(f2.get_path()));
+        assert(f2.last_modified() == File::status(f2.get_path()).mtime);
         assert(!f2.is_hidden());
 
         File f3(s3);
@@ -66,6 +74,37 @@ int main(int argc, char **argv)
         cout << "The absolute path of " << f2.get_path() << " is " <<
                 f2.get_absolute_path() << endl << endl;
 
+#if defined(__unix__)
+        {
+                string cwd = File::get_absolute_path(".");
+                assert(File::get_absolute_path("./pc_x/f") == cwd + "/pc_x/f");
+                assert(File::mkdir("./pc_y"));
+                assert(File::mkdir("./pc_z"));
+                assert(symlink("pc_y", "pc_x") == 0);
+                assert(File::get_absolute_path("./pc_x/f") == cwd + "/pc_y/f");
+                assert(File::get_absolute_path("./pc_x") == cwd + "/pc_y");
+                /* a missing tail stays as given under the cached part */
+                assert(File::get_absolute_path("./pc_x/no/such/f") ==
+                                cwd + "/pc_y/no/such/f");
+                assert(File::get_absolute_path("./pc_x/no/such/f") ==
+                                cwd + "/pc_y/no/such/f");
+                /* changes made behind the back of File are seen too */
+                assert(unlink("pc_x") == 0 && symlink("pc_z", "pc_x") == 0);
+                assert(File::get_absolute_path("./pc_x/f") == cwd + "/pc_z/f");
+                assert(File::get_absolute_path("./pc_x/no/such/f") ==
+                                cwd + "/pc_z/no/such/f");
+                assert(File::get_absolute_path("/no_such_dir/a/b") ==
+                                "/no_such_dir/a/b");
+                assert(File::get_absolute_path("./g") == cwd + "/g");
+                assert(chdir("pc_y") == 0);
+                assert(File::get_absolute_path("./g") == cwd + "/pc_y/g");
+                assert(chdir("..") == 0);
+                assert(unlink("pc_x") == 0);
+                assert(File::get_absolute_path("./pc_x/f") == cwd + "/pc_x/f");
+                assert(File::remove("./pc_y") && File::remove("./pc_z"));
+        }
+#endif
+
         cout << "The last modified time of " << f2.get_path() << " is " <<
                 File::get_time_str(f2.last_modified()) << endl << endl;
 
@@ -97,9 +136,56 @@ int main(int argc, char **argv)
                 cout << s << " ";
         cout << endl << endl;
 
+        std::vector<string> names;
+        Directory_reader dr(f2.get_parent());
+        assert(dr.ready());
+        for (const auto &e : dr) {
+                assert(e.name != "." && e.name != "..");
+                if (e.name == s2)
+                        assert(e.type == Directory_reader::file ||
+                                        e.type == Directory_reader::unknown);
+                names.emplace_back(e.name);
+        }
+        auto all = File(f2.get_parent()).list();
+        assert(names.size() + 2 == all.size());
+        assert(std::find(names.begin(), names.end(), s2) != names.end());
+        assert(!Directory_reader(f2).ready());
+
+        std::vector<string> paths;
+        for (int i = 0; i < 100; ++i)
+                for (const auto &n : names)
+                        paths.push_back(f2.get_parent() + File::separator + n);
+        paths.push_back(f1.get_path());
+        std::vector<File::Status> sts;
+        File::status(paths, sts, 4);
+        assert(sts.size() == paths.size());
+        for (std::size_t i = 0; i + 1 < paths.size(); ++i)
+                assert(sts[i].exists &&
+                                sts[i].ino == File::status(paths[i]).ino);
+        assert(!sts.back().exists);
+
         assert(f1.get_extension() == "");
         assert(f2.get_extension() == "cpp");
 
+        Path_buffer pb;
+        pb.join(f2.get_parent(), "a.tar.gz");
+        assert(File::get_extension(pb.view()) == "gz");
+        assert(File::get_name(pb.view()) == "a.tar.gz");
+        assert(File::get_parent(pb.view()) == f2.get_parent());
+        auto size = pb.push("b");
+        assert(File::get_name(pb.view()) == "b");
+        pb.truncate(size);
+        assert(pb.str() == File(f2.get_parent(), "a.tar.gz").get_path());
+        assert(pb.pop().str() == f2.get_parent());
+        const string &sep = File::separator;
+        string p = "usr" + sep + sep + "local" + sep + "lib" + sep;
+        std::vector<std::string_view> comps;
+        for (auto c : Path_view{p})
+                comps.push_back(c);
+        assert(comps == (std::vector<std::string_view>{"usr", "local",
+                                "lib"}));
+        assert(!Path_view{p}.is_absolute());
+
         string s4;
 #if defined(__unix__)
         s4 = "./hello";
@@ -108,7 +194,16 @@ int main(int argc, char **argv)
 #endif
 
         File f4{s4};
+        assert(!f4.exists());
+        assert(File::create_new_file(s4));
+        assert(!f4.exists());   // still the old snapshot
+        assert(f4.refresh().is_file());
+        assert(f4.exists());
+        assert(f4.status().size == 0);
+        assert(File::remove(s4));
+        assert(f4.refresh().exists == false);
         assert(f4.create_new_file());
+        assert(f4.exists());
         cout << "Expected: information of file " << s4 << endl;
         ls(s4);
         cout << endl;
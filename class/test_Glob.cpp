@@ -0,0 +1,127 @@
+/**
+ * test_Glob.cpp - test the Glob class and File::glob
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 00:06:47
+ */
+
+#include "File.hpp"
+#include "Glob.hpp"
+
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <iostream>
+#include <cstdlib>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+static bool match(const string &pattern, const string &path)
+{
+        return Glob{pattern}.match(Path_view{path});
+}
+
+static bool can_descend(const string &pattern, const string &dir)
+{
+        return Glob{pattern}.can_descend(Path_view{dir});
+}
+
+void test_name()
+{
+        assert(Glob::match_name("*", ""));
+        assert(Glob::match_name("*.cpp", "a.cpp"));
+        assert(!Glob::match_name("*.cpp", "a.cpp.o"));
+        assert(Glob::match_name("a*b*c", "aXbYbZc"));
+        assert(!Glob::match_name("a*b*c", "aXbYbZ"));
+        assert(Glob::match_name("?.h", "a.h"));
+        assert(!Glob::match_name("?.h", "ab.h"));
+        assert(Glob::match_name("[abc]1", "b1"));
+        assert(!Glob::match_name("[abc]1", "d1"));
+        assert(Glob::match_name("[a-z][!0-9]", "qx"));
+        assert(!Glob::match_name("[a-z][^0-9]", "q1"));
+        assert(Glob::match_name("[]]", "]"));
+        assert(Glob::match_name("\\*", "*"));
+        assert(!Glob::match_name("\\*", "a"));
+        assert(!Glob::match_name("[ab", "a"));
+}
+
+void test_pattern()
+{
+        assert(match("*.cpp", "a.cpp"));
+        assert(!match("*.cpp", "src/a.cpp"));
+        assert(match("src/*.cpp", "src/a.cpp"));
+        assert(match("src/**/*.cpp", "src/a.cpp"));
+        assert(match("src/**/*.cpp", "src/x/y/a.cpp"));
+        assert(!match("src/**/*.cpp", "lib/a.cpp"));
+        assert(match("**", "a/b/c"));
+        assert(match("a/**", "a"));
+        assert(match("**/*.h", "x.h"));
+        assert(match("a/**/**/b", "a/b"));
+        assert(match("*.{cpp,hpp}", "a.hpp"));
+        assert(!match("*.{cpp,hpp}", "a.h"));
+        assert(match("{src,lib/{x,y}}/*.c", "lib/y/m.c"));
+        assert(!match("{src,lib/{x,y}}/*.c", "lib/z/m.c"));
+        assert(match("{a}", "{a}"));
+        assert(match("src//a", "src/a"));
+
+        assert(!Glob{""}.valid());
+        assert(!Glob{"{a,b"}.valid());
+        assert(!Glob{"[a"}.valid());
+        assert(!match("{a,b", "a"));
+
+        assert(can_descend("src/**/*.cpp", ""));
+        assert(can_descend("src/**/*.cpp", "src"));
+        assert(can_descend("src/**/*.cpp", "src/x/y"));
+        assert(!can_descend("src/**/*.cpp", "docs"));
+        assert(can_descend("src/*.cpp", "src"));
+        assert(!can_descend("src/*.cpp", "src/x"));
+        assert(!can_descend("*.cpp", "x"));
+        assert(can_descend("{src,lib}/*.c", "lib"));
+        assert(!can_descend("{src,lib}/*.c", "bin"));
+}
+
+void test_glob(const string &root)
+{
+        const string &sep = File::separator;
+        assert(File::mkdir(root));
+        for (const char *dir : {"src", "src/x", "src/x/y", "docs", "docs/src"})
+                assert(File::mkdir(root + sep + dir));
+        for (const char *file : {"a.cpp", "src/b.cpp", "src/b.hpp",
+                        "src/x/c.cpp", "src/x/y/d.cpp", "docs/e.cpp",
+                        "docs/src/f.cpp"})
+                assert(File::create_new_file(root + sep + file));
+
+        std::vector<string> m;
+        assert(File::glob(root, "src/**/*.cpp", m, 4));
+        assert(m == (std::vector<string>{root + sep + "src/b.cpp",
+                                root + sep + "src/x/c.cpp",
+                                root + sep + "src/x/y/d.cpp"}));
+        assert(File::glob(root, "**/src", m));
+        assert(m == (std::vector<string>{root + sep + "docs/src",
+                                root + sep + "src"}));
+        assert(File::glob(root, "*/*.{cpp,hpp}", m));
+        assert(m.size() == 3);
+        assert(File::glob(root, "nothing/*", m) && m.empty());
+        assert(!File::glob(root, "[", m));
+        assert(!File::glob(root + sep + "none", "*", m));
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Glob.d";
+        system((string{"rm -rf "} + root).c_str());
+
+        cout << "Start testing class Glob" << endl;
+        test_name();
+        test_pattern();
+        cout << "End testing." << endl;
+
+        cout << "Start testing File::glob" << endl;
+        test_glob(root);
+        cout << "End testing." << endl;
+
+        system((string{"rm -rf "} + root).c_str());
+        return 0;
+}
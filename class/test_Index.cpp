@@ -0,0 +1,191 @@
+/**
+ * test_Index.cpp - test the File_index class
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 09:12:40
+ */
+
+#include "File.hpp"
+#include "File_writer.hpp"
+#include "File_index.hpp"
+#include "Hash.hpp"
+
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+using Change = File_index::Change;
+
+static void write_file(const string &pathname, const string &s)
+{
+        File_writer fw(pathname);
+        assert(fw.write(s) == s.size());
+}
+
+static bool has(const std::vector<Change> &changes,
+                File_index::Change_kind kind, const string &path)
+{
+        for (const auto &c : changes)
+                if (c.kind == kind && c.path == path)
+                        return true;
+        return false;
+}
+
+void test_index(const string &root)
+{
+        auto path = [&](const char *name) {
+                return root + File::separator + name;
+        };
+        assert(File::mkdir(root));
+        assert(File::mkdir(path("d")));
+        assert(File::mkdir(path("d/e")));
+        assert(File::mkdir(path("x")));
+        write_file(path("a"), "alpha");
+        write_file(path("d/b"), "beta");
+        write_file(path("d/e/c"), "gamma");
+        write_file(path("x/y"), "delta");
+        assert(symlink("a", path("l").c_str()) == 0);
+
+        File_index::Options opt;
+        opt.threads = 4;
+        opt.hash = true;
+        File_index index(opt);
+        assert(!index.build(path("none")));
+        assert(index.build(root));
+        assert(index.root() == root);
+        assert(index.entries().size() == 9);
+        assert(index.entries().front().path.empty());
+        assert(index.find("d/e")->is_directory());
+        const File_index::Entry *c = index.find("d/e/c");
+        assert(c && c->is_file() && c->size == 5 && c->has_hash);
+        assert(c->hash == Xxh64::hash("gamma", 5));
+        assert(!index.find("l")->is_file() && !index.find("l")->has_hash);
+        assert(index.find("d/e/none") == nullptr);
+
+        std::vector<Change> changes;
+        assert(index.refresh(changes) && changes.empty());
+
+        /* the structure changes show in the directories */
+        usleep(20000);
+        write_file(path("d/new"), "new");
+        assert(system(("rm -rf " + path("x")).c_str()) == 0);
+        assert(File::move(path("d/b"), path("d/e/b")));
+        assert(File::remove(path("a")));
+        assert(File::mkdir(path("a")));
+        write_file(path("a/f"), "f");
+        assert(index.refresh(changes));
+        assert(changes.size() == 8);
+        assert(has(changes, File_index::added, "d/new"));
+        assert(has(changes, File_index::removed, "x"));
+        assert(has(changes, File_index::removed, "x/y"));
+        assert(has(changes, File_index::removed, "d/b"));
+        assert(has(changes, File_index::added, "d/e/b"));
+        assert(changes[0].kind == File_index::removed &&
+                        changes[0].path == "a");
+        assert(changes[1].kind == File_index::added &&
+                        changes[1].path == "a");
+        assert(has(changes, File_index::added, "a/f"));
+        assert(index.find("a")->is_directory());
+        assert(index.find("d/new")->hash == Xxh64::hash("new", 3));
+        assert(index.find("x/y") == nullptr);
+        assert(index.entries().size() == 9);
+
+        /* writing in place needs the deep refresh */
+        usleep(20000);
+        write_file(path("d/e/c"), "GAMMA, longer");
+        assert(index.refresh(changes) && changes.empty());
+
+        string saved = path("index");
+        assert(index.save(saved));
+        assert(!File::exists(saved + ".tmp"));
+        opt.deep = true;
+        File_index deep(opt);
+        assert(!deep.load(path("d/e/c")));
+        assert(deep.load(saved));
+        assert(deep.root() == root);
+        assert(deep.entries().size() == index.entries().size());
+        for (std::size_t i = 0; i < deep.entries().size(); ++i) {
+                const auto &a = deep.entries()[i], &b = index.entries()[i];
+                assert(a.path == b.path && a.size == b.size &&
+                                a.mtime == b.mtime && a.ino == b.ino &&
+                                a.mode == b.mode && a.hash == b.hash &&
+                                a.has_hash == b.has_hash);
+        }
+        assert(deep.refresh(changes));
+        /* the index file itself is new in the root */
+        assert(changes.size() == 2);
+        assert(changes[0].kind == File_index::modified &&
+                        changes[0].path == "d/e/c");
+        assert(changes[1].kind == File_index::added &&
+                        changes[1].path == "index");
+        assert(deep.find("d/e/c")->size == 13);
+        assert(deep.find("d/e/c")->hash == Xxh64::hash("GAMMA, longer", 13));
+        assert(deep.refresh(changes) && changes.empty());
+
+        /* saving again replaces the file as a whole */
+        assert(deep.save(saved));
+        assert(index.load(saved));
+        assert(index.entries().size() == 10);
+
+        assert(system(("rm -rf " + root).c_str()) == 0);
+        assert(!deep.refresh(changes));
+}
+
+/* "d.txt" and "d-b" sort between "d" and "d/x" */
+void test_siblings(const string &root)
+{
+        auto path = [&](const char *name) {
+                return root + File::separator + name;
+        };
+        assert(File::mkdir(root));
+        assert(File::mkdir(path("d")));
+        assert(File::mkdir(path("d-b")));
+        write_file(path("d.txt"), "text");
+        write_file(path("d/x"), "x");
+        write_file(path("d/z"), "z");
+
+        File_index index;
+        assert(index.build(root));
+        assert(index.entries().size() == 6);
+        assert(index.entries()[1].path == "d" &&
+                        index.entries()[4].path == "d/x");
+
+        usleep(20000);
+        assert(File::remove(path("d/x")));
+        write_file(path("d/y"), "y");
+        std::vector<Change> changes;
+        assert(index.refresh(changes));
+        assert(changes.size() == 2);
+        assert(changes[0].kind == File_index::removed &&
+                        changes[0].path == "d/x");
+        assert(changes[1].kind == File_index::added &&
+                        changes[1].path == "d/y");
+        assert(index.entries().size() == 6);
+        for (std::size_t i = 1; i < index.entries().size(); ++i)
+                assert(index.entries()[i - 1].path <
+                                index.entries()[i].path);
+        assert(index.refresh(changes) && changes.empty());
+
+        assert(system(("rm -rf " + root).c_str()) == 0);
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Index.d";
+        system((string{"rm -rf "} + root).c_str());
+
+        cout << "Start testing class File_index" << endl;
+        test_index(root);
+        test_siblings(root);
+        cout << "End testing." << endl;
+
+        system((string{"rm -rf "} + root).c_str());
+        return 0;
+}
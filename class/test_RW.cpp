@@ -2,7 +2,7 @@
  * test_RW.cpp - test the File_reader and File_writer class
  *
  * Created by Haoyuan Li on 2021/08/21
- * Last Modified: 2021/08/22 23:38:53
+ * Last Modified: 2026/10/20 13:05:44
  */
 
 #include "File.hpp"
@@ -11,11 +11,64 @@
 
 #include <assert.h>
 #include <iostream>
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using std::string;
 using std::cout;
 using std::endl;
 
+#if defined(__unix__)
+/* an append waiting while another process extends the file must not keep
+ * the bytes added meanwhile locked */
+static void test_append_wait(const string &fname)
+{
+        File_writer fw(fname);
+        assert(fw.clear() && fw.append(string(10, 'a')) == 10);
+        int ready[2];
+        assert(pipe(ready) == 0);
+        pid_t pid = fork();
+        assert(pid != -1);
+        if (pid == 0) {
+                int fd = open(fname.c_str(), O_WRONLY);
+                struct flock fl{};
+                fl.l_type = F_WRLCK;
+                fl.l_whence = SEEK_SET;
+                if (fd == -1 || fcntl(fd, F_OFD_SETLKW, &fl) != 0)
+                        _exit(1);
+                char c = 0;
+                if (write(ready[1], &c, 1) != 1)
+                        _exit(1);
+                usleep(200000);
+                string more(100, 'b');
+                if (pwrite(fd, more.c_str(), more.size(), 10) != 100)
+                        _exit(1);
+                _exit(0);       /* closing the fd drops the lock */
+        }
+        char c;
+        assert(read(ready[0], &c, 1) == 1);
+        assert(fw.append('c') == 'c');
+        int status;
+        assert(waitpid(pid, &status, 0) == pid && WEXITSTATUS(status) == 0);
+        assert(File::status(fname).size == 111);
+
+        /* nothing is left locked while fw stays open */
+        int fd = open(fname.c_str(), O_RDONLY);
+        struct flock fl{};
+        fl.l_type = F_RDLCK;
+        fl.l_whence = SEEK_SET;
+        assert(fd != -1 && fcntl(fd, F_OFD_GETLK, &fl) == 0);
+        assert(fl.l_type == F_UNLCK);
+        ::close(fd);
+        ::close(ready[0]);
+        ::close(ready[1]);
+        fw.close();
+}
+#endif
+
 int main()
 {
         string fname;
@@ -61,7 +114,29 @@ int main()
         cout << fname << endl << "Actual output: ";
         cout << s << endl;
 
+        /* the raw bytes and the mapping see the same contents */
+        std::size_t len;
+        const char *p = fr.map(len);
+        assert(p && static_cast<long long>(len) == File::status(fname).size);
+        assert(fr.reset_pos());
+        string raw(len, '\0');
+        assert(fr.read(&raw[0], len) == len);
+        assert(raw.compare(0, len, p, len) == 0);
+        fr.unmap();
+
+        /* the bytes reach the file before the range is unlocked, so
+         * another reader sees them with no flush */
+        assert(fw.append(string{"tail"}) == 4);
+        assert(fw.write(string{}) == 0);
+        File_reader other(f);
+        assert(other.skip(len) == static_cast<long long>(len));
+        assert(other.read(s, 8) == 4 && s == "tail");
+        other.close();
+
         fw.close();
         fr.close();
+#if defined(__unix__)
+        test_append_wait(fname);
+#endif
         f.remove();
 }
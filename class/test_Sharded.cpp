@@ -0,0 +1,123 @@
+/**
+ * test_Sharded.cpp - test the Sharded_writer class
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 03:26:40
+ */
+
+#include "File.hpp"
+#include "File_reader.hpp"
+#include "File_writer.hpp"
+#include "Sharded_writer.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <assert.h>
+#include <iostream>
+#include <cstdlib>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+static string read_all(const string &pathname)
+{
+        File_reader fr(pathname);
+        assert(fr.ready());
+        string s;
+        char buf[4096];
+        std::size_t n;
+        while ((n = fr.read(buf, sizeof(buf))) > 0)
+                s.append(buf, n);
+        return s;
+}
+
+void test_sharded(const string &root)
+{
+        assert(File::mkdir(root));
+        const int nthreads = 4, nrecords = 5000;
+        string merged = File(root, "merged").get_path();
+        {
+                /* a small buffer to write out many times */
+                Sharded_writer sw(root, "log", 1000);
+                assert(sw.shards().empty());
+                std::vector<std::thread> threads;
+                for (int t = 0; t < nthreads; ++t) {
+                        threads.emplace_back([&sw, t] {
+                                for (int i = 0; i < nrecords; ++i)
+                                        assert(sw.write(std::to_string(t) +
+                                                        " " +
+                                                        std::to_string(i) +
+                                                        "\n"));
+                        });
+                }
+                for (auto &th : threads)
+                        th.join();
+                assert(sw.shards().size() == nthreads);
+                assert(sw.shards()[0] == File(root, "log.0").get_path());
+
+                /* the records of one thread keep their order */
+                assert(sw.merge(merged));
+                string s = read_all(merged);
+                std::vector<int> next(nthreads, 0);
+                std::size_t pos = 0, lines = 0;
+                while (pos < s.size()) {
+                        auto sp = s.find(' ', pos);
+                        auto nl = s.find('\n', sp);
+                        int t = std::stoi(s.substr(pos, sp - pos));
+                        int i = std::stoi(s.substr(sp + 1, nl - sp - 1));
+                        assert(next[t]++ == i);
+                        pos = nl + 1;
+                        ++lines;
+                }
+                assert(lines == nthreads * nrecords);
+
+                /* and the ones written after another's come after them */
+                std::thread([&sw] {
+                        assert(sw.write(string("a\0b", 3)));
+                }).join();
+                assert(sw.write("c"));
+                std::thread([&sw] {
+                        assert(sw.write(""));
+                        assert(sw.write("d"));
+                }).join();
+                assert(sw.merge(merged));
+                s = read_all(merged);
+                assert(s.size() == pos + 5);
+                assert(s.compare(pos, 5, string("a\0bcd", 5)) == 0);
+                assert(sw.shards().size() == nthreads + 3);
+        }
+
+        /* the shards outlive the writer and merge the same */
+        std::vector<string> shards;
+        for (int i = 0; i < nthreads + 3; ++i)
+                shards.push_back(File(root, "log." + std::to_string(i))
+                                .get_path());
+        string again = File(root, "again").get_path();
+        assert(Sharded_writer::merge(shards, again));
+        assert(read_all(again) == read_all(merged));
+
+        /* a shard cut in the middle of a record is refused */
+        File_writer fw(shards.back());
+        fw.file_seek(0, FILE_END);
+        fw.write(string(10, '\0'));
+        fw.close();
+        assert(!Sharded_writer::merge(shards, again));
+        assert(!File::exists(again + ".tmp"));
+        shards.push_back(File(root, "none").get_path());
+        assert(!Sharded_writer::merge(shards, again));
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Sharded.d";
+        system((string{"rm -rf "} + root).c_str());
+
+        cout << "Start testing class Sharded_writer" << endl;
+        test_sharded(root);
+        cout << "End testing." << endl;
+
+        system((string{"rm -rf "} + root).c_str());
+        return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * test_Watcher.cpp - test the File_watcher class
+ *
+ * Created on 2026/10/19
+ * Last Modified: 2026/10/20 13:50:27
+ */
+
+#include "File.hpp"
+#include "File_watcher.hpp"
+#include "File_writer.hpp"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <assert.h>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+using std::string;
+using std::cout;
+using std::endl;
+using Event = File_watcher::Event;
+
+static std::mutex mtx;
+static std::condition_variable cv;
+static std::vector<std::vector<Event>> batches;
+
+static void on_events(const std::vector<Event> &events)
+{
+        std::lock_guard<std::mutex> lk(mtx);
+        batches.push_back(events);
+        cv.notify_all();
+}
+
+/* wait for the next batch, an empty one if none comes in time */
+static std::vector<Event> next_batch()
+{
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait_for(lk, std::chrono::seconds(3), [] {
+                return !batches.empty();
+        });
+        if (batches.empty())
+                return {};
+        std::vector<Event> events = std::move(batches.front());
+        batches.erase(batches.begin());
+        return events;
+}
+
+static bool has(const std::vector<Event> &events, File_watcher::Kind kind,
+                const string &path, const string &old_path = "")
+{
+        for (const auto &e : events)
+                if (e.kind == kind && e.path == path && e.old_path == old_path)
+                        return true;
+        return false;
+}
+
+static void remove_tree(const string &root)
+{
+        system((string{"rm -rf "} + root).c_str());
+}
+
+void test_watcher(const string &root)
+{
+        const string &sep = File::separator;
+        string f = root + sep + "f";
+        string g = root + sep + "g";
+        string sub = root + sep + "sub";
+        string sub2 = root + sep + "sub2";
+
+        File_watcher w;
+        assert(w.ready());
+        assert(w.add(root));
+        assert(!w.add(root + sep + "nothing"));
+        assert(w.polled() == 0);
+        assert(w.start(on_events, 50));
+        assert(!w.start(on_events, 50));
+
+        /* a burst of creating and writing is a single creation */
+        {
+                File_writer fw(f);
+                assert(fw.write(string{"hello"}) == 5);
+                assert(fw.close());
+        }
+        std::vector<Event> events = next_batch();
+        assert(events.size() == 1);
+        assert(has(events, File_watcher::created, f));
+        assert(!events[0].is_dir);
+
+        /* a file created and removed in a burst is nothing */
+        assert(File::create_new_file(g));
+        assert(File::remove(g));
+        assert(File::move(f, g));
+        events = next_batch();
+        assert(events.size() == 1);
+        assert(has(events, File_watcher::moved, g, f));
+
+        /* a new directory is watched and the files in it are reported */
+        assert(File::mkdir(sub));
+        assert(File::create_new_file(sub + sep + "1"));
+        events = next_batch();
+        assert(has(events, File_watcher::created, sub));
+        assert(has(events, File_watcher::created, sub + sep + "1"));
+        for (const auto &e : events)
+                if (e.path == sub)
+                        assert(e.is_dir);
+
+        /* the watches follow a moved directory */
+        assert(File::move(sub, sub2));
+        events = next_batch();
+        assert(events.size() == 1);
+        assert(has(events, File_watcher::moved, sub2, sub));
+        assert(File::create_new_file(sub2 + sep + "2"));
+        assert(File::remove(g));
+        events = next_batch();
+        assert(events.size() == 2);
+        assert(has(events, File_watcher::created, sub2 + sep + "2"));
+        assert(has(events, File_watcher::removed, g));
+
+        /* nothing is reported once removed */
+        assert(w.remove(root));
+        assert(File::create_new_file(f));
+        w.stop();
+        assert(batches.empty());
+}
+
+/* the removed roots are told apart though nothing is left to look at */
+void test_removed_roots(const string &root)
+{
+        const string &sep = File::separator;
+        string dir = root + sep + "dir";
+        string file = root + sep + "file";
+        assert(File::mkdir(dir));
+        assert(File::create_new_file(dir + sep + "1"));
+        assert(File::create_new_file(file));
+
+        File_watcher w;
+        assert(w.add(dir));
+        assert(w.add(file));
+        assert(w.start(on_events, 50));
+
+        remove_tree(dir);
+        assert(File::remove(file));
+        std::vector<Event> events = next_batch();
+        bool dir_seen = false, file_seen = false;
+        for (const auto &e : events) {
+                if (e.kind != File_watcher::removed)
+                        continue;
+                if (e.path == dir) {
+                        assert(e.is_dir);
+                        dir_seen = true;
+                } else if (e.path == file) {
+                        assert(!e.is_dir);
+                        file_seen = true;
+                }
+        }
+        assert(dir_seen && file_seen);
+        w.stop();
+        batches.clear();
+}
+
+int main()
+{
+        string root = "." + File::separator + "test_Watcher.d";
+        remove_tree(root);
+        assert(File::mkdir(root));
+
+        cout << "Start testing class File_watcher" << endl;
+        test_watcher(root);
+        test_removed_roots(root);
+        cout << "End testing." << endl;
+
+        remove_tree(root);
+        return 0;
+}
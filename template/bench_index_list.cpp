@@ -0,0 +1,127 @@
+/*=======================================================
+ * bench_index_list.cpp - measure the memory and the walk
+ * of the doubly_linked_list against the index_list, in
+ * order, scattered and compacted
+ *
+ *      g++ -O2 -std=c++17 bench_index_list.cpp
+ *      ./a.out [elements]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 07:04:26
+ *=======================================================
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <malloc.h>
+#include "index_list.hpp"
+#include "list.hpp"
+
+typedef doubly_linked_list<int> dll;
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+
+/* the bytes malloc has handed out */
+static long heap_used()
+{
+        return static_cast<long>(mallinfo2().uordblks);
+}
+
+
+/*-------------------------------------------------------
+ * walk - sum up the elements from @first to @last, print
+ * the time taken
+ *-------------------------------------------------------
+ */
+template <typename It>
+static void walk(const char *name, It first, It last)
+{
+        auto start = std::chrono::steady_clock::now();
+        long sum = 0;
+        for (; first != last; ++first)
+                sum += *first;
+        std::cout << name << "\t" << seconds(start) << "\t(" << sum << ")"
+                << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+        int n = argc > 1 ? std::atoi(argv[1]) : 5000000;
+        std::mt19937 rng(1);
+        std::vector<int> order(n);
+        for (int i = 0; i < n; ++i)
+                order[i] = rng() % n;
+
+        {
+                long before = heap_used();
+                dll head;
+                std::vector<dll *> nodes(n);
+                dll *p = &head;
+                for (int i = 0; i < n; ++i)
+                        nodes[i] = p = p->append(i);
+                std::cout << "dll\t" << double(heap_used() - before -
+                                n * sizeof(dll *)) / n << " bytes/elem"
+                        << std::endl;
+                struct it {
+                        dll *p;
+                        int operator*() const { return p->elem; }
+                        it &operator++() { p = p->next; return *this; }
+                        bool operator!=(const it &o) const
+                        {
+                                return p != o.p;
+                        }
+                };
+                walk("dll in order", it{head.next}, it{NULL});
+
+                /* move random nodes to the back, through new and delete */
+                for (int i : order) {
+                        dll *q = nodes[i];
+                        int e = q->elem;
+                        dll *last = p == q ? q->prev : p;
+                        q->remove();
+                        nodes[i] = p = last->append(e);
+                }
+                walk("dll scattered", it{head.next}, it{NULL});
+                head.clear();
+        }
+        {
+                long before = heap_used();
+                index_list<int> l;
+                std::vector<index_list<int>::iterator> pos(n);
+                for (int i = 0; i < n; ++i) {
+                        l.push_back(i);
+                        pos[i] = --l.end();
+                }
+                l.compact();    /* drop the spare capacity */
+                std::cout << "index\t" << double(heap_used() - before -
+                                n * sizeof(pos[0])) / n << " bytes/elem"
+                        << std::endl;
+                for (int i = 0; i < n; ++i)
+                        pos[i] = i ? ++pos[i - 1] : l.begin();
+                walk("index in order", l.begin(), l.end());
+
+                /* move random elements to the back through the free list */
+                for (int i : order) {
+                        int e = *pos[i];
+                        l.erase(pos[i]);
+                        l.push_back(e);
+                        pos[i] = --l.end();
+                }
+                walk("index scattered", l.begin(), l.end());
+                auto start = std::chrono::steady_clock::now();
+                l.compact();
+                std::cout << "compact\t" << seconds(start) << std::endl;
+                walk("index compacted", l.begin(), l.end());
+        }
+        return 0;
+}
@@ -0,0 +1,97 @@
+/*=======================================================
+ * bench_list.cpp - measure building, traversing and
+ * clearing the lists with new and delete against the
+ * node_pool
+ *
+ *      g++ -O2 -std=c++17 -pthread bench_list.cpp
+ *      ./a.out [nodes]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 03:58:21
+ *=======================================================
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "list.hpp"
+#include "node_pool.hpp"
+
+typedef singly_linked_list<long> sll;
+typedef doubly_linked_list<long> dll;
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+
+/*-------------------------------------------------------
+ * bench - build a list of @n nodes after @head, walk it
+ * and clear it, with reset() instead of clear() when
+ * @pool is given
+ *-------------------------------------------------------
+ */
+template <typename List>
+static void bench(const char *name, List &head, long n,
+                node_pool<List> *pool)
+{
+        auto start = std::chrono::steady_clock::now();
+        List *p = &head;
+        for (long i = 0; i < n; ++i)
+                p = p->append(i);
+        double build = seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        long sum = 0;
+        for (p = head.next; p; p = p->next)
+                sum += p->elem;
+        double walk = seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        head.clear();
+        double clear = seconds(start);
+
+        double reset = 0;
+        if (pool) {
+                p = &head;
+                for (long i = 0; i < n; ++i)
+                        p = p->append(i);
+                start = std::chrono::steady_clock::now();
+                pool->reset();
+                head.next = NULL;
+                reset = seconds(start);
+        }
+        std::cout << name << "\t" << build << "\t" << walk << "\t" << clear
+                << "\t" << reset << "\t(" << sum << ")" << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+        long n = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+        std::cout << "list\tbuild(s)\twalk(s)\tclear(s)\treset(s)"
+                << std::endl;
+        {
+                sll head;
+                bench<sll>("sll new", head, n, NULL);
+        }
+        {
+                node_pool<sll> pool;
+                sll head(&pool);
+                bench("sll pool", head, n, &pool);
+        }
+        {
+                dll head;
+                bench<dll>("dll new", head, n, NULL);
+        }
+        {
+                node_pool<dll> pool;
+                dll head(&pool);
+                bench("dll pool", head, n, &pool);
+        }
+        return 0;
+}
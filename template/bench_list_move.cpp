@@ -0,0 +1,98 @@
+/*=======================================================
+ * bench_list_move.cpp - count the allocations and the
+ * time of appending strings to a singly_linked_list by
+ * copy, by move and in place
+ *
+ *      g++ -O2 -std=c++17 bench_list_move.cpp
+ *      ./a.out [nodes] [string length]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 08:10:05
+ *=======================================================
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "list.hpp"
+
+typedef singly_linked_list<std::string> sll;
+
+static long allocations = 0;
+
+void *operator new(std::size_t n)
+{
+        ++allocations;
+        void *p = std::malloc(n ? n : 1);
+        if (!p)
+                throw std::bad_alloc();
+        return p;
+}
+
+/* the node_pool takes its slabs through this one */
+void *operator new(std::size_t n, const std::nothrow_t &) noexcept
+{
+        ++allocations;
+        return std::malloc(n ? n : 1);
+}
+
+void operator delete(void *p) noexcept
+{
+        std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+        std::free(p);
+}
+
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+
+/*-------------------------------------------------------
+ * bench - append @n strings after @head with @add, then
+ * print the allocations per node and the time taken
+ *-------------------------------------------------------
+ */
+template <typename F>
+static void bench(const char *name, long n, F add)
+{
+        sll head;
+        long before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        sll *p = &head;
+        for (long i = 0; i < n; ++i)
+                p = add(p);
+        double t = seconds(start);
+        std::cout << name << "\t" << double(allocations - before) / n
+                << "\t" << t << std::endl;
+        head.clear();
+}
+
+
+int main(int argc, char *argv[])
+{
+        long n = argc > 1 ? std::atol(argv[1]) : 2000000;
+        std::size_t len = argc > 2 ? std::atol(argv[2]) : 40;
+
+        std::cout << "append\tallocs/node\ttime(s)" << std::endl;
+        bench("copy", n, [len](sll *p) {
+                std::string s(len, 'x');
+                return p->append(static_cast<const std::string &>(s));
+        });
+        bench("move", n, [len](sll *p) {
+                return p->append(std::string(len, 'x'));
+        });
+        bench("emplace", n, [len](sll *p) {
+                return p->emplace_after(len, 'x');
+        });
+        return 0;
+}
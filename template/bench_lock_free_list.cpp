@@ -0,0 +1,135 @@
+/*=======================================================
+ * bench_lock_free_list.cpp - measure the lock_free_list
+ * against a singly_linked_list behind a mutex, from one
+ * thread to many
+ *
+ *      g++ -O2 -std=c++17 -pthread bench_lock_free_list.cpp
+ *      ./a.out [threads] [keys] [ops per thread]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 05:31:09
+ *=======================================================
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "list.hpp"
+#include "lock_free_list.hpp"
+
+typedef singly_linked_list<int> sll;
+
+/* the lookups found, kept so that the compiler does not drop them */
+static std::atomic<long> found_total{0};
+
+/*
+ * The singly_linked_list kept in order behind one mutex, the way it is
+ * shared without the lock-free list.
+ */
+class mutex_list {
+        private:
+                std::mutex mtx;
+                sll head;
+
+        public:
+                ~mutex_list() { head.clear(); }
+
+                bool insert(int elem)
+                {
+                        std::lock_guard<std::mutex> lk(mtx);
+                        sll *p = &head;
+                        while (p->next && p->next->elem < elem)
+                                p = p->next;
+                        if (p->next && p->next->elem == elem)
+                                return false;
+                        return p->append(elem) != NULL;
+                }
+
+                bool remove(int elem)
+                {
+                        std::lock_guard<std::mutex> lk(mtx);
+                        sll *p = &head;
+                        while (p->next && p->next->elem < elem)
+                                p = p->next;
+                        if (!p->next || p->next->elem != elem)
+                                return false;
+                        p->remove();
+                        return true;
+                }
+
+                bool contains(int elem)
+                {
+                        std::lock_guard<std::mutex> lk(mtx);
+                        sll *p = head.next;
+                        while (p && p->elem < elem)
+                                p = p->next;
+                        return p && p->elem == elem;
+                }
+};
+
+
+/*-------------------------------------------------------
+ * run - fill @list with half of @keys, then let @threads
+ * threads do @ops operations each, 90% lookups and the
+ * rest insertions and removals, return the operations
+ * per second
+ *-------------------------------------------------------
+ */
+template <typename List>
+static double run(int threads, int keys, long ops)
+{
+        List list;
+        for (int k = 0; k < keys; k += 2)
+                list.insert(k);
+
+        std::vector<std::thread> pool;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+                pool.emplace_back([&list, keys, ops, t] {
+                        std::mt19937 rng(t);
+                        long found = 0;
+                        for (long i = 0; i < ops; ++i) {
+                                int k = rng() % keys;
+                                unsigned r = rng() % 20;
+                                if (r == 0)
+                                        list.insert(k);
+                                else if (r == 1)
+                                        list.remove(k);
+                                else
+                                        found += list.contains(k);
+                        }
+                        found_total += found;
+                });
+        }
+        for (auto &th : pool)
+                th.join();
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return threads * ops / d.count();
+}
+
+
+int main(int argc, char *argv[])
+{
+        int max = argc > 1 ? std::atoi(argv[1]) :
+                std::thread::hardware_concurrency();
+        int keys = argc > 2 ? std::atoi(argv[2]) : 1024;
+        long ops = argc > 3 ? std::atol(argv[3]) : 200000;
+        if (max < 1)
+                max = 1;
+
+        std::cout << "threads\tmutex(ops/s)\tlock-free(ops/s)" << std::endl;
+        for (int t = 1; t <= max; t *= 2) {
+                double m = run<mutex_list>(t, keys, ops);
+                double f = run<lock_free_list<int>>(t, keys, ops);
+                std::cout << t << "\t" << m << "\t" << f << std::endl;
+                if (t < max && t * 2 > max)
+                        t = max / 2;
+        }
+        return 0;
+}
@@ -0,0 +1,130 @@
+/*=======================================================
+ * bench_lock_free_queue.cpp - measure the throughput and
+ * the tail latency of the lock_free_queue and the
+ * lock_free_stack against a std::queue behind a mutex
+ *
+ *      g++ -O2 -std=c++17 -pthread bench_lock_free_queue.cpp
+ *      ./a.out [producers and consumers] [items per producer]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:02:44
+ *=======================================================
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "lock_free_queue.hpp"
+#include "lock_free_stack.hpp"
+
+typedef std::chrono::steady_clock clk;
+
+/*
+ * A std::queue behind one mutex, the way work is handed over without the
+ * lock-free containers.
+ */
+class mutex_queue {
+        private:
+                std::mutex mtx;
+                std::queue<long> q;
+
+        public:
+                void push(long elem)
+                {
+                        std::lock_guard<std::mutex> lk(mtx);
+                        q.push(elem);
+                }
+
+                bool pop(long &elem)
+                {
+                        std::lock_guard<std::mutex> lk(mtx);
+                        if (q.empty())
+                                return false;
+                        elem = q.front();
+                        q.pop();
+                        return true;
+                }
+};
+
+
+static long percentile(const std::vector<long> &sorted, double p)
+{
+        return sorted[static_cast<std::size_t>(p * (sorted.size() - 1))];
+}
+
+
+/*-------------------------------------------------------
+ * run - let @threads producers push @items each while as
+ * many consumers pop them all, timing every push and
+ * every pop that got an element, then print the
+ * operations per second and the latencies in ns
+ *-------------------------------------------------------
+ */
+template <typename C>
+static void run(const char *name, int threads, long items)
+{
+        C c;
+        std::vector<std::vector<long>> lat(2 * threads);
+        std::atomic<long> left{threads * items};
+        std::vector<std::thread> pool;
+
+        auto start = clk::now();
+        for (int t = 0; t < threads; ++t) {
+                pool.emplace_back([&c, &lat, items, t] {
+                        std::vector<long> &v = lat[t];
+                        v.reserve(items);
+                        for (long i = 0; i < items; ++i) {
+                                auto s = clk::now();
+                                c.push(i);
+                                v.push_back((clk::now() - s).count());
+                        }
+                });
+                pool.emplace_back([&c, &lat, &left, items, threads, t] {
+                        std::vector<long> &v = lat[threads + t];
+                        v.reserve(items);
+                        long x;
+                        while (left.load(std::memory_order_relaxed) > 0) {
+                                auto s = clk::now();
+                                if (c.pop(x)) {
+                                        v.push_back((clk::now() - s).count());
+                                        left.fetch_sub(1);
+                                }
+                        }
+                });
+        }
+        for (auto &th : pool)
+                th.join();
+        std::chrono::duration<double> d = clk::now() - start;
+
+        std::vector<long> all;
+        for (auto &v : lat)
+                all.insert(all.end(), v.begin(), v.end());
+        std::sort(all.begin(), all.end());
+        std::cout << name << "\t" << all.size() / d.count() << "\t"
+                << percentile(all, 0.5) << "\t" << percentile(all, 0.99)
+                << "\t" << percentile(all, 0.999) << "\t" << all.back()
+                << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+        int threads = argc > 1 ? std::atoi(argv[1]) :
+                std::max(1u, std::thread::hardware_concurrency() / 2);
+        long items = argc > 2 ? std::atol(argv[2]) : 500000;
+
+        std::cout << threads << " producers and " << threads
+                << " consumers, " << items << " items each" << std::endl;
+        std::cout << "container\tops/s\tp50(ns)\tp99(ns)\tp99.9(ns)\tmax(ns)"
+                << std::endl;
+        run<mutex_queue>("mutex queue", threads, items);
+        run<lock_free_queue<long>>("lock-free queue", threads, items);
+        run<lock_free_stack<long>>("lock-free stack", threads, items);
+        return 0;
+}
@@ -0,0 +1,100 @@
+/*=======================================================
+ * bench_unrolled_list.cpp - measure walking and finding
+ * in the singly_linked_list, the unrolled_list and the
+ * std::vector
+ *
+ *      g++ -O2 -std=c++17 bench_unrolled_list.cpp
+ *      ./a.out [elements]
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 04:40:12
+ *=======================================================
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "list.hpp"
+#include "unrolled_list.hpp"
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start;
+        return d.count();
+}
+
+
+/*-------------------------------------------------------
+ * report - print the times of building, summing up and
+ * looking for a missing element
+ *-------------------------------------------------------
+ */
+static void report(const char *name, double build, double walk, double find,
+                long sum, bool found)
+{
+        std::cout << name << "\t" << build << "\t" << walk << "\t" << find
+                << "\t(" << sum << ", " << found << ")" << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+        int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+        std::cout << "container\tbuild(s)\twalk(s)\tfind(s)" << std::endl;
+
+        {
+                auto start = std::chrono::steady_clock::now();
+                singly_linked_list<int> head;
+                singly_linked_list<int> *p = &head;
+                for (int i = 0; i < n; ++i)
+                        p = p->append(i);
+                double build = seconds(start);
+                start = std::chrono::steady_clock::now();
+                long sum = 0;
+                for (p = head.next; p; p = p->next)
+                        sum += p->elem;
+                double walk = seconds(start);
+                start = std::chrono::steady_clock::now();
+                bool found = head.find(-1) != NULL;
+                report("sll", build, walk, seconds(start), sum, found);
+                head.clear();
+        }
+        {
+                auto start = std::chrono::steady_clock::now();
+                unrolled_list<int> l;
+                for (int i = 0; i < n; ++i)
+                        l.push_back(i);
+                double build = seconds(start);
+                start = std::chrono::steady_clock::now();
+                long sum = 0;
+                for (int x : l)
+                        sum += x;
+                double walk = seconds(start);
+                start = std::chrono::steady_clock::now();
+                bool found = l.find(-1) != l.end();
+                report("unrolled", build, walk, seconds(start), sum, found);
+        }
+        {
+                auto start = std::chrono::steady_clock::now();
+                std::vector<int> v;
+                for (int i = 0; i < n; ++i)
+                        v.push_back(i);
+                double build = seconds(start);
+                start = std::chrono::steady_clock::now();
+                long sum = 0;
+                for (int x : v)
+                        sum += x;
+                double walk = seconds(start);
+                start = std::chrono::steady_clock::now();
+                bool found = false;
+                for (int x : v)
+                        if (x == -1) {
+                                found = true;
+                                break;
+                        }
+                report("vector", build, walk, seconds(start), sum, found);
+        }
+        return 0;
+}
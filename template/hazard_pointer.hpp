@@ -0,0 +1,267 @@
+/*=======================================================
+ * hazard_pointer.hpp - hazard pointers, the safe memory
+ * reclamation of the lock-free lists
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 05:31:09
+ *=======================================================
+ */
+
+#ifndef HAZARD_POINTER_HPP
+#define HAZARD_POINTER_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * A thread about to read a node shared with others publishes its address
+ * in a hazard pointer first, and a node unlinked from the structure is
+ * retired instead of freed: it is freed only once no hazard pointer holds
+ * it. Every operation holds a record of @K hazard pointers for as long as
+ * it runs; the records are taken with a CAS and never freed before the
+ * domain, so a thread holds nothing between operations and may exit at
+ * any time. The nodes a record has retired stay with it for the next
+ * holder to free, and all left are freed with the domain, which no thread
+ * may use meanwhile.
+ */
+template <std::size_t K = 2>
+class hazard_domain {
+        private:
+                struct retired {
+                        void *p;
+                        void (*del)(void *p, void *ctx);
+                        void *ctx;
+                };
+
+                struct record {
+                        std::atomic<void *> hp[K];
+                        std::atomic<bool> busy;
+                        record *next;           /* fixed once published */
+                        std::vector<retired> retired_list;
+
+                        record() : busy(true), next(NULL)
+                        {
+                                for (auto &h : hp)
+                                        h.store(NULL,
+                                                std::memory_order_relaxed);
+                        }
+                };
+
+                /* the record a thread took the last time, of any domain */
+                struct hint {
+                        unsigned long long id;
+                        record *rec;
+                };
+
+                inline static std::atomic<unsigned long long> next_id{0};
+
+                const unsigned long long id;
+                std::atomic<record *> head{NULL};
+                std::atomic<std::size_t> count{0};
+
+        public:
+                class holder;
+
+                hazard_domain(const hazard_domain &) = delete;
+                hazard_domain &operator=(const hazard_domain &) = delete;
+                hazard_domain();
+                ~hazard_domain();
+                std::size_t record_count() const;
+
+        private:
+                record *acquire();
+                static void release(record *r);
+                void scan(record *r);
+};
+
+
+/*
+ * The hazard pointers of one operation, given back when it goes out of
+ * scope.
+ */
+template <std::size_t K>
+class hazard_domain<K>::holder {
+        private:
+                hazard_domain *dom;
+                record *rec;
+
+        public:
+                holder(const holder &) = delete;
+                holder &operator=(const holder &) = delete;
+                explicit holder(hazard_domain &dom) :
+                        dom(&dom), rec(dom.acquire()) {}
+                ~holder() { release(rec); }
+
+                /*-----------------------------------------------
+                 * protect - load @src into the hazard pointer @i
+                 * until it stays the same, return the pointer
+                 * with the bits of @mask cleared
+                 *-----------------------------------------------
+                 */
+                template <typename P>
+                P *protect(std::size_t i, const std::atomic<P *> &src,
+                                std::uintptr_t mask = 0)
+                {
+                        P *p = src.load(std::memory_order_acquire);
+                        for (;;) {
+                                P *q = reinterpret_cast<P *>(
+                                        reinterpret_cast<std::uintptr_t>(p) &
+                                        ~mask);
+                                rec->hp[i].store(q);
+                                P *again = src.load();
+                                if (again == p)
+                                        return q;
+                                p = again;
+                        }
+                }
+
+                /* set the hazard pointer @i to @p, whose source the
+                   caller checks again afterwards */
+                void set(std::size_t i, void *p) { rec->hp[i].store(p); }
+
+                /*-----------------------------------------------
+                 * hand_over - set the hazard pointer @i to @p,
+                 * held by a pointer before @i until it is moved
+                 * on, no fence needed as scan() reads the
+                 * pointers in order
+                 *-----------------------------------------------
+                 */
+                void hand_over(std::size_t i, void *p)
+                {
+                        rec->hp[i].store(p, std::memory_order_release);
+                }
+                void clear(std::size_t i)
+                {
+                        rec->hp[i].store(NULL, std::memory_order_release);
+                }
+
+                /*-----------------------------------------------
+                 * retire - free @p with @del(@p, @ctx) once no
+                 * hazard pointer holds it, @p must be unlinked
+                 *-----------------------------------------------
+                 */
+                void retire(void *p, void (*del)(void *, void *), void *ctx)
+                {
+                        rec->retired_list.push_back(retired{p, del, ctx});
+                        std::size_t n = dom->count.load(
+                                        std::memory_order_relaxed);
+                        if (rec->retired_list.size() >= 2 * K * n + 64)
+                                dom->scan(rec);
+                }
+};
+
+
+template <std::size_t K>
+hazard_domain<K>::hazard_domain() : id(++next_id)
+{
+}
+
+
+/*-------------------------------------------------------
+ * ~hazard_domain - free all nodes retired and all
+ * records
+ *-------------------------------------------------------
+ */
+template <std::size_t K>
+hazard_domain<K>::~hazard_domain()
+{
+        record *r = head.load();
+        while (r) {
+                record *next = r->next;
+                for (retired &x : r->retired_list)
+                        x.del(x.p, x.ctx);
+                delete r;
+                r = next;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * record_count - get the number of records, the most
+ * operations that ever ran at once
+ *-------------------------------------------------------
+ */
+template <std::size_t K>
+std::size_t hazard_domain<K>::record_count() const
+{
+        return count.load();
+}
+
+
+/*-------------------------------------------------------
+ * acquire - take a free record, the one the calling
+ * thread took last time first, or publish a new one
+ *-------------------------------------------------------
+ */
+template <std::size_t K>
+typename hazard_domain<K>::record *hazard_domain<K>::acquire()
+{
+        thread_local hint last = {0, NULL};
+        bool idle = false;
+        if (last.id == this->id && !last.rec->busy.load(
+                                std::memory_order_relaxed) &&
+                        last.rec->busy.compare_exchange_strong(idle, true))
+                return last.rec;
+        for (record *r = head.load(); r; r = r->next) {
+                idle = false;
+                if (!r->busy.load(std::memory_order_relaxed) &&
+                                r->busy.compare_exchange_strong(idle, true)) {
+                        last = hint{this->id, r};
+                        return r;
+                }
+        }
+        record *r = new record;
+        r->next = head.load();
+        while (!head.compare_exchange_weak(r->next, r))
+                ;
+        count.fetch_add(1);
+        last = hint{this->id, r};
+        return r;
+}
+
+
+template <std::size_t K>
+void hazard_domain<K>::release(record *r)
+{
+        for (auto &h : r->hp)
+                h.store(NULL, std::memory_order_release);
+        r->busy.store(false, std::memory_order_release);
+}
+
+
+/*-------------------------------------------------------
+ * scan - free the nodes retired by the record @r that no
+ * hazard pointer holds
+ *-------------------------------------------------------
+ */
+template <std::size_t K>
+void hazard_domain<K>::scan(record *r)
+{
+        /* the unlinking before is seen by whoever sets a pointer after */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::vector<void *> held;
+        for (record *p = head.load(); p; p = p->next)
+                for (auto &h : p->hp) {
+                        void *x = h.load();
+                        if (x)
+                                held.push_back(x);
+                }
+        std::sort(held.begin(), held.end());
+
+        std::vector<retired> &list = r->retired_list;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < list.size(); ++i) {
+                if (std::binary_search(held.begin(), held.end(), list[i].p))
+                        list[kept++] = list[i];
+                else
+                        list[i].del(list[i].p, list[i].ctx);
+        }
+        list.resize(kept);
+}
+
+
+#endif /* HAZARD_POINTER_HPP */
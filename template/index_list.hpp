@@ -0,0 +1,422 @@
+/*=======================================================
+ * index_list.hpp - a doubly linked list whose nodes lie
+ * in one vector, linked by 32-bit indices
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 07:04:26
+ *=======================================================
+ */
+
+#ifndef INDEX_LIST_HPP
+#define INDEX_LIST_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * The nodes are the slots of one std::vector, and the links are the
+ * 32-bit indices of the slots instead of pointers, so a node of an int
+ * takes 12 bytes against the 32 of a doubly_linked_list<int> node, and
+ * nothing is allocated for a node once the vector has grown. The slots of
+ * the erased elements make a free list that insertions take first.
+ *
+ * Walking the list in order reads the vector in order only as long as the
+ * elements were pushed at the back, and insertions and erasures in between
+ * scatter it; compact() moves the elements back into the order of the
+ * list. The iterators are indices, so they stay valid when the vector
+ * grows, and only erase() of the element and compact() invalidate them.
+ */
+template <typename T>
+class index_list {
+        private:
+                typedef std::uint32_t index;
+
+                static constexpr index npos = 0xffffffff;
+                static constexpr index freed = 0xfffffffe;
+
+                /* a node, or a free slot if @prev is freed */
+                struct slot {
+                        union {
+                                T elem;
+                        };
+                        index prev;
+                        index next;
+
+                        slot() : prev(freed), next(npos) {}
+                        template <typename U>
+                        slot(U &&elem, index prev, index next) :
+                                elem(std::forward<U>(elem)), prev(prev),
+                                next(next) {}
+                        slot(const slot &s) : prev(s.prev), next(s.next)
+                        {
+                                if (s.used())
+                                        new (&elem) T(s.elem);
+                        }
+                        slot(slot &&s) noexcept(
+                                std::is_nothrow_move_constructible<T>::value)
+                                : prev(s.prev), next(s.next)
+                        {
+                                if (s.used())
+                                        new (&elem) T(std::move(s.elem));
+                        }
+                        slot &operator=(const slot &) = delete;
+                        ~slot()
+                        {
+                                if (used())
+                                        elem.~T();
+                        }
+                        bool used() const { return prev != freed; }
+                };
+
+                std::vector<slot> slots;
+                index head;
+                index tail;
+                index free_head;
+                std::size_t len;
+
+        public:
+                class iterator;
+
+                index_list();
+                index_list(const index_list &other) = default;
+                index_list(index_list &&other) noexcept;
+                index_list &operator=(index_list other) noexcept;
+                std::size_t size() const;
+                bool empty() const;
+                std::size_t capacity() const;
+                void reserve(std::size_t n);
+                T &front();
+                T &back();
+                iterator begin();
+                iterator end();
+                iterator find(const T &elem);
+                void push_back(const T &elem);
+                void push_front(const T &elem);
+                iterator insert(iterator pos, const T &elem);
+                iterator erase(iterator pos);
+                void clear();
+                void compact();
+                void swap(index_list &other) noexcept;
+                void print();
+
+        private:
+                index link(index prev, index next, const T &elem);
+};
+
+
+/*-------------------------------------------------------
+ * iterator - a position in the list, the index of the
+ * slot, end() is npos and steps back to the tail
+ *-------------------------------------------------------
+ */
+template <typename T>
+class index_list<T>::iterator {
+        private:
+                friend class index_list<T>;
+                index_list *list;
+                index i;
+
+                iterator(index_list *list, index i) : list(list), i(i) {}
+
+        public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                iterator() : list(NULL), i(npos) {}
+                T &operator*() const { return list->slots[i].elem; }
+                T *operator->() const { return &list->slots[i].elem; }
+                iterator &operator++()
+                {
+                        i = list->slots[i].next;
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        ++*this;
+                        return it;
+                }
+                iterator &operator--()
+                {
+                        i = i == npos ? list->tail : list->slots[i].prev;
+                        return *this;
+                }
+                iterator operator--(int)
+                {
+                        iterator it = *this;
+                        --*this;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return i == it.i;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return i != it.i;
+                }
+};
+
+
+template <typename T>
+index_list<T>::index_list()
+        : head(npos), tail(npos), free_head(npos), len(0)
+{
+}
+
+
+template <typename T>
+index_list<T>::index_list(index_list &&other) noexcept
+        : index_list()
+{
+        this->swap(other);
+}
+
+
+template <typename T>
+index_list<T> &index_list<T>::operator=(index_list other) noexcept
+{
+        this->swap(other);
+        return *this;
+}
+
+
+template <typename T>
+std::size_t index_list<T>::size() const
+{
+        return len;
+}
+
+
+template <typename T>
+bool index_list<T>::empty() const
+{
+        return len == 0;
+}
+
+
+/*-------------------------------------------------------
+ * capacity - get the number of slots, used or free, the
+ * vector holds without growing
+ *-------------------------------------------------------
+ */
+template <typename T>
+std::size_t index_list<T>::capacity() const
+{
+        return slots.capacity();
+}
+
+
+template <typename T>
+void index_list<T>::reserve(std::size_t n)
+{
+        slots.reserve(n);
+}
+
+
+template <typename T>
+T &index_list<T>::front()
+{
+        return slots[head].elem;
+}
+
+
+template <typename T>
+T &index_list<T>::back()
+{
+        return slots[tail].elem;
+}
+
+
+template <typename T>
+typename index_list<T>::iterator index_list<T>::begin()
+{
+        return iterator(this, head);
+}
+
+
+template <typename T>
+typename index_list<T>::iterator index_list<T>::end()
+{
+        return iterator(this, npos);
+}
+
+
+/*-------------------------------------------------------
+ * find - find the first element equal to @elem, return
+ * end() if not found
+ *-------------------------------------------------------
+ */
+template <typename T>
+typename index_list<T>::iterator index_list<T>::find(const T &elem)
+{
+        index i = head;
+        while (i != npos && !(slots[i].elem == elem))
+                i = slots[i].next;
+        return iterator(this, i);
+}
+
+
+template <typename T>
+void index_list<T>::push_back(const T &elem)
+{
+        link(tail, npos, elem);
+}
+
+
+template <typename T>
+void index_list<T>::push_front(const T &elem)
+{
+        link(npos, head, elem);
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert @elem before @pos, return the position
+ * of the new element
+ *-------------------------------------------------------
+ */
+template <typename T>
+typename index_list<T>::iterator index_list<T>::insert(iterator pos,
+                const T &elem)
+{
+        index prev = pos.i == npos ? tail : slots[pos.i].prev;
+        return iterator(this, link(prev, pos.i, elem));
+}
+
+
+/*-------------------------------------------------------
+ * erase - remove the element at @pos and free its slot,
+ * return the position of the element after it
+ *-------------------------------------------------------
+ */
+template <typename T>
+typename index_list<T>::iterator index_list<T>::erase(iterator pos)
+{
+        slot &s = slots[pos.i];
+        index next = s.next;
+        if (s.prev != npos)
+                slots[s.prev].next = next;
+        else
+                head = next;
+        if (next != npos)
+                slots[next].prev = s.prev;
+        else
+                tail = s.prev;
+        s.elem.~T();
+        s.prev = freed;
+        s.next = free_head;
+        free_head = pos.i;
+        --len;
+        return iterator(this, next);
+}
+
+
+template <typename T>
+void index_list<T>::clear()
+{
+        slots.clear();
+        head = tail = free_head = npos;
+        len = 0;
+}
+
+
+/*-------------------------------------------------------
+ * compact - move the elements into the order of the
+ * list, dropping the free slots, so walking the list
+ * reads the vector from the start to the end
+ *-------------------------------------------------------
+ */
+template <typename T>
+void index_list<T>::compact()
+{
+        std::vector<slot> packed;
+        packed.reserve(len);
+        index k = 0;
+        for (index i = head; i != npos; i = slots[i].next, ++k)
+                packed.emplace_back(std::move(slots[i].elem),
+                                k == 0 ? npos : k - 1,
+                                k + 1 == len ? npos : k + 1);
+        slots.swap(packed);
+        head = len ? 0 : npos;
+        tail = len ? static_cast<index>(len - 1) : npos;
+        free_head = npos;
+}
+
+
+template <typename T>
+void index_list<T>::swap(index_list &other) noexcept
+{
+        slots.swap(other.slots);
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(free_head, other.free_head);
+        std::swap(len, other.len);
+}
+
+
+/*-------------------------------------------------------
+ * print - print all elements
+ *-------------------------------------------------------
+ */
+template <typename T>
+void index_list<T>::print()
+{
+        for (index i = head; i != npos; i = slots[i].next)
+                std::cout << slots[i].elem << " ";
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * link - put @elem in a free slot, or a new one at the
+ * end of the vector, between @prev and @next, return the
+ * index of the slot, throw std::length_error past 2^32 - 2
+ * slots
+ *-------------------------------------------------------
+ */
+template <typename T>
+typename index_list<T>::index index_list<T>::link(index prev, index next,
+                const T &elem)
+{
+        index i;
+        if (free_head != npos) {
+                i = free_head;
+                slot &s = slots[i];
+                new (&s.elem) T(elem);
+                free_head = s.next;
+                s.prev = prev;
+                s.next = next;
+        } else {
+                if (slots.size() >= freed)
+                        throw std::length_error("index_list is full");
+                i = static_cast<index>(slots.size());
+                /* @elem may lie in the vector, which is fine for
+                   emplace_back */
+                slots.emplace_back(elem, prev, next);
+        }
+        if (prev != npos)
+                slots[prev].next = i;
+        else
+                head = i;
+        if (next != npos)
+                slots[next].prev = i;
+        else
+                tail = i;
+        ++len;
+        return i;
+}
+
+
+#endif /* INDEX_LIST_HPP */
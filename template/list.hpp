@@ -2,61 +2,176 @@
 #define LIST_HPP
 
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "node_pool.hpp"
 
-template <typename T>
-class singly_linked_list {
+
+/*-------------------------------------------------------
+ * list_alloc_holder - keep the allocator a node comes
+ * from, an allocator without state takes no room
+ *-------------------------------------------------------
+ */
+template <typename A, bool = std::is_empty<A>::value &&
+        !std::is_final<A>::value>
+class list_alloc_holder : private A {
+        protected:
+                list_alloc_holder() : A() {}
+                list_alloc_holder(const A &alloc) : A(alloc) {}
+                A &node_allocator() { return *this; }
+                const A &node_allocator() const { return *this; }
+};
+
+template <typename A>
+class list_alloc_holder<A, false> {
+        private:
+                A alloc;
+        protected:
+                list_alloc_holder() : alloc() {}
+                list_alloc_holder(const A &alloc) : alloc(alloc) {}
+                A &node_allocator() { return alloc; }
+                const A &node_allocator() const { return alloc; }
+};
+
+/* the allocator of @Alloc rebound to the node type @Node */
+template <typename Node, typename Alloc>
+using list_node_alloc = typename std::allocator_traits<Alloc>::template
+        rebind_alloc<Node>;
+
+
+/*
+ * The nodes made by append() come from the allocator of the node appended
+ * to, going through std::allocator_traits, so any standard allocator works,
+ * std::pmr::polymorphic_allocator included; the nodes given to append() by
+ * pointer are freed the same way and must come from an equal allocator,
+ * which for the default one is plain new. A node pool, when given, takes
+ * the place of the allocator.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class singly_linked_list : private list_alloc_holder<
+                list_node_alloc<singly_linked_list<T, Alloc>, Alloc>> {
         private:
-                typedef singly_linked_list<T> sll;
+                typedef singly_linked_list<T, Alloc> sll;
+                typedef list_node_alloc<sll, Alloc> node_alloc;
+                typedef std::allocator_traits<node_alloc> node_traits;
+                typedef list_alloc_holder<node_alloc> alloc_base;
         public:
                 T elem;
                 sll *next;
+                node_pool<sll> *pool;   /* where the nodes come from, NULL
+                                           for the allocator */
 
         public:
                 singly_linked_list();
+                singly_linked_list(node_pool<sll> *const pool);
+                explicit singly_linked_list(const Alloc &alloc);
                 singly_linked_list(const T &elem);
                 singly_linked_list(const T &elem, const sll *const next);
+                singly_linked_list(const T &elem, const sll *const next,
+                                node_pool<sll> *const pool,
+                                const Alloc &alloc = Alloc());
+                singly_linked_list(T &&elem);
+                singly_linked_list(T &&elem, const sll *const next);
+                singly_linked_list(T &&elem, const sll *const next,
+                                node_pool<sll> *const pool,
+                                const Alloc &alloc = Alloc());
+                template <typename... Args>
+                singly_linked_list(std::in_place_t, const sll *const next,
+                                node_pool<sll> *const pool,
+                                const Alloc &alloc, Args &&...args);
+                Alloc get_allocator() const;
                 bool is_tail();
                 sll *find_prev_node(const sll *const head);
                 sll *find_prev_node(const sll *const head, const T &elem);
                 sll *find(const T &elem);
                 sll *insert(const sll *const head, sll *const node);
                 sll *insert(const sll *const head, const T &elem);
+                sll *insert(const sll *const head, T &&elem);
                 sll *append(sll *const node);
                 sll *append(const T &elem);
+                sll *append(T &&elem);
+                template <typename... Args>
+                sll *emplace_after(Args &&...args);
                 sll *remove();
                 sll *remove(const sll *const head);
                 sll *remove(const sll *const head, const T &elem);
                 sll *clear();
                 void print();
+
+        private:
+                template <typename... Args>
+                sll *make(Args &&...args);
+                static void release(sll *const node);
 };
 
 
-template <typename T>
-class doubly_linked_list {
+template <typename T, typename Alloc = std::allocator<T>>
+class doubly_linked_list : private list_alloc_holder<
+                list_node_alloc<doubly_linked_list<T, Alloc>, Alloc>> {
         private:
-                typedef doubly_linked_list<T> dll;
+                typedef doubly_linked_list<T, Alloc> dll;
+                typedef list_node_alloc<dll, Alloc> node_alloc;
+                typedef std::allocator_traits<node_alloc> node_traits;
+                typedef list_alloc_holder<node_alloc> alloc_base;
         public:
                 T elem;
                 dll *prev;
                 dll *next;
+                node_pool<dll> *pool;   /* where the nodes come from, NULL
+                                           for the allocator */
 
         public:
                 doubly_linked_list();
+                doubly_linked_list(node_pool<dll> *const pool);
+                explicit doubly_linked_list(const Alloc &alloc);
                 doubly_linked_list(const T &elem);
                 doubly_linked_list(const T &elem, const dll *const prev,
                                 const dll *const next);
+                doubly_linked_list(const T &elem, const dll *const prev,
+                                const dll *const next,
+                                node_pool<dll> *const pool,
+                                const Alloc &alloc = Alloc());
+                doubly_linked_list(T &&elem);
+                doubly_linked_list(T &&elem, const dll *const prev,
+                                const dll *const next);
+                doubly_linked_list(T &&elem, const dll *const prev,
+                                const dll *const next,
+                                node_pool<dll> *const pool,
+                                const Alloc &alloc = Alloc());
+                template <typename... Args>
+                doubly_linked_list(std::in_place_t, const dll *const prev,
+                                const dll *const next,
+                                node_pool<dll> *const pool,
+                                const Alloc &alloc, Args &&...args);
+                Alloc get_allocator() const;
                 bool is_head();
                 bool is_tail();
                 dll *find(const T &elem);
                 dll *rfind(const T &elem);
                 dll *insert(dll *const node);
                 dll *insert(const T &elem);
+                dll *insert(T &&elem);
+                template <typename... Args>
+                dll *emplace(Args &&...args);
                 dll *append(dll *const node);
                 dll *append(const T &elem);
+                dll *append(T &&elem);
+                template <typename... Args>
+                dll *emplace_after(Args &&...args);
                 dll *remove();
                 dll *clear();
                 void print();
+
+        private:
+                template <typename... Args>
+                dll *make(Args &&...args);
+                static void release(dll *const node);
 };
 
 
@@ -64,26 +179,116 @@ class doubly_linked_list {
  * singly_linked_list
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T>::singly_linked_list()
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list()
+        : elem(), next(NULL), pool(NULL)
 {
-        this->elem = T();
-        this->next = NULL;
 }
 
-template <typename T>
-singly_linked_list<T>::singly_linked_list(const T &elem)
+
+/*-------------------------------------------------------
+ * singly_linked_list - create a head node whose new
+ * nodes come from @pool
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(node_pool<sll> *const pool)
+        : elem(), next(NULL), pool(pool)
 {
-        this->elem = elem;
-        this->next = NULL;
 }
 
 
-template <typename T>
-singly_linked_list<T>::singly_linked_list(const T &elem, const sll *const next)
+/*-------------------------------------------------------
+ * singly_linked_list - create a head node whose new
+ * nodes come from @alloc
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(), next(NULL), pool(NULL)
+{
+}
+
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(const T &elem)
+        : elem(elem), next(NULL), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(const T &elem,
+                const sll *const next)
+        : elem(elem), next(const_cast<sll *>(next)), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(const T &elem,
+                const sll *const next, node_pool<sll> *const pool,
+                const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(elem),
+        next(const_cast<sll *>(next)), pool(pool)
+{
+}
+
+
+/*-------------------------------------------------------
+ * singly_linked_list - create a node taking over the
+ * resources of @elem
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(T &&elem)
+        : elem(std::move(elem)), next(NULL), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(T &&elem,
+                const sll *const next)
+        : elem(std::move(elem)), next(const_cast<sll *>(next)), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc>::singly_linked_list(T &&elem,
+                const sll *const next, node_pool<sll> *const pool,
+                const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(std::move(elem)),
+        next(const_cast<sll *>(next)), pool(pool)
+{
+}
+
+
+/*-------------------------------------------------------
+ * singly_linked_list - create a node whose element is
+ * constructed in place from @args
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+singly_linked_list<T, Alloc>::singly_linked_list(std::in_place_t,
+                const sll *const next, node_pool<sll> *const pool,
+                const Alloc &alloc, Args &&...args)
+        : alloc_base(node_alloc(alloc)), elem(std::forward<Args>(args)...),
+        next(const_cast<sll *>(next)), pool(pool)
+{
+}
+
+
+/*-------------------------------------------------------
+ * get_allocator - get the allocator the nodes appended
+ * to this node come from
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+Alloc singly_linked_list<T, Alloc>::get_allocator() const
 {
-        this->elem = elem;
-        this->next = const_cast<sll *const>(next);
+        return Alloc(this->node_allocator());
 }
 
 
@@ -91,8 +296,8 @@ singly_linked_list<T>::singly_linked_list(const T &elem, const sll *const next)
  * is_tail - check whether a node is the last node
  *-------------------------------------------------------
  */
-template <typename T>
-bool singly_linked_list<T>::is_tail()
+template <typename T, typename Alloc>
+bool singly_linked_list<T, Alloc>::is_tail()
 {
         return !this->next;
 }
@@ -104,8 +309,8 @@ bool singly_linked_list<T>::is_tail()
  * not found
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::find_prev_node(
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::find_prev_node(
                 const sll *const head)
 {
         if (head->next == this)
@@ -123,8 +328,8 @@ singly_linked_list<T> *singly_linked_list<T>::find_prev_node(
  * found, NULL if not found
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::find_prev_node(
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::find_prev_node(
                 const sll *const head, const T &elem)
 {
         if (head->next->elem == elem)
@@ -144,8 +349,8 @@ singly_linked_list<T> *singly_linked_list<T>::find_prev_node(
  * found, NULL if not found
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::find(const T &elem)
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::find(const T &elem)
 {
         sll *p = this->next;
         while (p && p->elem != elem)
@@ -159,8 +364,8 @@ singly_linked_list<T> *singly_linked_list<T>::find(const T &elem)
  * return the pointer point to @node, NULL if failed
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::insert(
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::insert(
                 const sll *const head, sll *const node)
 {
         sll *p = NULL;
@@ -177,8 +382,8 @@ singly_linked_list<T> *singly_linked_list<T>::insert(
  * NULL if failed
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::insert(
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::insert(
                 const sll * const head, const T &elem)
 {
         sll *p = NULL;
@@ -189,13 +394,26 @@ singly_linked_list<T> *singly_linked_list<T>::insert(
 }
 
 
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::insert(
+                const sll * const head, T &&elem)
+{
+        sll *p = NULL;
+        sll *prev = this->find_prev_node(head);
+        if (prev)
+                p = prev->append(std::move(elem));
+        return p;
+}
+
+
 /*-------------------------------------------------------
  * append - append the node @node to this node, return
  * the pointer point to @node
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::append(sll *const node)
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::append(
+                sll *const node)
 {
         node->next = this->next;
         this->next = node;
@@ -209,10 +427,39 @@ singly_linked_list<T> *singly_linked_list<T>::append(sll *const node)
  * if failed
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::append(const T &elem)
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::append(
+                const T &elem)
+{
+        return this->emplace_after(elem);
+}
+
+
+/*-------------------------------------------------------
+ * append - append a new node taking over the resources
+ * of @elem to this node, return the pointer point to the
+ * new node, NULL if failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::append(T &&elem)
+{
+        return this->emplace_after(std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace_after - append a new node whose element is
+ * constructed in place from @args to this node, return
+ * the pointer point to the new node, NULL if failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::emplace_after(
+                Args &&...args)
 {
-        sll *p = new (std::nothrow) singly_linked_list<T>(elem, this->next);
+        sll *p = this->make(std::forward<Args>(args)...);
         if (p)
                 this->next = p;
         return p;
@@ -224,14 +471,14 @@ singly_linked_list<T> *singly_linked_list<T>::append(const T &elem)
  * the pointer point the the next node
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::remove()
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::remove()
 {
         if (this->is_tail())
                 return NULL;
         sll *tmp = this->next;
         this->next = tmp->next;
-        delete tmp;
+        release(tmp);
         return this->next;
 }
 
@@ -241,14 +488,15 @@ singly_linked_list<T> *singly_linked_list<T>::remove()
  * the next node, NULL if failed
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::remove(const sll *const head)
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::remove(
+                const sll *const head)
 {
         sll *prev = this->find_prev_node(head);
         if (!prev)
                 return NULL;    /* it's illegal to remove the head node */
         prev->next = this->next;
-        delete this;
+        release(this);
         return prev->next;
 }
 
@@ -259,8 +507,8 @@ singly_linked_list<T> *singly_linked_list<T>::remove(const sll *const head)
  * failed
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::remove(
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::remove(
                 const sll *const head, const T &elem)
 {
         sll *prev = this->find_prev_node(head, elem);
@@ -268,7 +516,7 @@ singly_linked_list<T> *singly_linked_list<T>::remove(
                 return NULL;
         sll *tmp = prev->next;
         prev->next = tmp->next;
-        delete tmp;
+        release(tmp);
         return prev->next;
 }
 
@@ -278,8 +526,8 @@ singly_linked_list<T> *singly_linked_list<T>::remove(
  * pointer point to this node
  *-------------------------------------------------------
  */
-template <typename T>
-singly_linked_list<T> *singly_linked_list<T>::clear()
+template <typename T, typename Alloc>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::clear()
 {
         while (!this->is_tail())
                 this->remove();
@@ -291,8 +539,8 @@ singly_linked_list<T> *singly_linked_list<T>::clear()
  * print - print all nodes after this node
  *-------------------------------------------------------
  */
-template <typename T>
-void singly_linked_list<T>::print()
+template <typename T, typename Alloc>
+void singly_linked_list<T, Alloc>::print()
 {
         sll *p = this->next;
         while (p) {
@@ -303,35 +551,181 @@ void singly_linked_list<T>::print()
 }
 
 
+/*-------------------------------------------------------
+ * make - make a node with the element constructed from
+ * @args to go after this node, from the pool or the
+ * allocator of this node, return NULL if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+singly_linked_list<T, Alloc> *singly_linked_list<T, Alloc>::make(
+                Args &&...args)
+{
+        node_alloc a(this->node_allocator());
+        Alloc alloc(a);
+        if (this->pool)
+                return this->pool->create(std::in_place, this->next,
+                                this->pool, alloc,
+                                std::forward<Args>(args)...);
+        sll *p;
+        try {
+                p = node_traits::allocate(a, 1);
+        } catch (const std::bad_alloc &) {
+                return NULL;
+        }
+        try {
+                node_traits::construct(a, p, std::in_place, this->next,
+                                static_cast<node_pool<sll> *>(NULL), alloc,
+                                std::forward<Args>(args)...);
+        } catch (...) {
+                node_traits::deallocate(a, p, 1);
+                throw;
+        }
+        return p;
+}
+
+
+/*-------------------------------------------------------
+ * release - free a node, back to its pool if it has one
+ * or else to its allocator
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void singly_linked_list<T, Alloc>::release(sll *const node)
+{
+        if (node->pool) {
+                node->pool->destroy(node);
+                return;
+        }
+        node_alloc a(node->node_allocator());
+        node_traits::destroy(a, node);
+        node_traits::deallocate(a, node, 1);
+}
+
+
 /*-------------------------------------------------------
  * doubly_linked_list
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T>::doubly_linked_list()
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list()
+        : elem(), prev(NULL), next(NULL), pool(NULL)
 {
-        this->elem = T();
-        this->prev = NULL;
-        this->next = NULL;
 }
 
 
-template <typename T>
-doubly_linked_list<T>::doubly_linked_list(const T &elem)
+/*-------------------------------------------------------
+ * doubly_linked_list - create a head node whose new
+ * nodes come from @pool
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(node_pool<dll> *const pool)
+        : elem(), prev(NULL), next(NULL), pool(pool)
 {
-        this->elem = elem;
-        this->prev = NULL;
-        this->next = NULL;
 }
 
 
-template <typename T>
-doubly_linked_list<T>::doubly_linked_list(const T &elem, const dll *const prev,
-                const dll *const next)
+/*-------------------------------------------------------
+ * doubly_linked_list - create a head node whose new
+ * nodes come from @alloc
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(), prev(NULL), next(NULL),
+        pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(const T &elem)
+        : elem(elem), prev(NULL), next(NULL), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(const T &elem,
+                const dll *const prev, const dll *const next)
+        : elem(elem), prev(const_cast<dll *>(prev)),
+        next(const_cast<dll *>(next)), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(const T &elem,
+                const dll *const prev, const dll *const next,
+                node_pool<dll> *const pool, const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(elem),
+        prev(const_cast<dll *>(prev)), next(const_cast<dll *>(next)),
+        pool(pool)
+{
+}
+
+
+/*-------------------------------------------------------
+ * doubly_linked_list - create a node taking over the
+ * resources of @elem
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(T &&elem)
+        : elem(std::move(elem)), prev(NULL), next(NULL), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(T &&elem,
+                const dll *const prev, const dll *const next)
+        : elem(std::move(elem)), prev(const_cast<dll *>(prev)),
+        next(const_cast<dll *>(next)), pool(NULL)
+{
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc>::doubly_linked_list(T &&elem,
+                const dll *const prev, const dll *const next,
+                node_pool<dll> *const pool, const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), elem(std::move(elem)),
+        prev(const_cast<dll *>(prev)), next(const_cast<dll *>(next)),
+        pool(pool)
+{
+}
+
+
+/*-------------------------------------------------------
+ * doubly_linked_list - create a node whose element is
+ * constructed in place from @args
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+doubly_linked_list<T, Alloc>::doubly_linked_list(std::in_place_t,
+                const dll *const prev, const dll *const next,
+                node_pool<dll> *const pool, const Alloc &alloc,
+                Args &&...args)
+        : alloc_base(node_alloc(alloc)), elem(std::forward<Args>(args)...),
+        prev(const_cast<dll *>(prev)), next(const_cast<dll *>(next)),
+        pool(pool)
 {
-        this->elem = elem;
-        this->prev = const_cast<dll *>(prev);
-        this->next = const_cast<dll *>(next);
+}
+
+
+/*-------------------------------------------------------
+ * get_allocator - get the allocator the nodes appended
+ * to this node come from
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+Alloc doubly_linked_list<T, Alloc>::get_allocator() const
+{
+        return Alloc(this->node_allocator());
 }
 
 
@@ -339,8 +733,8 @@ doubly_linked_list<T>::doubly_linked_list(const T &elem, const dll *const prev,
  * is_head - check whether this node is the head node
  *-------------------------------------------------------
  */
-template <typename T>
-bool doubly_linked_list<T>::is_head()
+template <typename T, typename Alloc>
+bool doubly_linked_list<T, Alloc>::is_head()
 {
         return !this->prev;
 }
@@ -350,8 +744,8 @@ bool doubly_linked_list<T>::is_head()
  * is_tail - check whether this node is the last node
  *-------------------------------------------------------
  */
-template <typename T>
-bool doubly_linked_list<T>::is_tail()
+template <typename T, typename Alloc>
+bool doubly_linked_list<T, Alloc>::is_tail()
 {
         return !this->next;
 }
@@ -363,8 +757,8 @@ bool doubly_linked_list<T>::is_tail()
  * NULL if not found
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::find(const T &elem)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::find(const T &elem)
 {
         dll *p = this->next;
         while (p && p->elem != elem)
@@ -379,8 +773,8 @@ doubly_linked_list<T> *doubly_linked_list<T>::find(const T &elem)
  * NULL if not found
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::rfind(const T &elem)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::rfind(const T &elem)
 {
         if (this->is_head())
                 return NULL;
@@ -398,8 +792,9 @@ doubly_linked_list<T> *doubly_linked_list<T>::rfind(const T &elem)
  * return the pointer point to @node, NULL if failed
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::insert(dll *const node)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::insert(
+                dll *const node)
 {
         if (this->is_head())
                 return NULL;
@@ -414,13 +809,42 @@ doubly_linked_list<T> *doubly_linked_list<T>::insert(dll *const node)
  * NULL if failed
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::insert(const T &elem)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::insert(
+                const T &elem)
+{
+        return this->emplace(elem);
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert a new node taking over the resources
+ * of @elem before this node, return the pointer point to
+ * the new node, NULL if failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::insert(T &&elem)
+{
+        return this->emplace(std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace - insert a new node whose element is
+ * constructed in place from @args before this node,
+ * return the pointer point to the new node, NULL if
+ * failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::emplace(
+                Args &&...args)
 {
         if (this->is_head())
                 return NULL;
-        dll *p = this->prev->append(elem);
-        return p;
+        return this->prev->emplace_after(std::forward<Args>(args)...);
 }
 
 
@@ -429,8 +853,9 @@ doubly_linked_list<T> *doubly_linked_list<T>::insert(const T &elem)
  * the pointer point to @node
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::append(dll *const node)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::append(
+                dll *const node)
 {
         if (!this->is_tail())
                 this->next->prev = node;
@@ -447,10 +872,39 @@ doubly_linked_list<T> *doubly_linked_list<T>::append(dll *const node)
  * if failed
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::append(const T &elem)
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::append(
+                const T &elem)
+{
+        return this->emplace_after(elem);
+}
+
+
+/*-------------------------------------------------------
+ * append - append a new node taking over the resources
+ * of @elem to this node, return the pointer point to the
+ * new node, NULL if failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::append(T &&elem)
+{
+        return this->emplace_after(std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace_after - append a new node whose element is
+ * constructed in place from @args to this node, return
+ * the pointer point to the new node, NULL if failed
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::emplace_after(
+                Args &&...args)
 {
-        dll *p = new (std::nothrow) dll(elem, this, this->next);
+        dll *p = this->make(std::forward<Args>(args)...);
         if (p) {
                 if (!this->is_tail())
                         this->next->prev = p;
@@ -465,8 +919,8 @@ doubly_linked_list<T> *doubly_linked_list<T>::append(const T &elem)
  * the next node
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::remove()
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::remove()
 {
         if (this->is_head())    /* it's illegal to remove a head node */
                 return NULL;
@@ -474,7 +928,7 @@ doubly_linked_list<T> *doubly_linked_list<T>::remove()
         if (!this->is_tail())
                 p->prev = this->prev;
         this->prev->next = this->next;
-        delete this;
+        release(this);
         return p;
 }
 
@@ -484,8 +938,8 @@ doubly_linked_list<T> *doubly_linked_list<T>::remove()
  * pointer point to this node
  *-------------------------------------------------------
  */
-template <typename T>
-doubly_linked_list<T> *doubly_linked_list<T>::clear()
+template <typename T, typename Alloc>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::clear()
 {
         while (!this->is_tail())
                 this->next->remove();
@@ -497,8 +951,8 @@ doubly_linked_list<T> *doubly_linked_list<T>::clear()
  * print - print all nodes after this node
  *-------------------------------------------------------
  */
-template <typename T>
-void doubly_linked_list<T>::print()
+template <typename T, typename Alloc>
+void doubly_linked_list<T, Alloc>::print()
 {
         dll *p = this->next;
         while (p) {
@@ -509,4 +963,2139 @@ void doubly_linked_list<T>::print()
 }
 
 
+/*-------------------------------------------------------
+ * make - make a node with the element constructed from
+ * @args to go after this node, from the pool or the
+ * allocator of this node, return NULL if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+doubly_linked_list<T, Alloc> *doubly_linked_list<T, Alloc>::make(
+                Args &&...args)
+{
+        node_alloc a(this->node_allocator());
+        Alloc alloc(a);
+        if (this->pool)
+                return this->pool->create(std::in_place, this, this->next,
+                                this->pool, alloc,
+                                std::forward<Args>(args)...);
+        dll *p;
+        try {
+                p = node_traits::allocate(a, 1);
+        } catch (const std::bad_alloc &) {
+                return NULL;
+        }
+        try {
+                node_traits::construct(a, p, std::in_place, this,
+                                this->next,
+                                static_cast<node_pool<dll> *>(NULL), alloc,
+                                std::forward<Args>(args)...);
+        } catch (...) {
+                node_traits::deallocate(a, p, 1);
+                throw;
+        }
+        return p;
+}
+
+
+/*-------------------------------------------------------
+ * release - free a node, back to its pool if it has one
+ * or else to its allocator
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_list<T, Alloc>::release(dll *const node)
+{
+        if (node->pool) {
+                node->pool->destroy(node);
+                return;
+        }
+        node_alloc a(node->node_allocator());
+        node_traits::destroy(a, node);
+        node_traits::deallocate(a, node, 1);
+}
+
+
+/*=======================================================
+ * The intrusive lists link the objects themselves: the
+ * links live in a hook that is a member of the object, so
+ * inserting allocates and copies nothing, and an object
+ * with several hooks can sit on as many lists at once.
+ * The list never owns the objects, which must outlive
+ * their stay on it.
+ *=======================================================
+ */
+
+/*-------------------------------------------------------
+ * intrusive_slist_hook - the link of the intrusive
+ * singly linked list, @pprev points to the link leading
+ * to this one, so unlinking needs no search, copying an
+ * object does not copy its place on a list
+ *-------------------------------------------------------
+ */
+struct intrusive_slist_hook {
+        intrusive_slist_hook *next;
+        intrusive_slist_hook **pprev;
+
+        intrusive_slist_hook() : next(NULL), pprev(NULL) {}
+        intrusive_slist_hook(const intrusive_slist_hook &) :
+                next(NULL), pprev(NULL) {}
+        intrusive_slist_hook &operator=(const intrusive_slist_hook &)
+        {
+                return *this;
+        }
+        bool is_linked() const { return pprev != NULL; }
+        void unlink()
+        {
+                if (!pprev)
+                        return;
+                *pprev = next;
+                if (next)
+                        next->pprev = pprev;
+                next = NULL;
+                pprev = NULL;
+        }
+};
+
+
+/*-------------------------------------------------------
+ * intrusive_list_hook - the link of the intrusive doubly
+ * linked list, copying an object does not copy its place
+ * on a list
+ *-------------------------------------------------------
+ */
+struct intrusive_list_hook {
+        intrusive_list_hook *prev;
+        intrusive_list_hook *next;
+
+        intrusive_list_hook() : prev(NULL), next(NULL) {}
+        intrusive_list_hook(const intrusive_list_hook &) :
+                prev(NULL), next(NULL) {}
+        intrusive_list_hook &operator=(const intrusive_list_hook &)
+        {
+                return *this;
+        }
+        bool is_linked() const { return next != NULL; }
+        void unlink()
+        {
+                if (!next)
+                        return;
+                prev->next = next;
+                next->prev = prev;
+                prev = NULL;
+                next = NULL;
+        }
+};
+
+
+/*-------------------------------------------------------
+ * intrusive_owner - get the object holding the hook @h
+ * as its member @Hook, @T must be standard-layout for
+ * the member to be at the same offset in all objects
+ *-------------------------------------------------------
+ */
+template <typename T, typename H, H T::*Hook>
+T *intrusive_owner(H *h)
+{
+        static_assert(std::is_standard_layout<T>::value,
+                        "the objects on an intrusive list must be "
+                        "standard-layout");
+
+        /* set up on the first call, whenever that is */
+        static const std::ptrdiff_t off = reinterpret_cast<std::ptrdiff_t>(
+                        &(static_cast<T *>(NULL)->*Hook));
+        return reinterpret_cast<T *>(reinterpret_cast<unsigned char *>(h) -
+                        off);
+}
+
+
+/*
+ * A singly linked list of the objects of type @T through their member
+ * @Hook, walked forward only. Every link knows the one leading to it, so
+ * remove() takes O(1) from any position.
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+class intrusive_singly_linked_list {
+        private:
+                typedef intrusive_slist_hook hook;
+                hook *first;
+
+        public:
+                class iterator;
+
+                intrusive_singly_linked_list();
+                intrusive_singly_linked_list(
+                                const intrusive_singly_linked_list &) = delete;
+                intrusive_singly_linked_list &operator=(
+                                const intrusive_singly_linked_list &) = delete;
+                ~intrusive_singly_linked_list();
+                bool empty() const;
+                std::size_t size() const;
+                T *front();
+                T *next(T &obj);
+                iterator begin();
+                iterator end();
+                void push_front(T &obj);
+                void insert_after(T &pos, T &obj);
+                T *pop_front();
+                static void remove(T &obj);
+                static bool is_linked(const T &obj);
+                void clear();
+                void print();
+
+        private:
+                static T *owner(hook *h);
+};
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+class intrusive_singly_linked_list<T, Hook>::iterator {
+        private:
+                hook *h;
+
+        public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                explicit iterator(hook *h = NULL) : h(h) {}
+                T &operator*() const { return *owner(h); }
+                T *operator->() const { return owner(h); }
+                iterator &operator++()
+                {
+                        h = h->next;
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        h = h->next;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return h == it.h;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return h != it.h;
+                }
+};
+
+
+/*
+ * A doubly linked list of the objects of type @T through their member
+ * @Hook, circular around a hook of its own, so an object unlinks itself in
+ * O(1) without knowing the list it is on.
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+class intrusive_doubly_linked_list {
+        private:
+                typedef intrusive_list_hook hook;
+                hook root;
+
+        public:
+                class iterator;
+
+                intrusive_doubly_linked_list();
+                intrusive_doubly_linked_list(
+                                const intrusive_doubly_linked_list &) = delete;
+                intrusive_doubly_linked_list &operator=(
+                                const intrusive_doubly_linked_list &) = delete;
+                ~intrusive_doubly_linked_list();
+                bool empty() const;
+                std::size_t size() const;
+                T *front();
+                T *back();
+                T *next(T &obj);
+                T *prev(T &obj);
+                iterator begin();
+                iterator end();
+                void push_front(T &obj);
+                void push_back(T &obj);
+                void insert(T &pos, T &obj);
+                T *pop_front();
+                T *pop_back();
+                static void remove(T &obj);
+                static bool is_linked(const T &obj);
+                void clear();
+                void print();
+
+        private:
+                static T *owner(hook *h);
+                static void link(hook *prev, hook *h);
+};
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+class intrusive_doubly_linked_list<T, Hook>::iterator {
+        private:
+                hook *h;
+
+        public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                explicit iterator(hook *h = NULL) : h(h) {}
+                T &operator*() const { return *owner(h); }
+                T *operator->() const { return owner(h); }
+                iterator &operator++()
+                {
+                        h = h->next;
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        h = h->next;
+                        return it;
+                }
+                iterator &operator--()
+                {
+                        h = h->prev;
+                        return *this;
+                }
+                iterator operator--(int)
+                {
+                        iterator it = *this;
+                        h = h->prev;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return h == it.h;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return h != it.h;
+                }
+};
+
+
+/*-------------------------------------------------------
+ * intrusive_singly_linked_list
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+intrusive_singly_linked_list<T, Hook>::intrusive_singly_linked_list()
+{
+        this->first = NULL;
+}
+
+
+/*-------------------------------------------------------
+ * ~intrusive_singly_linked_list - unlink all objects,
+ * which are left alone
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+intrusive_singly_linked_list<T, Hook>::~intrusive_singly_linked_list()
+{
+        this->clear();
+}
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+bool intrusive_singly_linked_list<T, Hook>::empty() const
+{
+        return !this->first;
+}
+
+
+/*-------------------------------------------------------
+ * size - count the objects, in O(n)
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+std::size_t intrusive_singly_linked_list<T, Hook>::size() const
+{
+        std::size_t n = 0;
+        for (hook *h = this->first; h; h = h->next)
+                ++n;
+        return n;
+}
+
+
+/*-------------------------------------------------------
+ * front - get the first object, NULL if empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+T *intrusive_singly_linked_list<T, Hook>::front()
+{
+        return this->first ? owner(this->first) : NULL;
+}
+
+
+/*-------------------------------------------------------
+ * next - get the object after @obj, NULL if it's the
+ * last one
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+T *intrusive_singly_linked_list<T, Hook>::next(T &obj)
+{
+        hook *h = (obj.*Hook).next;
+        return h ? owner(h) : NULL;
+}
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+typename intrusive_singly_linked_list<T, Hook>::iterator
+intrusive_singly_linked_list<T, Hook>::begin()
+{
+        return iterator(this->first);
+}
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+typename intrusive_singly_linked_list<T, Hook>::iterator
+intrusive_singly_linked_list<T, Hook>::end()
+{
+        return iterator(NULL);
+}
+
+
+/*-------------------------------------------------------
+ * push_front - link @obj, which must not be on a list of
+ * this hook, at the front
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+void intrusive_singly_linked_list<T, Hook>::push_front(T &obj)
+{
+        hook *h = &(obj.*Hook);
+        h->next = this->first;
+        if (this->first)
+                this->first->pprev = &h->next;
+        this->first = h;
+        h->pprev = &this->first;
+}
+
+
+/*-------------------------------------------------------
+ * insert_after - link @obj, which must not be on a list
+ * of this hook, after @pos
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+void intrusive_singly_linked_list<T, Hook>::insert_after(T &pos, T &obj)
+{
+        hook *p = &(pos.*Hook);
+        hook *h = &(obj.*Hook);
+        h->next = p->next;
+        if (p->next)
+                p->next->pprev = &h->next;
+        p->next = h;
+        h->pprev = &p->next;
+}
+
+
+/*-------------------------------------------------------
+ * pop_front - unlink the first object, return it, NULL
+ * if empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+T *intrusive_singly_linked_list<T, Hook>::pop_front()
+{
+        if (!this->first)
+                return NULL;
+        hook *h = this->first;
+        h->unlink();
+        return owner(h);
+}
+
+
+/*-------------------------------------------------------
+ * remove - unlink @obj from whatever list of this hook
+ * it is on, in O(1)
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+void intrusive_singly_linked_list<T, Hook>::remove(T &obj)
+{
+        (obj.*Hook).unlink();
+}
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+bool intrusive_singly_linked_list<T, Hook>::is_linked(const T &obj)
+{
+        return (obj.*Hook).is_linked();
+}
+
+
+/*-------------------------------------------------------
+ * clear - unlink all objects
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+void intrusive_singly_linked_list<T, Hook>::clear()
+{
+        while (this->first)
+                this->first->unlink();
+}
+
+
+/*-------------------------------------------------------
+ * print - print all objects
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_slist_hook T::*Hook>
+void intrusive_singly_linked_list<T, Hook>::print()
+{
+        for (hook *h = this->first; h; h = h->next)
+                std::cout << *owner(h) << " ";
+        std::cout << std::endl;
+}
+
+
+template <typename T, intrusive_slist_hook T::*Hook>
+T *intrusive_singly_linked_list<T, Hook>::owner(hook *h)
+{
+        return intrusive_owner<T, hook, Hook>(h);
+}
+
+
+/*-------------------------------------------------------
+ * intrusive_doubly_linked_list
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+intrusive_doubly_linked_list<T, Hook>::intrusive_doubly_linked_list()
+{
+        this->root.prev = &this->root;
+        this->root.next = &this->root;
+}
+
+
+/*-------------------------------------------------------
+ * ~intrusive_doubly_linked_list - unlink all objects,
+ * which are left alone
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+intrusive_doubly_linked_list<T, Hook>::~intrusive_doubly_linked_list()
+{
+        this->clear();
+}
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+bool intrusive_doubly_linked_list<T, Hook>::empty() const
+{
+        return this->root.next == &this->root;
+}
+
+
+/*-------------------------------------------------------
+ * size - count the objects, in O(n)
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+std::size_t intrusive_doubly_linked_list<T, Hook>::size() const
+{
+        std::size_t n = 0;
+        for (const hook *h = this->root.next; h != &this->root; h = h->next)
+                ++n;
+        return n;
+}
+
+
+/*-------------------------------------------------------
+ * front - get the first object, NULL if empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::front()
+{
+        return this->empty() ? NULL : owner(this->root.next);
+}
+
+
+/*-------------------------------------------------------
+ * back - get the last object, NULL if empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::back()
+{
+        return this->empty() ? NULL : owner(this->root.prev);
+}
+
+
+/*-------------------------------------------------------
+ * next - get the object after @obj, NULL if it's the
+ * last one
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::next(T &obj)
+{
+        hook *h = (obj.*Hook).next;
+        return h == &this->root ? NULL : owner(h);
+}
+
+
+/*-------------------------------------------------------
+ * prev - get the object before @obj, NULL if it's the
+ * first one
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::prev(T &obj)
+{
+        hook *h = (obj.*Hook).prev;
+        return h == &this->root ? NULL : owner(h);
+}
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+typename intrusive_doubly_linked_list<T, Hook>::iterator
+intrusive_doubly_linked_list<T, Hook>::begin()
+{
+        return iterator(this->root.next);
+}
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+typename intrusive_doubly_linked_list<T, Hook>::iterator
+intrusive_doubly_linked_list<T, Hook>::end()
+{
+        return iterator(&this->root);
+}
+
+
+/*-------------------------------------------------------
+ * push_front - link @obj, which must not be on a list of
+ * this hook, at the front
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::push_front(T &obj)
+{
+        link(&this->root, &(obj.*Hook));
+}
+
+
+/*-------------------------------------------------------
+ * push_back - link @obj, which must not be on a list of
+ * this hook, at the back
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::push_back(T &obj)
+{
+        link(this->root.prev, &(obj.*Hook));
+}
+
+
+/*-------------------------------------------------------
+ * insert - link @obj, which must not be on a list of
+ * this hook, before @pos
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::insert(T &pos, T &obj)
+{
+        link((pos.*Hook).prev, &(obj.*Hook));
+}
+
+
+/*-------------------------------------------------------
+ * pop_front - unlink the first object, return it, NULL
+ * if empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::pop_front()
+{
+        if (this->empty())
+                return NULL;
+        hook *h = this->root.next;
+        h->unlink();
+        return owner(h);
+}
+
+
+/*-------------------------------------------------------
+ * pop_back - unlink the last object, return it, NULL if
+ * empty
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::pop_back()
+{
+        if (this->empty())
+                return NULL;
+        hook *h = this->root.prev;
+        h->unlink();
+        return owner(h);
+}
+
+
+/*-------------------------------------------------------
+ * remove - unlink @obj from whatever list of this hook
+ * it is on, in O(1)
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::remove(T &obj)
+{
+        (obj.*Hook).unlink();
+}
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+bool intrusive_doubly_linked_list<T, Hook>::is_linked(const T &obj)
+{
+        return (obj.*Hook).is_linked();
+}
+
+
+/*-------------------------------------------------------
+ * clear - unlink all objects
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::clear()
+{
+        while (!this->empty())
+                this->root.next->unlink();
+}
+
+
+/*-------------------------------------------------------
+ * print - print all objects
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::print()
+{
+        for (hook *h = this->root.next; h != &this->root; h = h->next)
+                std::cout << *owner(h) << " ";
+        std::cout << std::endl;
+}
+
+
+template <typename T, intrusive_list_hook T::*Hook>
+T *intrusive_doubly_linked_list<T, Hook>::owner(hook *h)
+{
+        return intrusive_owner<T, hook, Hook>(h);
+}
+
+
+/*-------------------------------------------------------
+ * link - link the hook @h after @prev
+ *-------------------------------------------------------
+ */
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_doubly_linked_list<T, Hook>::link(hook *prev, hook *h)
+{
+        h->prev = prev;
+        h->next = prev->next;
+        prev->next->prev = h;
+        prev->next = h;
+}
+
+
+/*=======================================================
+ * The containers own a whole list of nodes and keep its
+ * length and its last node, so the operations at either
+ * end, size() and moving nodes between lists take O(1)
+ * instead of a walk from the head. Their head and tail
+ * nodes are the links alone, so no element is built for
+ * them and T needs no default constructor.
+ *=======================================================
+ */
+
+/*-------------------------------------------------------
+ * list_slink - the link of a singly linked container, a
+ * whole node is a list_snode holding the element too
+ *-------------------------------------------------------
+ */
+struct list_slink {
+        list_slink *next;
+
+        list_slink() : next(NULL) {}
+};
+
+template <typename T>
+struct list_snode : list_slink {
+        T elem;
+
+        template <typename... Args>
+        list_snode(std::in_place_t, Args &&...args)
+                : list_slink(), elem(std::forward<Args>(args)...) {}
+};
+
+
+/*-------------------------------------------------------
+ * list_dlink - the links of a doubly linked container, a
+ * whole node is a list_dnode holding the element too
+ *-------------------------------------------------------
+ */
+struct list_dlink {
+        list_dlink *prev;
+        list_dlink *next;
+
+        list_dlink() : prev(NULL), next(NULL) {}
+};
+
+template <typename T>
+struct list_dnode : list_dlink {
+        T elem;
+
+        template <typename... Args>
+        list_dnode(std::in_place_t, Args &&...args)
+                : list_dlink(), elem(std::forward<Args>(args)...) {}
+};
+
+
+/*-------------------------------------------------------
+ * list_merge_chain - merge the sorted NULL-ended chains
+ * @a and @b by @less, the nodes of @a first among equal
+ * ones, return the first node
+ *-------------------------------------------------------
+ */
+template <typename Node, typename Compare>
+Node *list_merge_chain(Node *a, Node *b, Compare &less)
+{
+        typedef decltype(a->next) link_ptr;
+        link_ptr first = NULL;
+        link_ptr *link = &first;
+        while (a && b) {
+                if (less(b->elem, a->elem)) {
+                        *link = b;
+                        b = static_cast<Node *>(b->next);
+                } else {
+                        *link = a;
+                        a = static_cast<Node *>(a->next);
+                }
+                link = &(*link)->next;
+        }
+        *link = a ? a : b;
+        return static_cast<Node *>(first);
+}
+
+
+/*-------------------------------------------------------
+ * list_sort_chain - sort the NULL-ended chain from
+ * @first by @less, keeping the order of equal elements,
+ * return the first node
+ *
+ * A bottom-up merge sort: run i holds 2^i nodes merged
+ * already, and every node taken off the chain is carried
+ * up through the runs like a bit of a binary counter, so
+ * it takes O(n log n) time, the 64 runs the only memory.
+ *-------------------------------------------------------
+ */
+template <typename Node, typename Compare>
+Node *list_sort_chain(Node *first, Compare &less)
+{
+        Node *run[64] = {};
+        int top = 0;
+        while (first) {
+                Node *carry = first;
+                first = static_cast<Node *>(first->next);
+                carry->next = NULL;
+                int i = 0;
+                for (; run[i]; ++i) {
+                        carry = list_merge_chain(run[i], carry, less);
+                        run[i] = NULL;
+                }
+                run[i] = carry;
+                if (i >= top)
+                        top = i + 1;
+        }
+        Node *sorted = NULL;
+        for (int i = 0; i < top; ++i)
+                if (run[i])
+                        sorted = list_merge_chain(run[i], sorted, less);
+        return sorted;
+}
+
+
+/*
+ * A singly linked list owning its nodes, a head node before the first one
+ * and a pointer to the last one, which is the head node when empty.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class singly_linked_container : private list_alloc_holder<
+                list_node_alloc<list_snode<T>, Alloc>> {
+        private:
+                typedef list_snode<T> node;
+                typedef list_node_alloc<node, Alloc> node_alloc;
+                typedef std::allocator_traits<node_alloc> node_traits;
+                typedef list_alloc_holder<node_alloc> alloc_base;
+
+                list_slink head;
+                list_slink *last;
+                std::size_t len;
+
+        public:
+                class iterator;
+
+                singly_linked_container();
+                explicit singly_linked_container(const Alloc &alloc);
+                singly_linked_container(const singly_linked_container &other);
+                singly_linked_container(singly_linked_container &&other);
+                singly_linked_container &operator=(
+                                const singly_linked_container &other);
+                singly_linked_container &operator=(
+                                singly_linked_container &&other);
+                ~singly_linked_container();
+                Alloc get_allocator() const;
+                std::size_t size() const;
+                bool empty() const;
+                T &front();
+                T &back();
+                iterator before_begin();
+                iterator begin();
+                iterator end();
+                iterator find(const T &elem);
+                void push_front(const T &elem);
+                void push_front(T &&elem);
+                void push_back(const T &elem);
+                void push_back(T &&elem);
+                template <typename... Args>
+                T &emplace_front(Args &&...args);
+                template <typename... Args>
+                T &emplace_back(Args &&...args);
+                void pop_front();
+                iterator insert_after(iterator pos, const T &elem);
+                iterator insert_after(iterator pos, T &&elem);
+                template <typename... Args>
+                iterator emplace_after(iterator pos, Args &&...args);
+                iterator erase_after(iterator pos);
+                void splice_after(iterator pos,
+                                singly_linked_container &other);
+                template <typename Compare = std::less<T>>
+                void merge(singly_linked_container &other,
+                                Compare less = Compare());
+                template <typename Compare = std::less<T>>
+                void sort(Compare less = Compare());
+                void clear();
+                void swap(singly_linked_container &other);
+                void print();
+
+        private:
+                template <typename... Args>
+                node *make(Args &&...args);
+                void release(node *n);
+                void adopt(list_slink *first, list_slink *tail,
+                                std::size_t n);
+};
+
+
+template <typename T, typename Alloc>
+class singly_linked_container<T, Alloc>::iterator {
+        private:
+                friend class singly_linked_container<T, Alloc>;
+                list_slink *n;
+
+                explicit iterator(list_slink *n) : n(n) {}
+
+        public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                iterator() : n(NULL) {}
+                T &operator*() const
+                {
+                        return static_cast<node *>(n)->elem;
+                }
+                T *operator->() const
+                {
+                        return &static_cast<node *>(n)->elem;
+                }
+                iterator &operator++()
+                {
+                        n = n->next;
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        n = n->next;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return n == it.n;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return n != it.n;
+                }
+};
+
+
+/*
+ * A doubly linked list owning its nodes between a head node and a tail
+ * node of its own, so no operation has to tell the ends apart.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class doubly_linked_container : private list_alloc_holder<
+                list_node_alloc<list_dnode<T>, Alloc>> {
+        private:
+                typedef list_dnode<T> node;
+                typedef list_node_alloc<node, Alloc> node_alloc;
+                typedef std::allocator_traits<node_alloc> node_traits;
+                typedef list_alloc_holder<node_alloc> alloc_base;
+
+                list_dlink head;
+                list_dlink tail;
+                std::size_t len;
+
+        public:
+                class iterator;
+
+                doubly_linked_container();
+                explicit doubly_linked_container(const Alloc &alloc);
+                doubly_linked_container(const doubly_linked_container &other);
+                doubly_linked_container(doubly_linked_container &&other);
+                doubly_linked_container &operator=(
+                                const doubly_linked_container &other);
+                doubly_linked_container &operator=(
+                                doubly_linked_container &&other);
+                ~doubly_linked_container();
+                Alloc get_allocator() const;
+                std::size_t size() const;
+                bool empty() const;
+                T &front();
+                T &back();
+                iterator begin();
+                iterator end();
+                iterator find(const T &elem);
+                void push_front(const T &elem);
+                void push_front(T &&elem);
+                void push_back(const T &elem);
+                void push_back(T &&elem);
+                template <typename... Args>
+                T &emplace_front(Args &&...args);
+                template <typename... Args>
+                T &emplace_back(Args &&...args);
+                void pop_front();
+                void pop_back();
+                iterator insert(iterator pos, const T &elem);
+                iterator insert(iterator pos, T &&elem);
+                template <typename... Args>
+                iterator emplace(iterator pos, Args &&...args);
+                iterator erase(iterator pos);
+                void splice(iterator pos, doubly_linked_container &other);
+                void splice(iterator pos, doubly_linked_container &other,
+                                iterator it);
+                void splice(iterator pos, doubly_linked_container &other,
+                                iterator first, iterator last);
+                template <typename Compare = std::less<T>>
+                void merge(doubly_linked_container &other,
+                                Compare less = Compare());
+                template <typename Compare = std::less<T>>
+                void sort(Compare less = Compare());
+                void clear();
+                void swap(doubly_linked_container &other);
+                void print();
+
+        private:
+                template <typename... Args>
+                node *make(Args &&...args);
+                void release(node *n);
+                void adopt(list_dlink *first, std::size_t n);
+                static void link(list_dlink *pos, list_dlink *first,
+                                list_dlink *last);
+                static void unlink(list_dlink *first, list_dlink *last);
+};
+
+
+template <typename T, typename Alloc>
+class doubly_linked_container<T, Alloc>::iterator {
+        private:
+                friend class doubly_linked_container<T, Alloc>;
+                list_dlink *n;
+
+                explicit iterator(list_dlink *n) : n(n) {}
+
+        public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                iterator() : n(NULL) {}
+                T &operator*() const
+                {
+                        return static_cast<node *>(n)->elem;
+                }
+                T *operator->() const
+                {
+                        return &static_cast<node *>(n)->elem;
+                }
+                iterator &operator++()
+                {
+                        n = n->next;
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        n = n->next;
+                        return it;
+                }
+                iterator &operator--()
+                {
+                        n = n->prev;
+                        return *this;
+                }
+                iterator operator--(int)
+                {
+                        iterator it = *this;
+                        n = n->prev;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return n == it.n;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return n != it.n;
+                }
+};
+
+
+/*-------------------------------------------------------
+ * singly_linked_container
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc>::singly_linked_container()
+        : last(&head), len(0)
+{
+}
+
+
+/*-------------------------------------------------------
+ * singly_linked_container - create an empty list whose
+ * nodes come from @alloc
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc>::singly_linked_container(
+                const Alloc &alloc)
+        : alloc_base(node_alloc(alloc)), last(&head), len(0)
+{
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc>::singly_linked_container(
+                const singly_linked_container &other)
+        : alloc_base(node_traits::select_on_container_copy_construction(
+                                other.node_allocator())),
+        last(&head), len(0)
+{
+        try {
+                for (list_slink *p = other.head.next; p; p = p->next)
+                        this->push_back(static_cast<node *>(p)->elem);
+        } catch (...) {
+                this->clear();
+                throw;
+        }
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc>::singly_linked_container(
+                singly_linked_container &&other)
+        : alloc_base(other.node_allocator()), last(&head), len(0)
+{
+        this->adopt(other.head.next, other.last, other.len);
+        other.adopt(NULL, NULL, 0);
+}
+
+
+/*-------------------------------------------------------
+ * operator= - copy the elements of @other, and its
+ * allocator if that propagates on copy assignment
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc> &
+singly_linked_container<T, Alloc>::operator=(
+                const singly_linked_container &other)
+{
+        if (&other == this)
+                return *this;
+        this->clear();
+        if constexpr (node_traits::propagate_on_container_copy_assignment::
+                        value)
+                this->node_allocator() = other.node_allocator();
+        for (list_slink *p = other.head.next; p; p = p->next)
+                this->push_back(static_cast<node *>(p)->elem);
+        return *this;
+}
+
+
+/*-------------------------------------------------------
+ * operator= - take the nodes of @other if its allocator
+ * propagates on move assignment or equals this one, and
+ * move the elements one by one otherwise
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc> &
+singly_linked_container<T, Alloc>::operator=(singly_linked_container &&other)
+{
+        if (&other == this)
+                return *this;
+        this->clear();
+        if constexpr (node_traits::propagate_on_container_move_assignment::
+                        value) {
+                this->node_allocator() = std::move(other.node_allocator());
+        } else if (!(this->node_allocator() == other.node_allocator())) {
+                for (list_slink *p = other.head.next; p; p = p->next)
+                        this->push_back(std::move(
+                                                static_cast<node *>(p)->elem));
+                other.clear();
+                return *this;
+        }
+        this->adopt(other.head.next, other.last, other.len);
+        other.adopt(NULL, NULL, 0);
+        return *this;
+}
+
+
+template <typename T, typename Alloc>
+singly_linked_container<T, Alloc>::~singly_linked_container()
+{
+        this->clear();
+}
+
+
+template <typename T, typename Alloc>
+Alloc singly_linked_container<T, Alloc>::get_allocator() const
+{
+        return Alloc(this->node_allocator());
+}
+
+
+template <typename T, typename Alloc>
+std::size_t singly_linked_container<T, Alloc>::size() const
+{
+        return len;
+}
+
+
+template <typename T, typename Alloc>
+bool singly_linked_container<T, Alloc>::empty() const
+{
+        return len == 0;
+}
+
+
+template <typename T, typename Alloc>
+T &singly_linked_container<T, Alloc>::front()
+{
+        return static_cast<node *>(head.next)->elem;
+}
+
+
+template <typename T, typename Alloc>
+T &singly_linked_container<T, Alloc>::back()
+{
+        return static_cast<node *>(last)->elem;
+}
+
+
+/*-------------------------------------------------------
+ * before_begin - get the position of the head node, to
+ * insert or erase after
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::before_begin()
+{
+        return iterator(&head);
+}
+
+
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::begin()
+{
+        return iterator(head.next);
+}
+
+
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::end()
+{
+        return iterator(NULL);
+}
+
+
+/*-------------------------------------------------------
+ * find - find the first element equal to @elem, return
+ * end() if not found
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::find(const T &elem)
+{
+        list_slink *p = head.next;
+        while (p && !(static_cast<node *>(p)->elem == elem))
+                p = p->next;
+        return iterator(p);
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::push_front(const T &elem)
+{
+        this->emplace_after(this->before_begin(), elem);
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::push_front(T &&elem)
+{
+        this->emplace_after(this->before_begin(), std::move(elem));
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::push_back(const T &elem)
+{
+        this->emplace_after(iterator(last), elem);
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::push_back(T &&elem)
+{
+        this->emplace_after(iterator(last), std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace_front - insert an element constructed in place
+ * from @args at the front, return it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+T &singly_linked_container<T, Alloc>::emplace_front(Args &&...args)
+{
+        return *this->emplace_after(this->before_begin(),
+                        std::forward<Args>(args)...);
+}
+
+
+/*-------------------------------------------------------
+ * emplace_back - append an element constructed in place
+ * from @args, return it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+T &singly_linked_container<T, Alloc>::emplace_back(Args &&...args)
+{
+        return *this->emplace_after(iterator(last),
+                        std::forward<Args>(args)...);
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::pop_front()
+{
+        this->erase_after(this->before_begin());
+}
+
+
+/*-------------------------------------------------------
+ * insert_after - insert @elem after @pos, return the
+ * position of the new element, throw std::bad_alloc if
+ * out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::insert_after(iterator pos, const T &elem)
+{
+        return this->emplace_after(pos, elem);
+}
+
+
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::insert_after(iterator pos, T &&elem)
+{
+        return this->emplace_after(pos, std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace_after - insert an element constructed in place
+ * from @args after @pos, return its position, throw
+ * std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::emplace_after(iterator pos,
+                Args &&...args)
+{
+        node *n = this->make(std::forward<Args>(args)...);
+        n->next = pos.n->next;
+        pos.n->next = n;
+        if (last == pos.n)
+                last = n;
+        ++len;
+        return iterator(n);
+}
+
+
+/*-------------------------------------------------------
+ * erase_after - remove the element after @pos, return
+ * the position after the removed one
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename singly_linked_container<T, Alloc>::iterator
+singly_linked_container<T, Alloc>::erase_after(iterator pos)
+{
+        list_slink *n = pos.n->next;
+        pos.n->next = n->next;
+        if (last == n)
+                last = pos.n;
+        this->release(static_cast<node *>(n));
+        --len;
+        return iterator(pos.n->next);
+}
+
+
+/*-------------------------------------------------------
+ * splice_after - move all elements of @other after @pos,
+ * in O(1), the allocators must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::splice_after(iterator pos,
+                singly_linked_container &other)
+{
+        if (&other == this || other.empty())
+                return;
+        other.last->next = pos.n->next;
+        pos.n->next = other.head.next;
+        if (last == pos.n)
+                last = other.last;
+        len += other.len;
+        other.adopt(NULL, NULL, 0);
+}
+
+
+/*-------------------------------------------------------
+ * merge - move the elements of @other into this list,
+ * both sorted by @less, keeping it sorted, in O(n), the
+ * allocators must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename Compare>
+void singly_linked_container<T, Alloc>::merge(singly_linked_container &other,
+                Compare less)
+{
+        if (&other == this || other.empty())
+                return;
+        node *first = list_merge_chain(static_cast<node *>(head.next),
+                        static_cast<node *>(other.head.next), less);
+        std::size_t n = len + other.len;
+        other.adopt(NULL, NULL, 0);
+        list_slink *p = first;
+        while (p->next)
+                p = p->next;
+        this->adopt(first, p, n);
+}
+
+
+/*-------------------------------------------------------
+ * sort - sort the elements by @less, keeping the order
+ * of equal ones, in O(n log n) by relinking the nodes
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename Compare>
+void singly_linked_container<T, Alloc>::sort(Compare less)
+{
+        if (len < 2)
+                return;
+        node *first = list_sort_chain(static_cast<node *>(head.next), less);
+        list_slink *p = first;
+        while (p->next)
+                p = p->next;
+        this->adopt(first, p, len);
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::clear()
+{
+        list_slink *p = head.next;
+        while (p) {
+                list_slink *next = p->next;
+                this->release(static_cast<node *>(p));
+                p = next;
+        }
+        this->adopt(NULL, NULL, 0);
+}
+
+
+/*-------------------------------------------------------
+ * swap - swap the elements with @other in O(1), the
+ * allocators too if they propagate on swap, else they
+ * must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::swap(singly_linked_container &other)
+{
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(this->node_allocator(), other.node_allocator());
+        }
+        list_slink *first = head.next, *tail = last;
+        std::size_t n = len;
+        this->adopt(other.head.next, other.last, other.len);
+        other.adopt(first, tail, n);
+}
+
+
+/*-------------------------------------------------------
+ * print - print all elements
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::print()
+{
+        for (list_slink *p = head.next; p; p = p->next)
+                std::cout << static_cast<node *>(p)->elem << " ";
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * make - allocate a node and construct its element from
+ * @args, throw std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+typename singly_linked_container<T, Alloc>::node *
+singly_linked_container<T, Alloc>::make(Args &&...args)
+{
+        node_alloc &a = this->node_allocator();
+        node *p = node_traits::allocate(a, 1);
+        try {
+                node_traits::construct(a, p, std::in_place,
+                                std::forward<Args>(args)...);
+        } catch (...) {
+                node_traits::deallocate(a, p, 1);
+                throw;
+        }
+        return p;
+}
+
+
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::release(node *n)
+{
+        node_alloc &a = this->node_allocator();
+        node_traits::destroy(a, n);
+        node_traits::deallocate(a, n, 1);
+}
+
+
+/*-------------------------------------------------------
+ * adopt - take the chain of @n nodes from @first to
+ * @tail as the whole list, forgetting the nodes it had
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void singly_linked_container<T, Alloc>::adopt(list_slink *first,
+                list_slink *tail, std::size_t n)
+{
+        head.next = n ? first : NULL;
+        last = n ? tail : &head;
+        last->next = NULL;
+        len = n;
+}
+
+
+/*-------------------------------------------------------
+ * doubly_linked_container
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc>::doubly_linked_container()
+{
+        this->adopt(NULL, 0);
+}
+
+
+/*-------------------------------------------------------
+ * doubly_linked_container - create an empty list whose
+ * nodes come from @alloc
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc>::doubly_linked_container(
+                const Alloc &alloc)
+        : alloc_base(node_alloc(alloc))
+{
+        this->adopt(NULL, 0);
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc>::doubly_linked_container(
+                const doubly_linked_container &other)
+        : alloc_base(node_traits::select_on_container_copy_construction(
+                                other.node_allocator()))
+{
+        this->adopt(NULL, 0);
+        try {
+                for (list_dlink *p = other.head.next; p != &other.tail;
+                                p = p->next)
+                        this->push_back(static_cast<node *>(p)->elem);
+        } catch (...) {
+                this->clear();
+                throw;
+        }
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc>::doubly_linked_container(
+                doubly_linked_container &&other)
+        : alloc_base(other.node_allocator())
+{
+        this->adopt(NULL, 0);
+        this->splice(this->end(), other);
+}
+
+
+/*-------------------------------------------------------
+ * operator= - copy the elements of @other, and its
+ * allocator if that propagates on copy assignment
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc> &
+doubly_linked_container<T, Alloc>::operator=(
+                const doubly_linked_container &other)
+{
+        if (&other == this)
+                return *this;
+        this->clear();
+        if constexpr (node_traits::propagate_on_container_copy_assignment::
+                        value)
+                this->node_allocator() = other.node_allocator();
+        for (list_dlink *p = other.head.next; p != &other.tail; p = p->next)
+                this->push_back(static_cast<node *>(p)->elem);
+        return *this;
+}
+
+
+/*-------------------------------------------------------
+ * operator= - take the nodes of @other if its allocator
+ * propagates on move assignment or equals this one, and
+ * move the elements one by one otherwise
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc> &
+doubly_linked_container<T, Alloc>::operator=(doubly_linked_container &&other)
+{
+        if (&other == this)
+                return *this;
+        this->clear();
+        if constexpr (node_traits::propagate_on_container_move_assignment::
+                        value) {
+                this->node_allocator() = std::move(other.node_allocator());
+        } else if (!(this->node_allocator() == other.node_allocator())) {
+                for (list_dlink *p = other.head.next; p != &other.tail;
+                                p = p->next)
+                        this->push_back(std::move(
+                                                static_cast<node *>(p)->elem));
+                other.clear();
+                return *this;
+        }
+        this->splice(this->end(), other);
+        return *this;
+}
+
+
+template <typename T, typename Alloc>
+doubly_linked_container<T, Alloc>::~doubly_linked_container()
+{
+        this->clear();
+}
+
+
+template <typename T, typename Alloc>
+Alloc doubly_linked_container<T, Alloc>::get_allocator() const
+{
+        return Alloc(this->node_allocator());
+}
+
+
+template <typename T, typename Alloc>
+std::size_t doubly_linked_container<T, Alloc>::size() const
+{
+        return len;
+}
+
+
+template <typename T, typename Alloc>
+bool doubly_linked_container<T, Alloc>::empty() const
+{
+        return len == 0;
+}
+
+
+template <typename T, typename Alloc>
+T &doubly_linked_container<T, Alloc>::front()
+{
+        return static_cast<node *>(head.next)->elem;
+}
+
+
+template <typename T, typename Alloc>
+T &doubly_linked_container<T, Alloc>::back()
+{
+        return static_cast<node *>(tail.prev)->elem;
+}
+
+
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::begin()
+{
+        return iterator(head.next);
+}
+
+
+/*-------------------------------------------------------
+ * end - get the position of the tail node, after the
+ * last element
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::end()
+{
+        return iterator(&tail);
+}
+
+
+/*-------------------------------------------------------
+ * find - find the first element equal to @elem, return
+ * end() if not found
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::find(const T &elem)
+{
+        list_dlink *p = head.next;
+        while (p != &tail && !(static_cast<node *>(p)->elem == elem))
+                p = p->next;
+        return iterator(p);
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::push_front(const T &elem)
+{
+        this->emplace(this->begin(), elem);
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::push_front(T &&elem)
+{
+        this->emplace(this->begin(), std::move(elem));
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::push_back(const T &elem)
+{
+        this->emplace(this->end(), elem);
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::push_back(T &&elem)
+{
+        this->emplace(this->end(), std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace_front - insert an element constructed in place
+ * from @args at the front, return it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+T &doubly_linked_container<T, Alloc>::emplace_front(Args &&...args)
+{
+        return *this->emplace(this->begin(), std::forward<Args>(args)...);
+}
+
+
+/*-------------------------------------------------------
+ * emplace_back - append an element constructed in place
+ * from @args, return it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+T &doubly_linked_container<T, Alloc>::emplace_back(Args &&...args)
+{
+        return *this->emplace(this->end(), std::forward<Args>(args)...);
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::pop_front()
+{
+        this->erase(this->begin());
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::pop_back()
+{
+        this->erase(iterator(tail.prev));
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert @elem before @pos, return the position
+ * of the new element, throw std::bad_alloc if out of
+ * memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::insert(iterator pos, const T &elem)
+{
+        return this->emplace(pos, elem);
+}
+
+
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::insert(iterator pos, T &&elem)
+{
+        return this->emplace(pos, std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * emplace - insert an element constructed in place from
+ * @args before @pos, return its position, throw
+ * std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::emplace(iterator pos, Args &&...args)
+{
+        node *n = this->make(std::forward<Args>(args)...);
+        link(pos.n, n, n);
+        ++len;
+        return iterator(n);
+}
+
+
+/*-------------------------------------------------------
+ * erase - remove the element at @pos, return the
+ * position after it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+typename doubly_linked_container<T, Alloc>::iterator
+doubly_linked_container<T, Alloc>::erase(iterator pos)
+{
+        list_dlink *next = pos.n->next;
+        unlink(pos.n, pos.n);
+        this->release(static_cast<node *>(pos.n));
+        --len;
+        return iterator(next);
+}
+
+
+/*-------------------------------------------------------
+ * splice - move all elements of @other before @pos, in
+ * O(1), the allocators must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::splice(iterator pos,
+                doubly_linked_container &other)
+{
+        if (&other == this || other.empty())
+                return;
+        list_dlink *first = other.head.next, *last = other.tail.prev;
+        unlink(first, last);
+        link(pos.n, first, last);
+        len += other.len;
+        other.len = 0;
+}
+
+
+/*-------------------------------------------------------
+ * splice - move the element at @it of @other, which may
+ * be this list, before @pos, in O(1)
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::splice(iterator pos,
+                doubly_linked_container &other, iterator it)
+{
+        if (pos == it || pos.n == it.n->next)
+                return;
+        unlink(it.n, it.n);
+        link(pos.n, it.n, it.n);
+        --other.len;
+        ++len;
+}
+
+
+/*-------------------------------------------------------
+ * splice - move the elements from @first to before
+ * @last of @other before @pos, in O(1) within one list
+ * and else in O(the elements moved) to count them
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::splice(iterator pos,
+                doubly_linked_container &other, iterator first,
+                iterator last)
+{
+        if (first == last)
+                return;
+        if (&other != this) {
+                std::size_t n = 0;
+                for (iterator it = first; it != last; ++it)
+                        ++n;
+                other.len -= n;
+                len += n;
+        }
+        list_dlink *back = last.n->prev;
+        unlink(first.n, back);
+        link(pos.n, first.n, back);
+}
+
+
+/*-------------------------------------------------------
+ * merge - move the elements of @other into this list,
+ * both sorted by @less, keeping it sorted, in O(n), the
+ * allocators must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename Compare>
+void doubly_linked_container<T, Alloc>::merge(doubly_linked_container &other,
+                Compare less)
+{
+        if (&other == this || other.empty())
+                return;
+        std::size_t n = len + other.len;
+        tail.prev->next = NULL;
+        other.tail.prev->next = NULL;
+        node *first = list_merge_chain(
+                        len ? static_cast<node *>(head.next) : NULL,
+                        static_cast<node *>(other.head.next), less);
+        other.adopt(NULL, 0);
+        this->adopt(first, n);
+}
+
+
+/*-------------------------------------------------------
+ * sort - sort the elements by @less, keeping the order
+ * of equal ones, in O(n log n) by relinking the nodes
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename Compare>
+void doubly_linked_container<T, Alloc>::sort(Compare less)
+{
+        if (len < 2)
+                return;
+        tail.prev->next = NULL;
+        this->adopt(list_sort_chain(static_cast<node *>(head.next), less),
+                        len);
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::clear()
+{
+        list_dlink *p = head.next;
+        while (p != &tail) {
+                list_dlink *next = p->next;
+                this->release(static_cast<node *>(p));
+                p = next;
+        }
+        this->adopt(NULL, 0);
+}
+
+
+/*-------------------------------------------------------
+ * swap - swap the elements with @other in O(1), the
+ * allocators too if they propagate on swap, else they
+ * must be equal
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::swap(doubly_linked_container &other)
+{
+        if (&other == this)
+                return;
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(this->node_allocator(), other.node_allocator());
+        }
+        list_dlink *first = head.next, *back = tail.prev;
+        std::size_t n = len;
+        this->adopt(NULL, 0);
+        this->splice(this->end(), other);
+        if (n) {
+                link(&other.tail, first, back);
+                other.len = n;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * print - print all elements
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::print()
+{
+        for (list_dlink *p = head.next; p != &tail; p = p->next)
+                std::cout << static_cast<node *>(p)->elem << " ";
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * make - allocate a node and construct its element from
+ * @args, throw std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+template <typename... Args>
+typename doubly_linked_container<T, Alloc>::node *
+doubly_linked_container<T, Alloc>::make(Args &&...args)
+{
+        node_alloc &a = this->node_allocator();
+        node *p = node_traits::allocate(a, 1);
+        try {
+                node_traits::construct(a, p, std::in_place,
+                                std::forward<Args>(args)...);
+        } catch (...) {
+                node_traits::deallocate(a, p, 1);
+                throw;
+        }
+        return p;
+}
+
+
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::release(node *n)
+{
+        node_alloc &a = this->node_allocator();
+        node_traits::destroy(a, n);
+        node_traits::deallocate(a, n, 1);
+}
+
+
+/*-------------------------------------------------------
+ * adopt - take the NULL-ended chain of @n nodes from
+ * @first as the whole list, linking it back to front,
+ * forgetting the nodes it had
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::adopt(list_dlink *first,
+                std::size_t n)
+{
+        list_dlink *prev = &head;
+        for (list_dlink *p = n ? first : NULL; p; p = p->next) {
+                p->prev = prev;
+                prev->next = p;
+                prev = p;
+        }
+        prev->next = &tail;
+        tail.prev = prev;
+        head.prev = NULL;
+        tail.next = NULL;
+        len = n;
+}
+
+
+/*-------------------------------------------------------
+ * link - link the chain from @first to @last before the
+ * node @pos
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::link(list_dlink *pos,
+                list_dlink *first, list_dlink *last)
+{
+        list_dlink *prev = pos->prev;
+        prev->next = first;
+        first->prev = prev;
+        last->next = pos;
+        pos->prev = last;
+}
+
+
+/*-------------------------------------------------------
+ * unlink - unlink the chain from @first to @last from
+ * the nodes around it
+ *-------------------------------------------------------
+ */
+template <typename T, typename Alloc>
+void doubly_linked_container<T, Alloc>::unlink(list_dlink *first,
+                list_dlink *last)
+{
+        first->prev->next = last->next;
+        last->next->prev = first->prev;
+}
+
+
 #endif /* LIST_HPP */
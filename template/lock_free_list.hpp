@@ -0,0 +1,301 @@
+/*=======================================================
+ * lock_free_list.hpp - an ordered set on a singly linked
+ * list that many threads change at once without a lock
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 05:31:09
+ *=======================================================
+ */
+
+#ifndef LOCK_FREE_LIST_HPP
+#define LOCK_FREE_LIST_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <new>
+#include "hazard_pointer.hpp"
+#include "node_pool.hpp"
+
+/*
+ * The list of Harris and Michael: the nodes, like those of the
+ * singly_linked_list, hold an element and the link to the next one, and
+ * are kept in the order of @Compare without duplicates. A node is removed
+ * in two steps, first marked deleted by setting the low bit of its own
+ * link, which stops any insertion after it, then unlinked from its
+ * predecessor, by the remover or by whoever walks past it first. The
+ * unlinked nodes go back to the node pool through the hazard pointers, so
+ * no thread frees a node another one is reading, and a node made again at
+ * the same address cannot fool a CAS.
+ *
+ * insert(), remove() and contains() are lock-free and may run in any
+ * number of threads at once; size() and print() only when none of them
+ * runs.
+ */
+template <typename T, typename Compare = std::less<T>>
+class lock_free_list {
+        private:
+                struct node {
+                        T elem;
+                        std::atomic<node *> next;
+
+                        node(const T &elem, node *next) :
+                                elem(elem), next(next) {}
+                };
+
+                typedef hazard_domain<2> domain;
+
+                node_pool<node> pool;
+                std::atomic<node *> head{NULL};
+                Compare less;
+                domain dom;             /* freed before the pool */
+
+        public:
+                lock_free_list(const lock_free_list &) = delete;
+                lock_free_list &operator=(const lock_free_list &) = delete;
+                explicit lock_free_list(const Compare &less = Compare());
+                ~lock_free_list();
+                bool insert(const T &elem);
+                bool remove(const T &elem);
+                bool contains(const T &elem);
+                bool empty() const;
+                std::size_t size() const;
+                void print() const;
+
+        private:
+                bool find(typename domain::holder &h, const T &elem,
+                                std::atomic<node *> *&prev, node *&cur,
+                                node *&next);
+                static void dispose(void *p, void *ctx);
+                static bool is_marked(node *p);
+                static node *marked(node *p);
+                static node *unmarked(node *p);
+};
+
+
+template <typename T, typename Compare>
+lock_free_list<T, Compare>::lock_free_list(const Compare &less) : less(less)
+{
+}
+
+
+/*-------------------------------------------------------
+ * ~lock_free_list - destroy all nodes, no thread may use
+ * the list meanwhile
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+lock_free_list<T, Compare>::~lock_free_list()
+{
+        node *p = head.load();
+        while (p) {
+                node *next = unmarked(p->next.load());
+                pool.destroy(p);
+                p = next;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert the element @elem, return false if
+ * it's in the list already, throw std::bad_alloc if out
+ * of memory
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::insert(const T &elem)
+{
+        typename domain::holder h(dom);
+        std::atomic<node *> *prev;
+        node *cur, *next;
+        node *n = NULL;
+        for (;;) {
+                if (find(h, elem, prev, cur, next)) {
+                        pool.destroy(n);
+                        return false;
+                }
+                if (!n) {
+                        n = pool.create(elem, cur);
+                        if (!n)
+                                throw std::bad_alloc();
+                } else {
+                        n->next.store(cur, std::memory_order_relaxed);
+                }
+                if (prev->compare_exchange_strong(cur, n))
+                        return true;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * remove - remove the element @elem, return false if
+ * it's not in the list
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::remove(const T &elem)
+{
+        typename domain::holder h(dom);
+        std::atomic<node *> *prev;
+        node *cur, *next;
+        for (;;) {
+                if (!find(h, elem, prev, cur, next))
+                        return false;
+                /* whoever marks the node removes the element */
+                if (!cur->next.compare_exchange_strong(next, marked(next)))
+                        continue;
+                node *expected = cur;
+                if (prev->compare_exchange_strong(expected, next))
+                        h.retire(cur, &dispose, this);
+                else
+                        find(h, elem, prev, cur, next);
+                return true;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * contains - check whether the element @elem is in the
+ * list
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::contains(const T &elem)
+{
+        typename domain::holder h(dom);
+        std::atomic<node *> *prev;
+        node *cur, *next;
+        return find(h, elem, prev, cur, next);
+}
+
+
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::empty() const
+{
+        return !head.load();
+}
+
+
+/*-------------------------------------------------------
+ * size - count the elements, in O(n)
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+std::size_t lock_free_list<T, Compare>::size() const
+{
+        std::size_t n = 0;
+        for (node *p = head.load(); p; ) {
+                node *next = p->next.load();
+                if (!is_marked(next))
+                        ++n;
+                p = unmarked(next);
+        }
+        return n;
+}
+
+
+/*-------------------------------------------------------
+ * print - print all elements
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+void lock_free_list<T, Compare>::print() const
+{
+        for (node *p = head.load(); p; ) {
+                node *next = p->next.load();
+                if (!is_marked(next))
+                        std::cout << p->elem << " ";
+                p = unmarked(next);
+        }
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * find - find the first node whose element is not less
+ * than @elem, unlinking the marked nodes on the way,
+ * return true if the element equals @elem
+ *
+ * On return @cur is the node found, NULL at the end,
+ * @prev the link to it and @next its successor, @cur
+ * and the node of @prev are held by the hazard pointers
+ * 0 and 1 of @h.
+ *-------------------------------------------------------
+ */
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::find(typename domain::holder &h,
+                const T &elem, std::atomic<node *> *&prev, node *&cur,
+                node *&next)
+{
+retry:
+        prev = &head;
+        cur = h.protect(0, *prev);
+        for (;;) {
+                if (!cur)
+                        return false;
+                next = cur->next.load();
+                if (is_marked(next)) {
+                        next = unmarked(next);
+                        node *expected = cur;
+                        if (!prev->compare_exchange_strong(expected, next))
+                                goto retry;
+                        h.retire(cur, &dispose, this);
+                        cur = next;
+                        h.set(0, cur);
+                        if (prev->load() != cur)
+                                goto retry;
+                        continue;
+                }
+                const T &e = cur->elem;
+                /* still linked, so the element was in the list */
+                if (prev->load() != cur)
+                        goto retry;
+                if (!less(e, elem))
+                        return !less(elem, e);
+                prev = &cur->next;
+                h.hand_over(1, cur);
+                cur = next;
+                h.set(0, cur);
+                if (prev->load() != cur)
+                        goto retry;
+        }
+}
+
+
+template <typename T, typename Compare>
+void lock_free_list<T, Compare>::dispose(void *p, void *ctx)
+{
+        static_cast<lock_free_list *>(ctx)->pool.destroy(
+                        static_cast<node *>(p));
+}
+
+
+template <typename T, typename Compare>
+bool lock_free_list<T, Compare>::is_marked(node *p)
+{
+        return reinterpret_cast<std::uintptr_t>(p) & 1;
+}
+
+
+template <typename T, typename Compare>
+typename lock_free_list<T, Compare>::node *lock_free_list<T, Compare>::marked(
+                node *p)
+{
+        return reinterpret_cast<node *>(reinterpret_cast<std::uintptr_t>(p) |
+                        1);
+}
+
+
+template <typename T, typename Compare>
+typename lock_free_list<T, Compare>::node *
+lock_free_list<T, Compare>::unmarked(node *p)
+{
+        return reinterpret_cast<node *>(reinterpret_cast<std::uintptr_t>(p) &
+                        ~std::uintptr_t(1));
+}
+
+
+#endif /* LOCK_FREE_LIST_HPP */
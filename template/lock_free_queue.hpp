@@ -0,0 +1,212 @@
+/*=======================================================
+ * lock_free_queue.hpp - a queue on a singly linked list
+ * that many threads push to and pop from at once without
+ * a lock
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:02:44
+ *=======================================================
+ */
+
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "hazard_pointer.hpp"
+#include "node_pool.hpp"
+
+/*
+ * The queue of Michael and Scott: a singly linked list from the head to
+ * the tail, whose first node is a dummy one. push() links a node after
+ * the last one and then swings the tail to it, which any thread finding
+ * the tail behind does as well; pop() swings the head to the node after
+ * the dummy one, takes the element out of it and leaves it as the new
+ * dummy. The nodes come from a node pool and go back through the hazard
+ * pointers, so a node is never freed or made again while another thread
+ * holds it, and no CAS is fooled by a node at an old address (ABA).
+ *
+ * push() and pop() are lock-free and may run in any number of threads at
+ * once; the elements come out in the order they went in.
+ */
+template <typename T>
+class lock_free_queue {
+        private:
+                struct node {
+                        std::atomic<node *> next{NULL};
+                        alignas(T) unsigned char data[sizeof(T)];
+
+                        T *elem() { return reinterpret_cast<T *>(data); }
+                };
+
+                typedef hazard_domain<2> domain;
+
+                node_pool<node> pool;
+                std::atomic<node *> head;
+                std::atomic<node *> tail;
+                domain dom;             /* freed before the pool */
+
+        public:
+                lock_free_queue(const lock_free_queue &) = delete;
+                lock_free_queue &operator=(const lock_free_queue &) = delete;
+                lock_free_queue();
+                ~lock_free_queue();
+                void push(const T &elem);
+                void push(T &&elem);
+                bool pop(T &elem);
+                bool empty() const;
+
+        private:
+                template <typename U>
+                void link(U &&elem);
+                static void dispose(void *p, void *ctx);
+};
+
+
+/*-------------------------------------------------------
+ * lock_free_queue - create an empty queue, throw
+ * std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+lock_free_queue<T>::lock_free_queue()
+{
+        node *dummy = pool.create();
+        if (!dummy)
+                throw std::bad_alloc();
+        head.store(dummy);
+        tail.store(dummy);
+}
+
+
+/*-------------------------------------------------------
+ * ~lock_free_queue - destroy all elements left, no
+ * thread may use the queue meanwhile
+ *-------------------------------------------------------
+ */
+template <typename T>
+lock_free_queue<T>::~lock_free_queue()
+{
+        node *p = head.load();
+        node *next = p->next.load();
+        pool.destroy(p);
+        for (p = next; p; p = next) {
+                next = p->next.load();
+                p->elem()->~T();
+                pool.destroy(p);
+        }
+}
+
+
+/*-------------------------------------------------------
+ * push - add the element @elem at the tail, throw
+ * std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+void lock_free_queue<T>::push(const T &elem)
+{
+        link(elem);
+}
+
+
+template <typename T>
+void lock_free_queue<T>::push(T &&elem)
+{
+        link(std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * pop - take the element at the head into @elem, return
+ * false if the queue is empty
+ *-------------------------------------------------------
+ */
+template <typename T>
+bool lock_free_queue<T>::pop(T &elem)
+{
+        typename domain::holder h(dom);
+        for (;;) {
+                node *first = h.protect(0, head);
+                node *last = tail.load();
+                node *next = h.protect(1, first->next);
+                if (head.load() != first)
+                        continue;
+                if (!next)
+                        return false;
+                if (first == last) {
+                        /* the tail is behind, help it on */
+                        tail.compare_exchange_strong(last, next);
+                        continue;
+                }
+                if (head.compare_exchange_strong(first, next)) {
+                        /* only the winner touches the element of @next,
+                           the new dummy node */
+                        elem = std::move(*next->elem());
+                        next->elem()->~T();
+                        h.retire(first, &dispose, this);
+                        return true;
+                }
+        }
+}
+
+
+/*-------------------------------------------------------
+ * empty - check whether the queue is empty, which may
+ * change right after
+ *-------------------------------------------------------
+ */
+template <typename T>
+bool lock_free_queue<T>::empty() const
+{
+        typename domain::holder h(const_cast<domain &>(dom));
+        node *first = h.protect(0, head);
+        return !first->next.load();
+}
+
+
+template <typename T>
+template <typename U>
+void lock_free_queue<T>::link(U &&elem)
+{
+        node *n = pool.create();
+        if (!n)
+                throw std::bad_alloc();
+        try {
+                new (n->data) T(std::forward<U>(elem));
+        } catch (...) {
+                pool.destroy(n);
+                throw;
+        }
+
+        typename domain::holder h(dom);
+        for (;;) {
+                node *last = h.protect(0, tail);
+                node *next = last->next.load();
+                if (tail.load() != last)
+                        continue;
+                if (next) {
+                        tail.compare_exchange_strong(last, next);
+                        continue;
+                }
+                if (last->next.compare_exchange_strong(next, n)) {
+                        tail.compare_exchange_strong(last, n);
+                        return;
+                }
+        }
+}
+
+
+/* free a dummy node, its element is gone already */
+template <typename T>
+void lock_free_queue<T>::dispose(void *p, void *ctx)
+{
+        static_cast<lock_free_queue *>(ctx)->pool.destroy(
+                        static_cast<node *>(p));
+}
+
+
+#endif /* LOCK_FREE_QUEUE_HPP */
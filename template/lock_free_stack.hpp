@@ -0,0 +1,165 @@
+/*=======================================================
+ * lock_free_stack.hpp - a stack on a singly linked list
+ * that many threads push to and pop from at once without
+ * a lock
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:02:44
+ *=======================================================
+ */
+
+#ifndef LOCK_FREE_STACK_HPP
+#define LOCK_FREE_STACK_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "hazard_pointer.hpp"
+#include "node_pool.hpp"
+
+/*
+ * The stack of Treiber: a singly linked list whose first node is the top,
+ * changed by one CAS on the top for each push() and pop(). The nodes come
+ * from a node pool and go back through the hazard pointers, so the node
+ * a pop() holds is never freed or made again meanwhile, and its CAS is
+ * not fooled by another node at the same address (ABA).
+ *
+ * push() and pop() are lock-free and may run in any number of threads at
+ * once.
+ */
+template <typename T>
+class lock_free_stack {
+        private:
+                struct node {
+                        T elem;
+                        node *next;
+
+                        template <typename U>
+                        node(U &&elem) : elem(std::forward<U>(elem)),
+                                next(NULL) {}
+                };
+
+                typedef hazard_domain<1> domain;
+
+                node_pool<node> pool;
+                std::atomic<node *> top{NULL};
+                domain dom;             /* freed before the pool */
+
+        public:
+                lock_free_stack(const lock_free_stack &) = delete;
+                lock_free_stack &operator=(const lock_free_stack &) = delete;
+                lock_free_stack();
+                ~lock_free_stack();
+                void push(const T &elem);
+                void push(T &&elem);
+                bool pop(T &elem);
+                bool empty() const;
+
+        private:
+                template <typename U>
+                void link(U &&elem);
+                static void dispose(void *p, void *ctx);
+};
+
+
+template <typename T>
+lock_free_stack<T>::lock_free_stack()
+{
+}
+
+
+/*-------------------------------------------------------
+ * ~lock_free_stack - destroy all elements left, no
+ * thread may use the stack meanwhile
+ *-------------------------------------------------------
+ */
+template <typename T>
+lock_free_stack<T>::~lock_free_stack()
+{
+        node *p = top.load();
+        while (p) {
+                node *next = p->next;
+                pool.destroy(p);
+                p = next;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * push - put the element @elem on the top, throw
+ * std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+void lock_free_stack<T>::push(const T &elem)
+{
+        link(elem);
+}
+
+
+template <typename T>
+void lock_free_stack<T>::push(T &&elem)
+{
+        link(std::move(elem));
+}
+
+
+/*-------------------------------------------------------
+ * pop - take the element on the top into @elem, return
+ * false if the stack is empty
+ *-------------------------------------------------------
+ */
+template <typename T>
+bool lock_free_stack<T>::pop(T &elem)
+{
+        typename domain::holder h(dom);
+        for (;;) {
+                node *p = h.protect(0, top);
+                if (!p)
+                        return false;
+                /* @p may be popped meanwhile, but not freed */
+                if (top.compare_exchange_strong(p, p->next)) {
+                        elem = std::move(p->elem);
+                        h.retire(p, &dispose, this);
+                        return true;
+                }
+        }
+}
+
+
+/*-------------------------------------------------------
+ * empty - check whether the stack is empty, which may
+ * change right after
+ *-------------------------------------------------------
+ */
+template <typename T>
+bool lock_free_stack<T>::empty() const
+{
+        return !top.load();
+}
+
+
+template <typename T>
+template <typename U>
+void lock_free_stack<T>::link(U &&elem)
+{
+        node *n = pool.create(std::forward<U>(elem));
+        if (!n)
+                throw std::bad_alloc();
+        n->next = top.load(std::memory_order_relaxed);
+        while (!top.compare_exchange_weak(n->next, n))
+                ;
+}
+
+
+template <typename T>
+void lock_free_stack<T>::dispose(void *p, void *ctx)
+{
+        static_cast<lock_free_stack *>(ctx)->pool.destroy(
+                        static_cast<node *>(p));
+}
+
+
+#endif /* LOCK_FREE_STACK_HPP */
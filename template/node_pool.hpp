@@ -0,0 +1,470 @@
+/*=======================================================
+ * node_pool.hpp - a slab allocator for the nodes of the
+ * linked lists
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 11:14:07
+ *=======================================================
+ */
+
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+ * The nodes are carved out of slabs holding many of them, and a freed node
+ * goes to a free list instead of back to malloc. Every thread keeps a
+ * small cache of free nodes, so most allocations and frees touch no lock;
+ * the cache is refilled from, and spilled to, the shared free list a batch
+ * at a time. The pool knows the caches of all threads: a thread gives its
+ * nodes back when it exits, and drops the caches of the destroyed pools
+ * the next time it looks for one it does not hold.
+ *
+ * reset() gives every slab back at once, which is how a whole list is
+ * dropped in O(slabs): the destructors of the nodes are not run, so it
+ * suits the nodes whose elements own nothing, and the lists built on the
+ * pool must be forgotten, not cleared, afterwards.
+ */
+template <typename T>
+class node_pool {
+        private:
+                union slot {
+                        slot *next;
+                        alignas(T) unsigned char data[sizeof(T)];
+                };
+
+                /* the free nodes a thread holds for one pool, @pool is
+                   NULL once the pool is destroyed */
+                struct cache {
+                        std::atomic<node_pool *> pool{NULL};
+                        slot *head = NULL;
+                        std::size_t count = 0;
+                };
+
+                /* the caches of a thread, given back when it exits */
+                struct thread_caches {
+                        std::vector<cache *> list;
+                        std::size_t last = 0;   /* the one used last */
+
+                        ~thread_caches();
+                };
+
+                static constexpr std::size_t batch = 64;
+
+                /* guards which caches belong to which pools */
+                inline static std::mutex registry_mtx;
+                inline static thread_local bool exited = false;
+
+                std::vector<cache *> caches;    /* of all threads */
+                const std::size_t slab_nodes;
+                std::mutex mtx;                 /* guards all below */
+                std::vector<slot *> slabs;
+                slot *free_head = NULL;
+                slot *bump = NULL;              /* the unused part of */
+                slot *bump_end = NULL;          /* the last slab */
+
+        public:
+                node_pool(const node_pool &) = delete;
+                node_pool &operator=(const node_pool &) = delete;
+                explicit node_pool(std::size_t n = 4096);
+                ~node_pool();
+                void *allocate();
+                void deallocate(void *p);
+                template <typename... Args>
+                T *create(Args &&...args);
+                void destroy(T *p);
+                void reset();
+                std::size_t slab_count();
+                static std::size_t thread_cache_count();
+
+        private:
+                static thread_caches &mine();
+                cache *local();
+                bool refill(cache &c);
+                void spill(cache &c);
+                void give_back(cache &c);
+                static slot *new_slab(std::size_t n);
+                static void delete_slab(slot *s);
+};
+
+
+/*-------------------------------------------------------
+ * node_pool - create a pool whose slabs hold @n nodes
+ * each
+ *-------------------------------------------------------
+ */
+template <typename T>
+node_pool<T>::node_pool(std::size_t n):
+        slab_nodes(n < batch ? batch : n)
+{
+}
+
+
+/*-------------------------------------------------------
+ * ~node_pool - free all slabs, the nodes still in use
+ * included, without running their destructors
+ *-------------------------------------------------------
+ */
+template <typename T>
+node_pool<T>::~node_pool()
+{
+        {
+                /* the threads drop the caches later */
+                std::lock_guard<std::mutex> lk(registry_mtx);
+                for (cache *c : caches)
+                        c->pool.store(NULL, std::memory_order_release);
+        }
+        for (slot *s : slabs)
+                delete_slab(s);
+}
+
+
+/*-------------------------------------------------------
+ * allocate - get the storage of one node, return NULL
+ * if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+void *node_pool<T>::allocate()
+{
+        cache *c = local();
+        if (!c) {
+                /* no cache of its own, so straight from the free list */
+                cache tmp;
+                if (!refill(tmp))
+                        return NULL;
+                slot *s = tmp.head;
+                tmp.head = s->next;
+                --tmp.count;
+                give_back(tmp);
+                return s;
+        }
+        if (!c->head && !refill(*c))
+                return NULL;
+        slot *s = c->head;
+        c->head = s->next;
+        --c->count;
+        return s;
+}
+
+
+/*-------------------------------------------------------
+ * deallocate - give back the storage of a node got from
+ * allocate() of this pool, by any thread
+ *-------------------------------------------------------
+ */
+template <typename T>
+void node_pool<T>::deallocate(void *p)
+{
+        if (!p)
+                return;
+        slot *s = static_cast<slot *>(p);
+        cache *c = local();
+        if (!c) {
+                cache tmp;
+                s->next = NULL;
+                tmp.head = s;
+                tmp.count = 1;
+                give_back(tmp);
+                return;
+        }
+        s->next = c->head;
+        c->head = s;
+        if (++c->count >= 2 * batch)
+                spill(*c);
+}
+
+
+/*-------------------------------------------------------
+ * create - allocate and construct a node from @args,
+ * return NULL if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+template <typename... Args>
+T *node_pool<T>::create(Args &&...args)
+{
+        void *p = this->allocate();
+        if (!p)
+                return NULL;
+        try {
+                return new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+                this->deallocate(p);
+                throw;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * destroy - destruct a node made by create() and give
+ * back its storage
+ *-------------------------------------------------------
+ */
+template <typename T>
+void node_pool<T>::destroy(T *p)
+{
+        if (!p)
+                return;
+        p->~T();
+        this->deallocate(p);
+}
+
+
+/*-------------------------------------------------------
+ * reset - free all slabs at once, the nodes in use
+ * included, without running their destructors, no
+ * thread may use the pool meanwhile
+ *-------------------------------------------------------
+ */
+template <typename T>
+void node_pool<T>::reset()
+{
+        std::lock_guard<std::mutex> rlk(registry_mtx);
+        std::lock_guard<std::mutex> lk(mtx);
+        for (slot *s : slabs)
+                delete_slab(s);
+        slabs.clear();
+        free_head = bump = bump_end = NULL;
+        /* the caches of all threads pointed into the freed slabs */
+        for (cache *c : caches) {
+                c->head = NULL;
+                c->count = 0;
+        }
+}
+
+
+/*-------------------------------------------------------
+ * slab_count - get the number of slabs allocated
+ *-------------------------------------------------------
+ */
+template <typename T>
+std::size_t node_pool<T>::slab_count()
+{
+        std::lock_guard<std::mutex> lk(mtx);
+        return slabs.size();
+}
+
+
+/*-------------------------------------------------------
+ * thread_cache_count - get the number of caches the
+ * calling thread holds, for the live pools and for the
+ * ones destroyed since it last looked for a new one
+ *-------------------------------------------------------
+ */
+template <typename T>
+std::size_t node_pool<T>::thread_cache_count()
+{
+        return exited ? 0 : mine().list.size();
+}
+
+
+/*-------------------------------------------------------
+ * ~thread_caches - give the nodes of an exiting thread
+ * back to the pools alive
+ *-------------------------------------------------------
+ */
+template <typename T>
+node_pool<T>::thread_caches::~thread_caches()
+{
+        exited = true;
+        std::lock_guard<std::mutex> lk(registry_mtx);
+        for (cache *c : list) {
+                node_pool *p = c->pool.load(std::memory_order_relaxed);
+                if (p) {
+                        p->give_back(*c);
+                        for (cache *&x : p->caches) {
+                                if (x == c) {
+                                        x = p->caches.back();
+                                        p->caches.pop_back();
+                                        break;
+                                }
+                        }
+                }
+                delete c;
+        }
+}
+
+
+template <typename T>
+typename node_pool<T>::thread_caches &node_pool<T>::mine()
+{
+        thread_local thread_caches caches;
+        return caches;
+}
+
+
+/*-------------------------------------------------------
+ * local - get the cache of the calling thread, made on
+ * its first use, return NULL if it cannot be made or the
+ * thread is exiting
+ *-------------------------------------------------------
+ */
+template <typename T>
+typename node_pool<T>::cache *node_pool<T>::local()
+{
+        if (exited)
+                return NULL;
+        thread_caches &tc = mine();
+        std::vector<cache *> &v = tc.list;
+        if (tc.last < v.size() &&
+                        v[tc.last]->pool.load(std::memory_order_relaxed) ==
+                        this)
+                return v[tc.last];
+
+        /* look through all, dropping the caches of the dead pools */
+        cache *c = NULL;
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+                node_pool *p = v[i]->pool.load(std::memory_order_acquire);
+                if (!p) {
+                        delete v[i];
+                        continue;
+                }
+                if (p == this) {
+                        c = v[i];
+                        tc.last = n;
+                }
+                v[n++] = v[i];
+        }
+        v.resize(n);
+        if (c)
+                return c;
+
+        c = new (std::nothrow) cache;
+        if (!c)
+                return NULL;
+        try {
+                v.reserve(n + 1);
+                std::lock_guard<std::mutex> lk(registry_mtx);
+                caches.push_back(c);
+        } catch (...) {
+                delete c;
+                return NULL;
+        }
+        c->pool.store(this, std::memory_order_relaxed);
+        v.push_back(c);
+        tc.last = n;
+        return c;
+}
+
+
+/*-------------------------------------------------------
+ * refill - move a batch of free nodes into the cache @c,
+ * return false if out of memory
+ *-------------------------------------------------------
+ */
+template <typename T>
+bool node_pool<T>::refill(cache &c)
+{
+        std::lock_guard<std::mutex> lk(mtx);
+        if (free_head) {
+                slot *last = free_head;
+                std::size_t n = 1;
+                while (n < batch && last->next) {
+                        last = last->next;
+                        ++n;
+                }
+                c.head = free_head;
+                free_head = last->next;
+                last->next = NULL;
+                c.count = n;
+                return true;
+        }
+        if (bump == bump_end) {
+                slot *s = new_slab(slab_nodes);
+                if (!s)
+                        return false;
+                try {
+                        slabs.push_back(s);
+                } catch (...) {
+                        delete_slab(s);
+                        return false;
+                }
+                bump = s;
+                bump_end = s + slab_nodes;
+        }
+        std::size_t n = bump_end - bump;
+        if (n > batch)
+                n = batch;
+        for (std::size_t i = 0; i + 1 < n; ++i)
+                bump[i].next = &bump[i + 1];
+        bump[n - 1].next = NULL;
+        c.head = bump;
+        c.count = n;
+        bump += n;
+        return true;
+}
+
+
+/*-------------------------------------------------------
+ * spill - move a batch of free nodes from the cache @c
+ * to the shared free list
+ *-------------------------------------------------------
+ */
+template <typename T>
+void node_pool<T>::spill(cache &c)
+{
+        slot *first = c.head, *last = c.head;
+        for (std::size_t i = 1; i < batch; ++i)
+                last = last->next;
+        c.head = last->next;
+        c.count -= batch;
+        std::lock_guard<std::mutex> lk(mtx);
+        last->next = free_head;
+        free_head = first;
+}
+
+
+/*-------------------------------------------------------
+ * give_back - move all free nodes from the cache @c to
+ * the shared free list
+ *-------------------------------------------------------
+ */
+template <typename T>
+void node_pool<T>::give_back(cache &c)
+{
+        if (!c.head)
+                return;
+        slot *last = c.head;
+        while (last->next)
+                last = last->next;
+        std::lock_guard<std::mutex> lk(mtx);
+        last->next = free_head;
+        free_head = c.head;
+        c.head = NULL;
+        c.count = 0;
+}
+
+
+template <typename T>
+typename node_pool<T>::slot *node_pool<T>::new_slab(std::size_t n)
+{
+        if constexpr (alignof(slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return static_cast<slot *>(::operator new(n * sizeof(slot),
+                                        std::align_val_t(alignof(slot)),
+                                        std::nothrow));
+        else
+                return static_cast<slot *>(::operator new(n * sizeof(slot),
+                                        std::nothrow));
+}
+
+
+template <typename T>
+void node_pool<T>::delete_slab(slot *s)
+{
+        if constexpr (alignof(slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(s, std::align_val_t(alignof(slot)));
+        else
+                ::operator delete(s);
+}
+
+
+#endif /* NODE_POOL_HPP */
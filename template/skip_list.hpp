@@ -0,0 +1,594 @@
+/*=======================================================
+ * skip_list.hpp - an ordered map on a doubly linked list
+ * with express lanes
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:35:17
+ *=======================================================
+ */
+
+#ifndef SKIP_LIST_HPP
+#define SKIP_LIST_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <utility>
+
+/*
+ * The bottom level is a doubly linked list of the pairs in the order of
+ * the keys, like the doubly_linked_list, and every node is linked on as
+ * many levels above it as its height. A new node grows one level higher
+ * with probability @p each time, so level i holds about n * p^i nodes and
+ * find(), insert() and erase() look at O(log n) nodes in expectation,
+ * from the top level down. The smaller @p, the less memory the links take
+ * and the more nodes a lookup compares on every level: 1/2 and 1/4 are the
+ * usual choices.
+ *
+ * Inserting or erasing invalidates the iterators to the erased pair only.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+class skip_list {
+        public:
+                typedef std::pair<const K, V> value_type;
+
+                static constexpr int max_level = 32;
+
+        private:
+                struct node {
+                        value_type kv;
+                        node *prev;             /* on the bottom level */
+                        int level;
+                        node **next;            /* follow the node */
+
+                        template <typename... Args>
+                        node(int level, Args &&...args) :
+                                kv(std::forward<Args>(args)...), prev(NULL),
+                                level(level),
+                                next(reinterpret_cast<node **>(this + 1)) {}
+                };
+
+                node *head[max_level];
+                node *tail;
+                int level;              /* the levels in use */
+                std::size_t len;
+                std::uint32_t threshold;        /* p * 2^32 */
+                std::mt19937 rng;
+                Compare less;
+
+        public:
+                class iterator;
+                typedef std::reverse_iterator<iterator> reverse_iterator;
+
+                explicit skip_list(double p = 0.25,
+                                std::uint32_t seed = 5489u,
+                                const Compare &less = Compare());
+                skip_list(const skip_list &other);
+                skip_list(skip_list &&other) noexcept;
+                skip_list &operator=(skip_list other) noexcept;
+                ~skip_list();
+                std::size_t size() const;
+                bool empty() const;
+                iterator begin();
+                iterator end();
+                reverse_iterator rbegin();
+                reverse_iterator rend();
+                iterator find(const K &key);
+                bool contains(const K &key);
+                iterator lower_bound(const K &key);
+                iterator upper_bound(const K &key);
+                std::pair<iterator, bool> insert(const K &key, const V &value);
+                V &operator[](const K &key);
+                iterator erase(iterator pos);
+                std::size_t erase(const K &key);
+                void clear();
+                void swap(skip_list &other) noexcept;
+                void print();
+
+        private:
+                node *search(const K &key, node ***update);
+                node *first_not_less(const K &key);
+                node *first_greater(const K &key);
+                node *link(node ***update, const K &key, const V &value);
+                void unlink(node *n, node ***update);
+                int random_level();
+                static node *new_node(int level, const K &key, const V &value);
+                static void free_node(node *n);
+};
+
+
+/*-------------------------------------------------------
+ * iterator - a position in the list, end() is NULL and
+ * steps back to the last node
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+class skip_list<K, V, Compare>::iterator {
+        private:
+                friend class skip_list<K, V, Compare>;
+                node *n;
+                skip_list *list;
+
+                iterator(node *n, skip_list *list) : n(n), list(list) {}
+
+        public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef skip_list::value_type value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef value_type *pointer;
+                typedef value_type &reference;
+
+                iterator() : n(NULL), list(NULL) {}
+                value_type &operator*() const { return n->kv; }
+                value_type *operator->() const { return &n->kv; }
+                iterator &operator++()
+                {
+                        n = n->next[0];
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        n = n->next[0];
+                        return it;
+                }
+                iterator &operator--()
+                {
+                        n = n ? n->prev : list->tail;
+                        return *this;
+                }
+                iterator operator--(int)
+                {
+                        iterator it = *this;
+                        --*this;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return n == it.n;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return n != it.n;
+                }
+};
+
+
+/*-------------------------------------------------------
+ * skip_list - create an empty list whose nodes grow a
+ * level higher with probability @p, from 1/2^32 to 1/2,
+ * and whose levels are drawn from @seed
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+skip_list<K, V, Compare>::skip_list(double p, std::uint32_t seed,
+                const Compare &less)
+        : tail(NULL), level(1), len(0), rng(seed), less(less)
+{
+        if (p > 0.5)
+                p = 0.5;
+        this->threshold = p > 0 ? static_cast<std::uint32_t>(p * 4294967296.0)
+                : 1;
+        for (node *&h : head)
+                h = NULL;
+}
+
+
+/*-------------------------------------------------------
+ * skip_list - copy @other, linking every level in one
+ * pass as the keys come in order already
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+skip_list<K, V, Compare>::skip_list(const skip_list &other)
+        : tail(NULL), level(1), len(0), threshold(other.threshold),
+        rng(other.rng), less(other.less)
+{
+        node **last[max_level];
+        for (int i = 0; i < max_level; ++i) {
+                head[i] = NULL;
+                last[i] = &head[i];
+        }
+        try {
+                for (node *p = other.head[0]; p; p = p->next[0]) {
+                        node *n = new_node(p->level, p->kv.first,
+                                        p->kv.second);
+                        for (int i = 0; i < n->level; ++i) {
+                                n->next[i] = NULL;
+                                *last[i] = n;
+                                last[i] = &n->next[i];
+                        }
+                        n->prev = tail;
+                        tail = n;
+                        ++len;
+                }
+        } catch (...) {
+                this->clear();
+                throw;
+        }
+        this->level = other.level;
+}
+
+
+template <typename K, typename V, typename Compare>
+skip_list<K, V, Compare>::skip_list(skip_list &&other) noexcept
+        : skip_list(0.25, 5489u, other.less)
+{
+        this->swap(other);
+}
+
+
+template <typename K, typename V, typename Compare>
+skip_list<K, V, Compare> &skip_list<K, V, Compare>::operator=(
+                skip_list other) noexcept
+{
+        this->swap(other);
+        return *this;
+}
+
+
+template <typename K, typename V, typename Compare>
+skip_list<K, V, Compare>::~skip_list()
+{
+        this->clear();
+}
+
+
+template <typename K, typename V, typename Compare>
+std::size_t skip_list<K, V, Compare>::size() const
+{
+        return len;
+}
+
+
+template <typename K, typename V, typename Compare>
+bool skip_list<K, V, Compare>::empty() const
+{
+        return len == 0;
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator skip_list<K, V, Compare>::begin()
+{
+        return iterator(head[0], this);
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator skip_list<K, V, Compare>::end()
+{
+        return iterator(NULL, this);
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::reverse_iterator
+skip_list<K, V, Compare>::rbegin()
+{
+        return reverse_iterator(this->end());
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::reverse_iterator
+skip_list<K, V, Compare>::rend()
+{
+        return reverse_iterator(this->begin());
+}
+
+
+/*-------------------------------------------------------
+ * find - find the pair with the key @key, return end()
+ * if not found
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator skip_list<K, V, Compare>::find(
+                const K &key)
+{
+        node *n = first_not_less(key);
+        if (n && !less(key, n->kv.first))
+                return iterator(n, this);
+        return this->end();
+}
+
+
+template <typename K, typename V, typename Compare>
+bool skip_list<K, V, Compare>::contains(const K &key)
+{
+        return this->find(key) != this->end();
+}
+
+
+/*-------------------------------------------------------
+ * lower_bound - find the first pair whose key is not
+ * less than @key, where a range scan starts
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator
+skip_list<K, V, Compare>::lower_bound(const K &key)
+{
+        return iterator(first_not_less(key), this);
+}
+
+
+/*-------------------------------------------------------
+ * upper_bound - find the first pair whose key is greater
+ * than @key, where a range scan up to @key ends
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator
+skip_list<K, V, Compare>::upper_bound(const K &key)
+{
+        return iterator(first_greater(key), this);
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert the pair of @key and @value unless the
+ * key is in the list, return its position and whether
+ * it's new, throw std::bad_alloc if out of memory
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+std::pair<typename skip_list<K, V, Compare>::iterator, bool>
+skip_list<K, V, Compare>::insert(const K &key, const V &value)
+{
+        node **update[max_level];
+        node *n = search(key, update);
+        if (n && !less(key, n->kv.first))
+                return std::make_pair(iterator(n, this), false);
+        return std::make_pair(iterator(link(update, key, value), this), true);
+}
+
+
+/*-------------------------------------------------------
+ * operator[] - get the value of the key @key, inserting
+ * a default one if it's not in the list
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+V &skip_list<K, V, Compare>::operator[](const K &key)
+{
+        node **update[max_level];
+        node *n = search(key, update);
+        if (n && !less(key, n->kv.first))
+                return n->kv.second;
+        return link(update, key, V())->kv.second;
+}
+
+
+/*-------------------------------------------------------
+ * erase - erase the pair at @pos, return the position
+ * after it
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::iterator skip_list<K, V, Compare>::erase(
+                iterator pos)
+{
+        node *n = pos.n;
+        node *next = n->next[0];
+        node **update[max_level];
+        search(n->kv.first, update);
+        unlink(n, update);
+        return iterator(next, this);
+}
+
+
+/*-------------------------------------------------------
+ * erase - erase the pair with the key @key, return the
+ * number of pairs erased
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+std::size_t skip_list<K, V, Compare>::erase(const K &key)
+{
+        node **update[max_level];
+        node *n = search(key, update);
+        if (!n || less(key, n->kv.first))
+                return 0;
+        unlink(n, update);
+        return 1;
+}
+
+
+template <typename K, typename V, typename Compare>
+void skip_list<K, V, Compare>::clear()
+{
+        node *p = head[0];
+        while (p) {
+                node *next = p->next[0];
+                free_node(p);
+                p = next;
+        }
+        for (node *&h : head)
+                h = NULL;
+        tail = NULL;
+        level = 1;
+        len = 0;
+}
+
+
+template <typename K, typename V, typename Compare>
+void skip_list<K, V, Compare>::swap(skip_list &other) noexcept
+{
+        using std::swap;
+        for (int i = 0; i < max_level; ++i)
+                swap(head[i], other.head[i]);
+        swap(tail, other.tail);
+        swap(level, other.level);
+        swap(len, other.len);
+        swap(threshold, other.threshold);
+        swap(rng, other.rng);
+        swap(less, other.less);
+}
+
+
+/*-------------------------------------------------------
+ * print - print all pairs
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+void skip_list<K, V, Compare>::print()
+{
+        for (node *p = head[0]; p; p = p->next[0])
+                std::cout << p->kv.first << ":" << p->kv.second << " ";
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * search - find the first node whose key is not less
+ * than @key, NULL if none, and keep in @update the link
+ * to it on every level in use
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::node *skip_list<K, V, Compare>::search(
+                const K &key, node ***update)
+{
+        node **links = head;
+        node *bound = NULL;     /* known not less than @key */
+        for (int i = level - 1; i >= 0; --i) {
+                while (links[i] != bound && less(links[i]->kv.first, key))
+                        links = links[i]->next;
+                bound = links[i];
+                update[i] = links;
+        }
+        return links[0];
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::node *
+skip_list<K, V, Compare>::first_not_less(const K &key)
+{
+        node **links = head;
+        node *bound = NULL;
+        for (int i = level - 1; i >= 0; --i) {
+                while (links[i] != bound && less(links[i]->kv.first, key))
+                        links = links[i]->next;
+                bound = links[i];
+        }
+        return links[0];
+}
+
+
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::node *
+skip_list<K, V, Compare>::first_greater(const K &key)
+{
+        node **links = head;
+        node *bound = NULL;
+        for (int i = level - 1; i >= 0; --i) {
+                while (links[i] != bound && !less(key, links[i]->kv.first))
+                        links = links[i]->next;
+                bound = links[i];
+        }
+        return links[0];
+}
+
+
+/*-------------------------------------------------------
+ * link - make a node of @key and @value and link it
+ * where search() left @update, return the node
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::node *skip_list<K, V, Compare>::link(
+                node ***update, const K &key, const V &value)
+{
+        int lv = random_level();
+        node *n = new_node(lv, key, value);
+        for (; level < lv; ++level)
+                update[level] = head;
+        for (int i = 0; i < lv; ++i) {
+                n->next[i] = update[i][i];
+                update[i][i] = n;
+        }
+        /* the links of a node come right after it */
+        n->prev = update[0] == head ? NULL :
+                reinterpret_cast<node *>(update[0]) - 1;
+        if (n->next[0])
+                n->next[0]->prev = n;
+        else
+                tail = n;
+        ++len;
+        return n;
+}
+
+
+/*-------------------------------------------------------
+ * unlink - unlink and free the node @n, whose links
+ * search() left in @update
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+void skip_list<K, V, Compare>::unlink(node *n, node ***update)
+{
+        for (int i = 0; i < n->level; ++i)
+                update[i][i] = n->next[i];
+        if (n->next[0])
+                n->next[0]->prev = n->prev;
+        else
+                tail = n->prev;
+        while (level > 1 && !head[level - 1])
+                --level;
+        free_node(n);
+        --len;
+}
+
+
+/*-------------------------------------------------------
+ * random_level - draw the height of a new node, one
+ * more level with probability p each time
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+int skip_list<K, V, Compare>::random_level()
+{
+        int lv = 1;
+        while (lv < max_level && rng() < threshold)
+                ++lv;
+        return lv;
+}
+
+
+/*-------------------------------------------------------
+ * new_node - allocate a node of @level levels with its
+ * links right after it, throw std::bad_alloc if out of
+ * memory
+ *-------------------------------------------------------
+ */
+template <typename K, typename V, typename Compare>
+typename skip_list<K, V, Compare>::node *skip_list<K, V, Compare>::new_node(
+                int level, const K &key, const V &value)
+{
+        void *p = ::operator new(sizeof(node) + level * sizeof(node *));
+        try {
+                return new (p) node(level, key, value);
+        } catch (...) {
+                ::operator delete(p);
+                throw;
+        }
+}
+
+
+template <typename K, typename V, typename Compare>
+void skip_list<K, V, Compare>::free_node(node *n)
+{
+        n->~node();
+        ::operator delete(n);
+}
+
+
+#endif /* SKIP_LIST_HPP */
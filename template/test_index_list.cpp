@@ -0,0 +1,121 @@
+/*=======================================================
+ * test_index_list.cpp - test the class index_list
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 07:04:26
+ *=======================================================
+ */
+
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include "index_list.hpp"
+
+
+/*-------------------------------------------------------
+ * same - check a list against the model @ref, both ways
+ *-------------------------------------------------------
+ */
+template <typename L, typename R>
+static bool same(L &list, R &ref)
+{
+        if (list.size() != ref.size())
+                return false;
+        auto it = list.begin();
+        for (const auto &x : ref)
+                if (!(*it++ == x))
+                        return false;
+        if (it != list.end())
+                return false;
+        for (auto r = ref.rbegin(); r != ref.rend(); ++r)
+                if (!(*--it == *r))
+                        return false;
+        return it == list.begin();
+}
+
+
+void test_basic()
+{
+        std::cout << "Start testing class index_list<int>:" << std::endl;
+        index_list<int> l;
+        assert(l.empty() && l.begin() == l.end());
+        for (int i = 1; i <= 5; ++i)
+                l.push_back(i);
+        l.push_front(0);
+        auto it = l.insert(l.find(4), 9);
+        assert(9 == *it && 4 == *++it);
+        std::cout << "Execpted output: 0 1 2 3 9 4 5\nActual output:   ";
+        l.print();
+        assert(0 == l.front() && 5 == l.back());
+
+        /* the iterators stay valid while the vector grows */
+        it = l.find(9);
+        for (int i = 6; i < 100; ++i)
+                l.push_back(i);
+        it = l.erase(it);
+        assert(4 == *it && 99 == *--l.end());
+        assert(l.end() == l.erase(l.find(99)));
+
+        /* a freed slot is taken again before the vector grows */
+        std::size_t cap = l.capacity();
+        l.erase(l.find(0));
+        l.push_back(l.front());
+        assert(cap == l.capacity() && 1 == l.back());
+
+        index_list<int> c(l);
+        l.clear();
+        assert(l.empty() && l.begin() == l.end());
+        assert(99 == c.size() && 5 == *c.find(5));
+        l = std::move(c);
+        assert(99 == l.size() && c.empty());
+        std::cout << "End testing." << std::endl;
+}
+
+
+void test_random()
+{
+        std::cout << "Start testing class index_list<std::string>:"
+                << std::endl;
+        std::mt19937 rng(42);
+        index_list<std::string> l;
+        std::list<std::string> ref;
+        for (int round = 0; round < 20000; ++round) {
+                std::size_t pos = ref.empty() ? 0 : rng() % (ref.size() + 1);
+                auto it = l.begin();
+                auto rit = ref.begin();
+                for (std::size_t k = 0; k < pos; ++k, ++it, ++rit)
+                        ;
+                bool grow = round < 12000 ? rng() % 3 != 0 : rng() % 4 == 0;
+                if (grow || rit == ref.end()) {
+                        std::string s = std::to_string(round) +
+                                std::string(20, 'x');
+                        it = l.insert(it, s);
+                        rit = ref.insert(rit, s);
+                } else {
+                        it = l.erase(it);
+                        rit = ref.erase(rit);
+                }
+                assert((it == l.end()) == (rit == ref.end()));
+                assert(it == l.end() || *it == *rit);
+                if (round % 2000 == 0) {
+                        assert(same(l, ref));
+                        l.compact();
+                        assert(l.capacity() == l.size() && same(l, ref));
+                }
+        }
+        assert(same(l, ref));
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_basic();
+        std::cout << std::endl;
+        test_random();
+
+        return 0;
+}
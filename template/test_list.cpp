@@ -2,11 +2,16 @@
  * test_list.cpp - test the class list
  *
  * Created by Haoyuan Li on 2021/06/30
- * Last Modified: 2021/07/01 15:42:27
+ * Last Modified: 2026/10/20 10:38:52
  *=======================================================
  */
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 #include <assert.h>
 #include "list.hpp"
 
@@ -75,11 +80,423 @@ void test_dll()
 }
 
 
+/*-------------------------------------------------------
+ * counting_allocator - an allocator with state, counting
+ * the nodes it holds out
+ *-------------------------------------------------------
+ */
+template <typename T>
+struct counting_allocator {
+        typedef T value_type;
+        long *live;
+
+        counting_allocator(long *live) : live(live) {}
+        template <typename U>
+        counting_allocator(const counting_allocator<U> &a) : live(a.live) {}
+        T *allocate(std::size_t n)
+        {
+                *live += n;
+                return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T *p, std::size_t n)
+        {
+                *live -= n;
+                std::allocator<T>().deallocate(p, n);
+        }
+        template <typename U>
+        bool operator==(const counting_allocator<U> &a) const
+        {
+                return live == a.live;
+        }
+        template <typename U>
+        bool operator!=(const counting_allocator<U> &a) const
+        {
+                return live != a.live;
+        }
+};
+
+
+void test_alloc()
+{
+        std::cout << "Start testing the lists with allocators:"
+                << std::endl;
+        static_assert(sizeof(sll) == sizeof(singly_linked_list<int,
+                                counting_allocator<int>>) - sizeof(long *),
+                        "the default allocator should take no room");
+        long live = 0;
+        typedef singly_linked_list<int, counting_allocator<int>> csll;
+        csll *head = new csll(counting_allocator<int>(&live));
+        csll *p = head;
+        for (int i = 0; i < 10; ++i)
+                p = p->append(i);
+        assert(10 == live && &live == p->get_allocator().live);
+        head->remove(head, 4);
+        assert(9 == live);
+        head->clear();
+        assert(0 == live);
+        delete head;
+
+        /* all nodes in one buffer, given back at once */
+        char buf[4096];
+        std::pmr::monotonic_buffer_resource res(buf, sizeof(buf),
+                        std::pmr::null_memory_resource());
+        typedef doubly_linked_list<int, std::pmr::polymorphic_allocator<int>>
+                pdll;
+        pdll dhead{std::pmr::polymorphic_allocator<int>(&res)};
+        pdll *q = &dhead;
+        int n = 0;
+        while ((q = q->append(n)))
+                ++n;
+        assert(n > 50 && n <= 4096 / 32);
+        assert(&res == dhead.next->get_allocator().resource());
+        for (q = dhead.next; q; q = q->next)
+                assert(q >= reinterpret_cast<pdll *>(buf) &&
+                                q < reinterpret_cast<pdll *>(buf +
+                                        sizeof(buf)));
+        std::cout << "Execpted output: 0 1 2\nActual output:   ";
+        dhead.find(2)->clear();
+        dhead.print();
+        dhead.clear();
+        std::cout << "End testing." << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * task - an object on two intrusive lists at once
+ *-------------------------------------------------------
+ */
+struct task {
+        int id;
+        intrusive_list_hook all;
+        intrusive_slist_hook ready;
+
+        explicit task(int id) : id(id) {}
+};
+
+std::ostream &operator<<(std::ostream &os, const task &t)
+{
+        return os << t.id;
+}
+
+typedef intrusive_doubly_linked_list<task, &task::all> all_list;
+typedef intrusive_singly_linked_list<task, &task::ready> ready_list;
+
+
+void test_intrusive()
+{
+        std::cout << "Start testing the intrusive lists:" << std::endl;
+        task t[5] = { task(0), task(1), task(2), task(3), task(4) };
+        all_list all;
+        ready_list ready;
+        assert(all.empty() && ready.empty() && NULL == all.front());
+        for (task &x : t)
+                all.push_back(x);
+        for (int i = 0; i < 5; i += 2)
+                ready.push_front(t[i]);
+        assert(5 == all.size() && 3 == ready.size());
+        std::cout << "Execpted output: 0 1 2 3 4\nActual output:   ";
+        all.print();
+        std::cout << "Execpted output: 4 2 0\nActual output:   ";
+        ready.print();
+
+        /* unlinking from one list leaves the other alone */
+        all_list::remove(t[2]);
+        ready_list::remove(t[2]);
+        ready_list::remove(t[2]);
+        assert(!all_list::is_linked(t[2]) && !ready_list::is_linked(t[2]));
+        assert(&t[3] == all.next(t[1]) && &t[1] == all.prev(t[3]));
+        assert(&t[0] == ready.next(t[4]) && NULL == ready.next(t[0]));
+        all.insert(t[0], t[2]);
+        ready.insert_after(t[0], t[2]);
+        std::cout << "Execpted output: 2 0 1 3 4\nActual output:   ";
+        all.print();
+        std::cout << "Execpted output: 4 0 2\nActual output:   ";
+        ready.print();
+
+        int sum = 0;
+        for (task &x : all)
+                sum += x.id;
+        assert(10 == sum);
+        all_list::iterator it = all.end();
+        assert(4 == (--it)->id && 3 == (--it)->id);
+        assert(&t[4] == all.pop_back() && &t[2] == all.pop_front());
+        assert(&t[4] == ready.pop_front() && &t[0] == ready.front());
+
+        /* a copy starts unlinked */
+        task c(t[1]);
+        assert(all_list::is_linked(t[1]) && !all_list::is_linked(c));
+        all.clear();
+        assert(all.empty() && !all_list::is_linked(t[0]));
+        assert(2 == ready.size());
+        std::cout << "End testing." << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * keyed - an element sorted by @key only, @seq tells the
+ * equal ones apart
+ *-------------------------------------------------------
+ */
+struct keyed {
+        int key;
+        int seq;
+};
+
+static bool key_less(const keyed &a, const keyed &b)
+{
+        return a.key < b.key;
+}
+
+
+/* an element without a default constructor, counting how many are made */
+struct counted {
+        static int made;
+        int v;
+
+        explicit counted(int v) : v(v) { ++made; }
+        counted(const counted &c) : v(c.v) { ++made; }
+        bool operator<(const counted &c) const { return v < c.v; }
+};
+
+int counted::made = 0;
+
+
+void test_containers()
+{
+        std::cout << "Start testing class singly_linked_container<int> and "
+                "doubly_linked_container<int>:" << std::endl;
+        typedef singly_linked_container<int> scon;
+        typedef doubly_linked_container<int> dcon;
+
+        scon s;
+        assert(s.empty() && s.begin() == s.end());
+        for (int i = 3; i < 6; ++i)
+                s.push_back(i);
+        s.push_front(2);
+        s.insert_after(s.find(5), 7);
+        assert(5 == s.size() && 2 == s.front() && 7 == s.back());
+        s.erase_after(s.find(5));
+        s.pop_front();
+        scon t;
+        t.push_back(1);
+        t.push_back(9);
+        s.splice_after(s.before_begin(), t);
+        assert(t.empty() && 5 == s.size() && 5 == s.back());
+        std::cout << "Execpted output: 1 9 3 4 5\nActual output:   ";
+        s.print();
+        s.sort();
+        t.push_back(0);
+        t.push_back(6);
+        s.merge(t);
+        s.push_back(10);
+        std::cout << "Execpted output: 0 1 3 4 5 6 9 10\nActual output:   ";
+        s.print();
+        scon sc(s);
+        s.clear();
+        assert(s.empty() && 8 == sc.size() && 10 == sc.back());
+        s = std::move(sc);
+        assert(8 == s.size() && sc.empty());
+
+        dcon d;
+        for (int i = 0; i < 5; ++i)
+                d.push_back(i);
+        d.push_front(-1);
+        auto it = d.insert(d.find(3), 8);
+        assert(8 == *it && 3 == *++it && 2 == *--(--it));
+        d.erase(d.find(8));
+        d.pop_front();
+        d.pop_back();
+        assert(4 == d.size() && 0 == d.front() && 3 == d.back());
+        dcon e;
+        e.push_back(7);
+        e.push_back(6);
+        e.push_back(5);
+        d.splice(d.find(2), e, e.find(6));
+        d.splice(d.begin(), e);
+        assert(e.empty() && 7 == d.size());
+        d.splice(d.end(), d, d.begin(), d.find(0));
+        std::cout << "Execpted output: 0 1 6 2 3 7 5\nActual output:   ";
+        d.print();
+        d.sort();
+        e.push_back(4);
+        e.push_back(8);
+        d.merge(e);
+        std::cout << "Execpted output: 0 1 2 3 4 5 6 7 8\nActual output:   ";
+        d.print();
+        int k = 8;
+        for (auto r = --d.end(); r != d.begin(); --r)
+                assert(k-- == *r);
+        dcon dc;
+        dc = d;
+        d.clear();
+        assert(d.empty() && d.begin() == d.end() && 9 == dc.size());
+        d.swap(dc);
+        assert(9 == d.size() && dc.empty() && 8 == d.back());
+
+        /* a stable sort of many elements, checked against std */
+        std::vector<keyed> v;
+        doubly_linked_container<keyed> big;
+        for (int i = 0; i < 100000; ++i) {
+                keyed x = { static_cast<int>((i * 7919u) % 1000), i };
+                v.push_back(x);
+                big.push_back(x);
+        }
+        std::stable_sort(v.begin(), v.end(), key_less);
+        big.sort(key_less);
+        auto b = big.begin();
+        for (const keyed &x : v) {
+                assert(b->key == x.key && b->seq == x.seq);
+                ++b;
+        }
+        assert(b == big.end() && 100000 == big.size());
+
+        /* the head and tail nodes hold no element */
+        singly_linked_container<counted> sn;
+        doubly_linked_container<counted> dn;
+        assert(0 == counted::made);
+        sn.emplace_back(2);
+        sn.emplace_front(1);
+        dn.emplace_back(4);
+        dn.emplace_front(3);
+        dn.sort();
+        assert(4 == counted::made);
+        assert(1 == sn.front().v && 2 == sn.back().v);
+        assert(3 == dn.front().v && 4 == dn.back().v);
+
+        /* a pmr list keeps its own resource through assignments */
+        typedef std::pmr::polymorphic_allocator<int> palloc;
+        char abuf[2048], bbuf[2048];
+        std::pmr::monotonic_buffer_resource ra(abuf, sizeof(abuf),
+                        std::pmr::null_memory_resource());
+        std::pmr::monotonic_buffer_resource rb(bbuf, sizeof(bbuf),
+                        std::pmr::null_memory_resource());
+        auto in = [](const int &x, const char *buf) {
+                const char *p = reinterpret_cast<const char *>(&x);
+                return p >= buf && p < buf + 2048;
+        };
+        doubly_linked_container<int, palloc> pa{palloc(&ra)};
+        doubly_linked_container<int, palloc> pb{palloc(&rb)};
+        doubly_linked_container<int, palloc> pc{palloc(&ra)};
+        singly_linked_container<int, palloc> sa{palloc(&ra)};
+        singly_linked_container<int, palloc> sb{palloc(&rb)};
+        for (int i = 0; i < 3; ++i) {
+                pb.push_back(i);
+                pc.push_back(10 + i);
+                sb.push_back(i);
+        }
+        pa = pb;
+        sa = sb;
+        assert(&ra == pa.get_allocator().resource() && 3 == pa.size());
+        assert(&ra == sa.get_allocator().resource() && 2 == sa.back());
+        for (int &x : pa)
+                assert(in(x, abuf));
+        pa = std::move(pb);     /* unequal, the elements are moved */
+        sa = std::move(sb);
+        assert(&ra == pa.get_allocator().resource() && pb.empty());
+        assert(in(pa.front(), abuf) && in(sa.front(), abuf) && sb.empty());
+        int *first = &pc.front();
+        pa = std::move(pc);     /* equal, the nodes are taken */
+        assert(first == &pa.front() && pc.empty() && 3 == pa.size());
+        pa.swap(pc);
+        assert(pa.empty() && first == &pc.front() && 12 == pc.back());
+        pc.swap(pc);
+        assert(3 == pc.size() && 12 == pc.back());
+        std::cout << "End testing." << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * tracked - an element that counts how often it is
+ * copied and moved
+ *-------------------------------------------------------
+ */
+struct tracked {
+        static int copies;
+        static int moves;
+        std::string s;
+
+        tracked() {}
+        tracked(const char *s, int n) : s(std::string(n, *s)) {}
+        tracked(const tracked &t) : s(t.s) { ++copies; }
+        tracked(tracked &&t) : s(std::move(t.s)) { ++moves; }
+        tracked &operator=(const tracked &t)
+        {
+                s = t.s;
+                ++copies;
+                return *this;
+        }
+        tracked &operator=(tracked &&t)
+        {
+                s = std::move(t.s);
+                ++moves;
+                return *this;
+        }
+};
+
+int tracked::copies = 0;
+int tracked::moves = 0;
+
+
+void test_move()
+{
+        std::cout << "Start testing moving and emplacing elements:"
+                << std::endl;
+        singly_linked_list<tracked> shead;
+        tracked t("a", 40);
+        shead.append(t);
+        assert(1 == tracked::copies && 0 == tracked::moves);
+        shead.append(std::move(t));
+        assert(1 == tracked::copies && 1 == tracked::moves);
+        shead.emplace_after("b", 40);
+        assert(1 == tracked::copies && 1 == tracked::moves);
+        assert(std::string(40, 'b') == shead.next->elem.s);
+        shead.clear();
+
+        doubly_linked_list<tracked> dhead;
+        dhead.emplace_after("c", 3)->emplace("d", 2);
+        dhead.next->append(tracked("e", 1));
+        assert(1 == tracked::copies && 2 == tracked::moves);
+        assert("dd" == dhead.next->elem.s && "e" == dhead.next->next->elem.s);
+        assert("ccc" == dhead.next->next->next->elem.s);
+        dhead.clear();
+
+        doubly_linked_container<tracked> dc;
+        dc.emplace_back("x", 2);
+        dc.push_front(tracked("y", 2));
+        assert("yy" == dc.emplace(dc.end(), "y", 2)->s);
+        assert(1 == tracked::copies && 3 == tracked::moves);
+        singly_linked_container<tracked> sc;
+        assert("zz" == sc.emplace_back("z", 2).s);
+        sc.push_front(tracked("w", 1));
+        assert(1 == tracked::copies && 4 == tracked::moves);
+
+        /* elements that cannot be copied at all */
+        doubly_linked_container<std::unique_ptr<int>> up;
+        for (int i = 3; i > 0; --i)
+                up.push_back(std::make_unique<int>(i));
+        up.emplace_front(new int(9));
+        up.sort([](const std::unique_ptr<int> &a,
+                                const std::unique_ptr<int> &b) {
+                        return *a < *b;
+                });
+        assert(1 == *up.front() && 9 == *up.back());
+        std::cout << "End testing." << std::endl;
+}
+
+
 int main()
 {
         test_sll();
         std::cout << std::endl;
         test_dll();
+        std::cout << std::endl;
+        test_alloc();
+        std::cout << std::endl;
+        test_intrusive();
+        std::cout << std::endl;
+        test_containers();
+        std::cout << std::endl;
+        test_move();
 
         return 0;
 }
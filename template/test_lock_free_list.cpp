@@ -0,0 +1,126 @@
+/*=======================================================
+ * test_lock_free_list.cpp - test the class lock_free_list
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 05:31:09
+ *=======================================================
+ */
+
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include <assert.h>
+#include "lock_free_list.hpp"
+
+
+/*-------------------------------------------------------
+ * counted - an element that counts the live copies of
+ * itself
+ *-------------------------------------------------------
+ */
+struct counted {
+        static std::atomic<long> live;
+        int v;
+
+        counted(int v) : v(v) { ++live; }
+        counted(const counted &c) : v(c.v) { ++live; }
+        ~counted() { --live; }
+        bool operator<(const counted &c) const { return v < c.v; }
+};
+
+std::atomic<long> counted::live{0};
+
+std::ostream &operator<<(std::ostream &os, const counted &c)
+{
+        return os << c.v;
+}
+
+
+void test_basic()
+{
+        std::cout << "Start testing class lock_free_list<int>:" << std::endl;
+        lock_free_list<int> l;
+        assert(l.empty() && !l.contains(1) && !l.remove(1));
+        int a[] = { 5, 1, 4, 2, 3, 0 };
+        for (int x : a)
+                assert(l.insert(x));
+        assert(!l.insert(4) && 6 == l.size());
+        std::cout << "Execpted output: 0 1 2 3 4 5\nActual output:   ";
+        l.print();
+        assert(l.remove(0) && l.remove(3) && l.remove(5) && !l.remove(3));
+        assert(l.contains(1) && !l.contains(3));
+        std::cout << "Execpted output: 1 2 4\nActual output:   ";
+        l.print();
+
+        lock_free_list<int, std::greater<int>> g;
+        for (int x : a)
+                g.insert(x);
+        std::cout << "Execpted output: 5 4 3 2 1 0\nActual output:   ";
+        g.print();
+        std::cout << "End testing." << std::endl;
+}
+
+
+void test_threads()
+{
+        std::cout << "Start testing class lock_free_list<counted> with "
+                "threads:" << std::endl;
+        const int nthreads = 4, keys = 512, rounds = 50000;
+        std::vector<std::set<int>> owned(nthreads);
+        {
+                lock_free_list<counted> l;
+                std::atomic<bool> stop{false};
+                std::atomic<long> hits{0};
+
+                /* the writers own the keys equal to their number mod 4 */
+                std::vector<std::thread> threads;
+                for (int t = 0; t < nthreads; ++t) {
+                        threads.emplace_back([&l, &owned, t] {
+                                std::mt19937 rng(t);
+                                std::set<int> &mine = owned[t];
+                                for (int i = 0; i < rounds; ++i) {
+                                        int k = rng() % (keys / nthreads) *
+                                                nthreads + t;
+                                        if (rng() % 2)
+                                                assert(l.insert(k) ==
+                                                        mine.insert(k).second);
+                                        else
+                                                assert(l.remove(k) ==
+                                                        (mine.erase(k) == 1));
+                                }
+                        });
+                }
+                std::thread reader([&l, &stop, &hits] {
+                        std::mt19937 rng(99);
+                        while (!stop.load())
+                                hits += l.contains(rng() % keys);
+                });
+                for (auto &th : threads)
+                        th.join();
+                stop = true;
+                reader.join();
+
+                std::set<int> all;
+                for (auto &s : owned)
+                        all.insert(s.begin(), s.end());
+                assert(all.size() == l.size());
+                for (int k = 0; k < keys; ++k)
+                        assert(l.contains(k) == (all.count(k) == 1));
+        }
+        /* every node, the retired ones included, went back */
+        assert(0 == counted::live);
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_basic();
+        std::cout << std::endl;
+        test_threads();
+
+        return 0;
+}
@@ -0,0 +1,132 @@
+/*=======================================================
+ * test_lock_free_queue.cpp - test the class
+ * lock_free_queue and lock_free_stack
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:02:44
+ *=======================================================
+ */
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <assert.h>
+#include "lock_free_queue.hpp"
+#include "lock_free_stack.hpp"
+
+static const int producers = 3, consumers = 3, items = 40000;
+
+
+void test_basic()
+{
+        std::cout << "Start testing class lock_free_queue<std::string> and "
+                "lock_free_stack<std::string>:" << std::endl;
+        lock_free_queue<std::string> q;
+        lock_free_stack<std::string> s;
+        std::string x;
+        assert(q.empty() && !q.pop(x) && s.empty() && !s.pop(x));
+        for (int i = 0; i < 5; ++i) {
+                std::string e = std::to_string(i) + std::string(30, '.');
+                q.push(e);
+                s.push(std::move(e));
+        }
+        assert(!q.empty() && !s.empty());
+        for (int i = 0; i < 5; ++i) {
+                assert(q.pop(x) && x == std::to_string(i) +
+                                std::string(30, '.'));
+                assert(s.pop(x) && x == std::to_string(4 - i) +
+                                std::string(30, '.'));
+        }
+        assert(q.empty() && !q.pop(x) && s.empty() && !s.pop(x));
+
+        /* the elements left go with the containers */
+        q.push("left");
+        s.push("left");
+        std::cout << "End testing." << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * exchange - let producers push numbered items and
+ * consumers pop them all, return what every consumer got
+ * in order
+ *-------------------------------------------------------
+ */
+template <typename C>
+static std::vector<std::vector<long>> exchange(C &c)
+{
+        std::vector<std::vector<long>> got(consumers);
+        std::atomic<int> left{producers * items};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&c, p] {
+                        for (long i = 0; i < items; ++i)
+                                c.push(p * items + i);
+                });
+        }
+        for (int k = 0; k < consumers; ++k) {
+                threads.emplace_back([&c, &got, &left, k] {
+                        long x;
+                        while (left.load() > 0)
+                                if (c.pop(x)) {
+                                        got[k].push_back(x);
+                                        --left;
+                                }
+                });
+        }
+        for (auto &th : threads)
+                th.join();
+        return got;
+}
+
+
+void test_threads()
+{
+        std::cout << "Start testing the queue and the stack with threads:"
+                << std::endl;
+        long x;
+        {
+                lock_free_queue<long> q;
+                std::vector<std::vector<long>> got = exchange(q);
+                std::vector<char> seen(producers * items, 0);
+                for (auto &v : got) {
+                        /* the items of one producer come in order */
+                        std::vector<long> last(producers, -1);
+                        for (long e : v) {
+                                assert(!seen[e]);
+                                seen[e] = 1;
+                                assert(e > last[e / items]);
+                                last[e / items] = e;
+                        }
+                }
+                for (char c : seen)
+                        assert(c);
+                assert(!q.pop(x));
+        }
+        {
+                lock_free_stack<long> s;
+                std::vector<std::vector<long>> got = exchange(s);
+                std::vector<char> seen(producers * items, 0);
+                for (auto &v : got)
+                        for (long e : v) {
+                                assert(!seen[e]);
+                                seen[e] = 1;
+                        }
+                for (char c : seen)
+                        assert(c);
+                assert(!s.pop(x));
+        }
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_basic();
+        std::cout << std::endl;
+        test_threads();
+
+        return 0;
+}
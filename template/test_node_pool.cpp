@@ -0,0 +1,143 @@
+/*=======================================================
+ * test_node_pool.cpp - test the class node_pool and the
+ * lists built on it
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 11:14:07
+ *=======================================================
+ */
+
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+#include <assert.h>
+#include "list.hpp"
+#include "node_pool.hpp"
+
+typedef singly_linked_list<int> sll;
+typedef doubly_linked_list<int> dll;
+
+
+void test_pool()
+{
+        std::cout << "Start testing class node_pool<long>:" << std::endl;
+        node_pool<long> pool(100);
+        assert(0 == pool.slab_count());
+        std::vector<long *> v;
+        std::set<long *> seen;
+        for (long i = 0; i < 1000; ++i) {
+                long *p = pool.create(i);
+                assert(p && seen.insert(p).second);
+                v.push_back(p);
+        }
+        assert(10 == pool.slab_count());
+        for (long i = 0; i < 1000; ++i)
+                assert(*v[i] == i);
+
+        /* the freed nodes are used again before any new slab */
+        for (long *p : v)
+                pool.destroy(p);
+        for (long i = 0; i < 1000; ++i)
+                assert(seen.count(pool.create(i)));
+        assert(10 == pool.slab_count());
+
+        pool.reset();
+        assert(0 == pool.slab_count());
+        assert(pool.create(1) && 1 == pool.slab_count());
+
+        /* nodes freed by another thread than the one made them */
+        node_pool<long> shared;
+        std::vector<std::vector<long *>> made(4);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&shared, &made, t] {
+                        for (long i = 0; i < 10000; ++i)
+                                made[t].push_back(shared.create(t));
+                });
+        }
+        for (auto &th : threads)
+                th.join();
+        threads.clear();
+        seen.clear();
+        for (int t = 0; t < 4; ++t) {
+                for (long *p : made[t]) {
+                        assert(*p == t && seen.insert(p).second);
+                }
+        }
+        for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&shared, &made, t] {
+                        for (long *p : made[(t + 1) % 4])
+                                shared.destroy(p);
+                });
+        }
+        for (auto &th : threads)
+                th.join();
+
+        /* an exiting thread gives its cached nodes back */
+        node_pool<long> one(64);
+        std::thread([&one] {
+                one.destroy(one.create(1));
+        }).join();
+        for (long i = 0; i < 64; ++i)
+                assert(one.create(i));
+        assert(1 == one.slab_count());
+
+        /* the caches of the destroyed pools are dropped */
+        for (int i = 0; i < 1000; ++i) {
+                node_pool<long> p(64);
+                p.destroy(p.create(i));
+        }
+        assert(node_pool<long>::thread_cache_count() <= 4);
+        std::cout << "End testing." << std::endl;
+}
+
+
+void test_lists()
+{
+        std::cout << "Start testing the lists on node_pool:" << std::endl;
+        node_pool<sll> spool;
+        sll shead(&spool);
+        sll *p = &shead;
+        for (int i = 0; i < 5; ++i)
+                p = p->append(i);
+        p = shead.append(new sll(9));   /* owned by new and delete */
+        std::cout << "Execpted output: 9 0 1 2 3 4\nActual output:   ";
+        shead.print();
+        assert(&spool == shead.find(3)->pool);
+        assert(NULL == p->pool);
+        shead.remove(&shead, 9);
+        shead.remove(&shead, 2);
+        std::cout << "Execpted output: 0 1 3 4\nActual output:   ";
+        shead.print();
+        shead.clear();
+        assert(1 == shead.is_tail());
+
+        node_pool<dll> dpool;
+        dll dhead(&dpool);
+        dll *q = &dhead;
+        for (int i = 0; i < 100000; ++i)
+                q = q->append(i);
+        assert(99999 == q->elem && 0 == dhead.find(0)->elem);
+        q = dhead.find(500)->remove();
+        assert(501 == q->elem && 499 == q->prev->elem);
+
+        /* the whole list goes at once, the head forgets it */
+        dpool.reset();
+        dhead.next = NULL;
+        assert(0 == dpool.slab_count());
+        q = dhead.append(7);
+        assert(q && 7 == dhead.next->elem && 1 == dpool.slab_count());
+        dhead.clear();
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_pool();
+        std::cout << std::endl;
+        test_lists();
+
+        return 0;
+}
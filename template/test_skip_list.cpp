@@ -0,0 +1,140 @@
+/*=======================================================
+ * test_skip_list.cpp - test the class skip_list
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 06:35:17
+ *=======================================================
+ */
+
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <assert.h>
+#include "skip_list.hpp"
+
+
+/*-------------------------------------------------------
+ * same - check a list against the model @ref, both ways
+ *-------------------------------------------------------
+ */
+template <typename L, typename R>
+static bool same(L &list, R &ref)
+{
+        if (list.size() != ref.size())
+                return false;
+        auto it = list.begin();
+        for (const auto &x : ref) {
+                if (it->first != x.first || it->second != x.second)
+                        return false;
+                ++it;
+        }
+        if (it != list.end())
+                return false;
+        auto rit = list.rbegin();
+        for (auto r = ref.rbegin(); r != ref.rend(); ++r, ++rit)
+                if (rit->first != r->first)
+                        return false;
+        return rit == list.rend();
+}
+
+
+void test_basic()
+{
+        std::cout << "Start testing class skip_list<int, std::string>:"
+                << std::endl;
+        skip_list<int, std::string> s;
+        assert(s.empty() && s.begin() == s.end() && s.find(1) == s.end());
+        int a[] = { 5, 1, 4, 2, 3, 0 };
+        for (int x : a)
+                assert(s.insert(x, std::string(x + 1, 'a')).second);
+        assert(!s.insert(4, "dup").second && "aaaaa" == s.find(4)->second);
+        assert(6 == s.size() && s.contains(0) && !s.contains(6));
+        std::cout << "Execpted output: 0:a 1:aa 2:aaa 3:aaaa 4:aaaaa "
+                "5:aaaaaa\nActual output:   ";
+        s.print();
+
+        /* the range [1, 3] forward and backward */
+        int k = 1;
+        for (auto it = s.lower_bound(1); it != s.upper_bound(3); ++it)
+                assert(k++ == it->first);
+        assert(4 == k);
+        auto first = std::make_reverse_iterator(s.upper_bound(3));
+        auto last = std::make_reverse_iterator(s.lower_bound(1));
+        for (auto it = first; it != last; ++it)
+                assert(--k == it->first);
+        assert(1 == k);
+
+        assert(1 == s.erase(0) && 0 == s.erase(0));
+        auto it = s.erase(s.find(3));
+        assert(4 == it->first && 2 == (--it)->first);
+        s[7] = "new";
+        s[1] = "one";
+        std::cout << "Execpted output: 1:one 2:aaa 4:aaaaa 5:aaaaaa 7:new\n"
+                "Actual output:   ";
+        s.print();
+
+        skip_list<int, std::string> c(s);
+        s.clear();
+        assert(s.empty() && s.begin() == s.end());
+        assert(5 == c.size() && "new" == c.find(7)->second);
+        s = std::move(c);
+        assert(5 == s.size() && c.empty() && 7 == s.rbegin()->first);
+        std::cout << "End testing." << std::endl;
+}
+
+
+void test_random()
+{
+        std::cout << "Start testing class skip_list<int, int> against "
+                "std::map:" << std::endl;
+        double ps[] = { 0.5, 0.25, 1.0 / 16 };
+        for (double p : ps) {
+                std::mt19937 rng(7);
+                skip_list<int, int> s(p);
+                std::map<int, int> ref;
+                for (int round = 0; round < 20000; ++round) {
+                        int k = rng() % 2000;
+                        switch (rng() % 4) {
+                        case 0:
+                                assert(s.erase(k) == ref.erase(k));
+                                break;
+                        case 1: {
+                                auto it = s.lower_bound(k);
+                                auto rit = ref.lower_bound(k);
+                                assert((it == s.end()) == (rit == ref.end()));
+                                if (rit != ref.end()) {
+                                        assert(it->first == rit->first);
+                                        s.erase(it);
+                                        ref.erase(rit);
+                                }
+                                break;
+                        }
+                        default:
+                                assert(s.insert(k, round).second ==
+                                        ref.insert({k, round}).second);
+                        }
+                        if (round % 1000 == 0)
+                                assert(same(s, ref));
+                }
+                assert(same(s, ref));
+                for (int k = 0; k < 2000; ++k) {
+                        auto u = s.upper_bound(k);
+                        auto ru = ref.upper_bound(k);
+                        assert((u == s.end()) == (ru == ref.end()));
+                        assert(u == s.end() || u->first == ru->first);
+                }
+        }
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_basic();
+        std::cout << std::endl;
+        test_random();
+
+        return 0;
+}
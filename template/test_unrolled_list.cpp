@@ -0,0 +1,112 @@
+/*=======================================================
+ * test_unrolled_list.cpp - test the class unrolled_list
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 04:40:12
+ *=======================================================
+ */
+
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <assert.h>
+#include "unrolled_list.hpp"
+
+
+/*-------------------------------------------------------
+ * same - check a list against the model @ref
+ *-------------------------------------------------------
+ */
+template <typename L, typename R>
+static bool same(L &list, R &ref)
+{
+        if (list.size() != ref.size())
+                return false;
+        auto it = list.begin();
+        for (const auto &x : ref)
+                if (!(*it++ == x))
+                        return false;
+        return it == list.end();
+}
+
+
+void test_basic()
+{
+        std::cout << "Start testing class unrolled_list<int, 4>:"
+                << std::endl;
+        unrolled_list<int, 4> l;
+        assert(l.empty() && l.begin() == l.end());
+        for (int i = 1; i <= 6; ++i)
+                l.push_back(i);
+        assert(6 == l.size() && 2 == l.node_count());
+        l.push_front(0);
+        auto it = l.insert(l.find(5), 9);
+        assert(9 == *it && 5 == *++it);
+        std::cout << "Execpted output: 0 1 2 3 4 9 5 6\nActual output:   ";
+        l.print();
+        assert(0 == l.front() && 6 == l.back());
+
+        it = l.erase(l.find(9));
+        assert(5 == *it);
+        it = l.erase(l.find(6));
+        assert(it == l.end());
+        assert(5 == *--it);
+        std::cout << "Execpted output: 0 1 2 3 4 5\nActual output:   ";
+        l.print();
+
+        unrolled_list<int, 4> c(l);
+        l.clear();
+        assert(l.empty() && 0 == l.node_count());
+        assert(6 == c.size() && 5 == *c.find(5));
+        l = std::move(c);
+        assert(6 == l.size() && c.empty());
+        std::cout << "End testing." << std::endl;
+}
+
+
+void test_random()
+{
+        std::cout << "Start testing class unrolled_list<std::string, 8>:"
+                << std::endl;
+        std::mt19937 rng(42);
+        unrolled_list<std::string, 8> l;
+        std::list<std::string> ref;
+        for (int round = 0; round < 20000; ++round) {
+                std::size_t pos = ref.empty() ? 0 : rng() % (ref.size() + 1);
+                auto it = l.begin();
+                auto rit = ref.begin();
+                for (std::size_t k = 0; k < pos; ++k, ++it, ++rit)
+                        ;
+                /* grow for a while, then shrink to nothing */
+                bool grow = round < 12000 ? rng() % 3 != 0 : rng() % 4 == 0;
+                if (grow || rit == ref.end()) {
+                        std::string s = std::to_string(round) +
+                                std::string(20, 'x');
+                        it = l.insert(it, s);
+                        rit = ref.insert(rit, s);
+                } else {
+                        it = l.erase(it);
+                        rit = ref.erase(rit);
+                }
+                assert((it == l.end()) == (rit == ref.end()));
+                assert(it == l.end() || *it == *rit);
+                if (round % 500 == 0)
+                        assert(same(l, ref));
+        }
+        assert(same(l, ref));
+
+        /* every node but the last is at least a quarter full */
+        assert(l.node_count() <= l.size() / 2 + 1);
+        std::cout << "End testing." << std::endl;
+}
+
+
+int main()
+{
+        test_basic();
+        std::cout << std::endl;
+        test_random();
+
+        return 0;
+}
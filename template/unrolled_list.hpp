@@ -0,0 +1,513 @@
+/*=======================================================
+ * unrolled_list.hpp - a doubly linked list holding up to
+ * N elements in every node
+ *
+ * Created on 2026/10/20
+ * Last Modified: 2026/10/20 04:40:12
+ *=======================================================
+ */
+
+#ifndef UNROLLED_LIST_HPP
+#define UNROLLED_LIST_HPP
+
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <utility>
+
+/*
+ * The elements of a node lie side by side, so walking the list reads them
+ * like an array and follows one pointer per node instead of one per
+ * element. A full node is split in halves to make room for an insertion.
+ * A node left less than a quarter full by a removal takes in its successor
+ * when both fit in three quarters of a node, or else takes some elements
+ * of it, so every node but the last stays at least a quarter full. Both
+ * move at most N elements, which is O(1) at a known position for a fixed N.
+ * By default a node holds 256 bytes of elements.
+ *
+ * Inserting or removing moves the elements after the position within its
+ * node, so it invalidates the iterators into that node and, when nodes
+ * split or merge, into the next one.
+ */
+template <typename T, std::size_t N = (256 / sizeof(T) > 4 ?
+                256 / sizeof(T) : 4)>
+class unrolled_list {
+        static_assert(N >= 4, "a node should hold at least 4 elements");
+
+        private:
+                struct node {
+                        node *prev;
+                        node *next;
+                        std::size_t count;
+                        alignas(T) unsigned char data[N * sizeof(T)];
+
+                        T *at(std::size_t i)
+                        {
+                                return std::launder(
+                                                reinterpret_cast<T *>(data) +
+                                                i);
+                        }
+                };
+
+                node *head;
+                node *tail;
+                std::size_t len;
+                std::size_t nodes;
+
+        public:
+                class iterator;
+
+                unrolled_list();
+                unrolled_list(const unrolled_list &other);
+                unrolled_list(unrolled_list &&other) noexcept;
+                unrolled_list &operator=(unrolled_list other) noexcept;
+                ~unrolled_list();
+                std::size_t size() const;
+                bool empty() const;
+                std::size_t node_count() const;
+                T &front();
+                T &back();
+                iterator begin();
+                iterator end();
+                iterator find(const T &elem);
+                void push_back(const T &elem);
+                void push_front(const T &elem);
+                iterator insert(iterator pos, const T &elem);
+                iterator erase(iterator pos);
+                void clear();
+                void swap(unrolled_list &other) noexcept;
+                void print();
+
+        private:
+                node *new_node(node *prev, node *next);
+                void free_node(node *n);
+                void split(node *n);
+                void merge(node *n);
+                static void move_elems(node *from, std::size_t i,
+                                node *to, std::size_t j, std::size_t k);
+};
+
+
+/*-------------------------------------------------------
+ * iterator - a position in the list, the node and the
+ * index in it
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+class unrolled_list<T, N>::iterator {
+        private:
+                friend class unrolled_list<T, N>;
+                node *n;
+                std::size_t i;
+
+                iterator(node *n, std::size_t i) : n(n), i(i) {}
+
+        public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T *pointer;
+                typedef T &reference;
+
+                iterator() : n(NULL), i(0) {}
+                T &operator*() const { return *n->at(i); }
+                T *operator->() const { return n->at(i); }
+                iterator &operator++()
+                {
+                        if (++i == n->count && n->next) {
+                                n = n->next;
+                                i = 0;
+                        }
+                        return *this;
+                }
+                iterator operator++(int)
+                {
+                        iterator it = *this;
+                        ++*this;
+                        return it;
+                }
+                iterator &operator--()
+                {
+                        if (i == 0) {
+                                n = n->prev;
+                                i = n->count;
+                        }
+                        --i;
+                        return *this;
+                }
+                iterator operator--(int)
+                {
+                        iterator it = *this;
+                        --*this;
+                        return it;
+                }
+                bool operator==(const iterator &it) const
+                {
+                        return n == it.n && i == it.i;
+                }
+                bool operator!=(const iterator &it) const
+                {
+                        return !(*this == it);
+                }
+};
+
+
+template <typename T, std::size_t N>
+unrolled_list<T, N>::unrolled_list()
+        : head(NULL), tail(NULL), len(0), nodes(0)
+{
+}
+
+
+template <typename T, std::size_t N>
+unrolled_list<T, N>::unrolled_list(const unrolled_list &other)
+        : unrolled_list()
+{
+        for (node *p = other.head; p; p = p->next) {
+                node *n = new_node(tail, NULL);
+                for (std::size_t i = 0; i < p->count; ++i) {
+                        new (n->at(i)) T(*p->at(i));
+                        ++n->count;
+                        ++len;
+                }
+        }
+}
+
+
+template <typename T, std::size_t N>
+unrolled_list<T, N>::unrolled_list(unrolled_list &&other) noexcept
+        : unrolled_list()
+{
+        this->swap(other);
+}
+
+
+template <typename T, std::size_t N>
+unrolled_list<T, N> &unrolled_list<T, N>::operator=(
+                unrolled_list other) noexcept
+{
+        this->swap(other);
+        return *this;
+}
+
+
+template <typename T, std::size_t N>
+unrolled_list<T, N>::~unrolled_list()
+{
+        this->clear();
+}
+
+
+template <typename T, std::size_t N>
+std::size_t unrolled_list<T, N>::size() const
+{
+        return len;
+}
+
+
+template <typename T, std::size_t N>
+bool unrolled_list<T, N>::empty() const
+{
+        return len == 0;
+}
+
+
+/*-------------------------------------------------------
+ * node_count - get the number of nodes
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+std::size_t unrolled_list<T, N>::node_count() const
+{
+        return nodes;
+}
+
+
+template <typename T, std::size_t N>
+T &unrolled_list<T, N>::front()
+{
+        return *head->at(0);
+}
+
+
+template <typename T, std::size_t N>
+T &unrolled_list<T, N>::back()
+{
+        return *tail->at(tail->count - 1);
+}
+
+
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::begin()
+{
+        return iterator(head, 0);
+}
+
+
+/*-------------------------------------------------------
+ * end - get the position after the last element, which
+ * is one past the end of the last node
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::end()
+{
+        return iterator(tail, tail ? tail->count : 0);
+}
+
+
+/*-------------------------------------------------------
+ * find - find the first element equal to @elem, return
+ * end() if not found
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::find(
+                const T &elem)
+{
+        for (node *p = head; p; p = p->next) {
+                T *a = p->at(0);
+                for (std::size_t i = 0; i < p->count; ++i)
+                        if (a[i] == elem)
+                                return iterator(p, i);
+        }
+        return this->end();
+}
+
+
+/*-------------------------------------------------------
+ * push_back - append @elem, filling the last node before
+ * starting a new one
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::push_back(const T &elem)
+{
+        if (!tail || tail->count == N)
+                new_node(tail, NULL);
+        new (tail->at(tail->count)) T(elem);
+        ++tail->count;
+        ++len;
+}
+
+
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::push_front(const T &elem)
+{
+        this->insert(this->begin(), elem);
+}
+
+
+/*-------------------------------------------------------
+ * insert - insert @elem before @pos, return the position
+ * of the new element
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::insert(
+                iterator pos, const T &elem)
+{
+        if (pos == this->end()) {
+                this->push_back(elem);
+                return iterator(tail, tail->count - 1);
+        }
+        node *n = pos.n;
+        std::size_t i = pos.i;
+        if (n->count == N) {
+                this->split(n);
+                if (i > n->count) {
+                        i -= n->count;
+                        n = n->next;
+                }
+        }
+        /* construct the copy first, so a throwing T changes nothing */
+        T tmp(elem);
+        if (i < n->count) {
+                new (n->at(n->count)) T(std::move(*n->at(n->count - 1)));
+                for (std::size_t k = n->count - 1; k > i; --k)
+                        *n->at(k) = std::move(*n->at(k - 1));
+                *n->at(i) = std::move(tmp);
+        } else {
+                new (n->at(i)) T(std::move(tmp));
+        }
+        ++n->count;
+        ++len;
+        return iterator(n, i);
+}
+
+
+/*-------------------------------------------------------
+ * erase - remove the element at @pos, return the
+ * position of the element after it
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::erase(
+                iterator pos)
+{
+        node *n = pos.n;
+        std::size_t i = pos.i;
+        for (std::size_t k = i; k + 1 < n->count; ++k)
+                *n->at(k) = std::move(*n->at(k + 1));
+        n->at(--n->count)->~T();
+        --len;
+        if (n->count == 0) {
+                node *next = n->next;
+                this->free_node(n);
+                return next ? iterator(next, 0) : this->end();
+        }
+        if (n->count < N / 4)
+                this->merge(n);
+        if (i == n->count && n->next)
+                return iterator(n->next, 0);
+        return iterator(n, i);
+}
+
+
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::clear()
+{
+        while (head) {
+                for (std::size_t i = 0; i < head->count; ++i)
+                        head->at(i)->~T();
+                head->count = 0;
+                this->free_node(head);
+        }
+        len = 0;
+}
+
+
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::swap(unrolled_list &other) noexcept
+{
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(len, other.len);
+        std::swap(nodes, other.nodes);
+}
+
+
+/*-------------------------------------------------------
+ * print - print all elements
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::print()
+{
+        for (node *p = head; p; p = p->next)
+                for (std::size_t i = 0; i < p->count; ++i)
+                        std::cout << *p->at(i) << " ";
+        std::cout << std::endl;
+}
+
+
+/*-------------------------------------------------------
+ * new_node - link an empty node between @prev and @next
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+typename unrolled_list<T, N>::node *unrolled_list<T, N>::new_node(
+                node *prev, node *next)
+{
+        node *n = new node;
+        n->prev = prev;
+        n->next = next;
+        n->count = 0;
+        if (prev)
+                prev->next = n;
+        else
+                head = n;
+        if (next)
+                next->prev = n;
+        else
+                tail = n;
+        ++nodes;
+        return n;
+}
+
+
+/*-------------------------------------------------------
+ * free_node - unlink and free an empty node
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::free_node(node *n)
+{
+        if (n->prev)
+                n->prev->next = n->next;
+        else
+                head = n->next;
+        if (n->next)
+                n->next->prev = n->prev;
+        else
+                tail = n->prev;
+        --nodes;
+        delete n;
+}
+
+
+/*-------------------------------------------------------
+ * split - move the upper half of the full node @n to a
+ * new node after it
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::split(node *n)
+{
+        node *m = this->new_node(n, n->next);
+        std::size_t half = n->count / 2;
+        move_elems(n, half, m, 0, n->count - half);
+        m->count = n->count - half;
+        n->count = half;
+}
+
+
+/*-------------------------------------------------------
+ * merge - move the elements of the successor of @n into
+ * @n if they fit in three quarters of a node, or else
+ * even out the two nodes
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::merge(node *n)
+{
+        node *m = n->next;
+        if (!m)
+                return;
+        if (n->count + m->count <= N * 3 / 4) {
+                move_elems(m, 0, n, n->count, m->count);
+                n->count += m->count;
+                m->count = 0;
+                this->free_node(m);
+                return;
+        }
+        std::size_t k = (m->count - n->count) / 2;
+        move_elems(m, 0, n, n->count, k);
+        n->count += k;
+        for (std::size_t x = 0; x + k < m->count; ++x) {
+                new (m->at(x)) T(std::move(*m->at(x + k)));
+                m->at(x + k)->~T();
+        }
+        m->count -= k;
+}
+
+
+/*-------------------------------------------------------
+ * move_elems - move @k elements from index @i of @from
+ * to the raw storage at index @j of @to
+ *-------------------------------------------------------
+ */
+template <typename T, std::size_t N>
+void unrolled_list<T, N>::move_elems(node *from, std::size_t i, node *to,
+                std::size_t j, std::size_t k)
+{
+        for (std::size_t x = 0; x < k; ++x) {
+                new (to->at(j + x)) T(std::move(*from->at(i + x)));
+                from->at(i + x)->~T();
+        }
+}
+
+
+#endif /* UNROLLED_LIST_HPP */